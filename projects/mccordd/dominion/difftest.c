@@ -0,0 +1,381 @@
+/* 	Differential Engine Tester
+
+	Links every copy of the engine in the repository into one binary (each
+	under its own symbol prefix, see the difftest rule in the Makefile) and
+	drives identical seeds and action streams through all of them in lock
+	step.  After every action each variant's state is compared field by
+	field against the baseline (../../../dominion) and the first field that
+	differs is reported.
+
+	Seeds are split across forked workers, one per core by default.  A
+	variant that crashes or hangs on a seed is charged for it and the worker
+	is restarted on the next seed.
+
+	Usage:	difftest [-j workers] [-steps n] firstSeed numSeeds
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include "dominion.h"
+
+#define DIFF_TIMEOUT_MS 100	//time a seed may take before it is a hang
+
+#define DECLARE_ENGINE(p)						\
+  int p##initializeGame(int, int*, int, struct gameState*);		\
+  int p##playCard(int, int, int, int, struct gameState*);		\
+  int p##buyCard(int, struct gameState*);				\
+  int p##endTurn(struct gameState*);					\
+  int p##isGameOver(struct gameState*);					\
+  int p##gainCard(int, struct gameState*, int, int);
+
+#define ENGINE(p, name) \
+  { name, p##initializeGame, p##playCard, p##buyCard, p##endTurn, p##isGameOver, p##gainCard }
+
+DECLARE_ENGINE(base_)
+DECLARE_ENGINE(mccordd_)
+DECLARE_ENGINE(konturf_)
+DECLARE_ENGINE(aburasa_)
+
+struct engine {
+  const char *name;
+  int (*initializeGame)(int, int*, int, struct gameState*);
+  int (*playCard)(int, int, int, int, struct gameState*);
+  int (*buyCard)(int, struct gameState*);
+  int (*endTurn)(struct gameState*);
+  int (*isGameOver)(struct gameState*);
+  int (*gainCard)(int, struct gameState*, int, int);
+};
+
+//The first entry is the reference everything else is compared against
+static struct engine engines[] = {
+  ENGINE(base_, "dominion"),
+  ENGINE(mccordd_, "mccordd/dominion"),
+  ENGINE(konturf_, "mccordd/konturfDominion"),
+  ENGINE(aburasa_, "aburasa/dominion")
+};
+#define NUM_ENGINES ((int)(sizeof(engines) / sizeof(engines[0])))
+
+enum field {
+  F_RETURN = 0, F_NUM_PLAYERS, F_SUPPLY, F_EMBARGO, F_OUTPOST_PLAYED,
+  F_OUTPOST_TURN, F_WHOSE_TURN, F_PHASE, F_ACTIONS, F_COINS, F_BUYS,
+  F_HAND_COUNT, F_HAND, F_DECK_COUNT, F_DECK, F_DISCARD_COUNT, F_DISCARD,
+  F_PLAYED_COUNT, F_PLAYED, F_CRASH, F_HANG, NUM_FIELDS
+};
+
+static const char *fieldNames[NUM_FIELDS] = {
+  "return value", "numPlayers", "supplyCount", "embargoTokens", "outpostPlayed",
+  "outpostTurn", "whoseTurn", "phase", "numActions", "coins", "numBuys",
+  "handCount", "hand", "deckCount", "deck", "discardCount", "discard",
+  "playedCardCount", "playedCards", "crash", "hang"
+};
+
+enum action { A_PLAY, A_BUY, A_GAIN, A_END, NUM_ACTIONS };
+static const char *actionNames[NUM_ACTIONS] = { "playCard", "buyCard", "gainCard", "endTurn" };
+
+struct example {
+  long seed;
+  int step;
+  int action;
+  int index;	//player and/or position of the differing entry
+};
+
+//One block per worker in shared memory
+struct workerStats {
+  long seed;		//seed in progress
+  int variant;		//variant in progress (to charge crashes)
+  int step;
+  int action;
+  long seedsDone;
+  long actionsDone;
+  long counts[NUM_ENGINES][NUM_FIELDS];
+  struct example examples[NUM_ENGINES][NUM_FIELDS];
+};
+
+static struct workerStats *stats;
+static int maxSteps = 100;
+
+static unsigned long diffRng;
+
+static unsigned long diffRand(void) {
+  diffRng ^= diffRng << 13;
+  diffRng ^= diffRng >> 7;
+  diffRng ^= diffRng << 17;
+  return diffRng;
+}
+
+#define CMP_SCALAR(f, id)	\
+  if (a->f != b->f) { *index = -1; return id; }
+
+#define CMP_ARRAY(f, n, id) \
+  for (i = 0; i < (n); i++) { if (a->f[i] != b->f[i]) { *index = i; return id; } }
+
+#define CMP_PILE(f, counts, id) \
+  for (p = 0; p < a->numPlayers; p++) { \
+    for (i = 0; i < a->counts[p]; i++) { \
+      if (a->f[p][i] != b->f[p][i]) { *index = p * 1000 + i; return id; } } }
+
+//Returns the first differing field (or -1); only the live part of each
+//pile is compared since the engines leave stale cards past the counts
+static int compareStates(struct gameState *a, struct gameState *b, int *index) {
+  int i, p;
+
+  CMP_SCALAR(numPlayers, F_NUM_PLAYERS);
+  CMP_ARRAY(supplyCount, treasure_map + 1, F_SUPPLY);
+  CMP_ARRAY(embargoTokens, treasure_map + 1, F_EMBARGO);
+  CMP_SCALAR(outpostPlayed, F_OUTPOST_PLAYED);
+  CMP_SCALAR(outpostTurn, F_OUTPOST_TURN);
+  CMP_SCALAR(whoseTurn, F_WHOSE_TURN);
+  CMP_SCALAR(phase, F_PHASE);
+  CMP_SCALAR(numActions, F_ACTIONS);
+  CMP_SCALAR(coins, F_COINS);
+  CMP_SCALAR(numBuys, F_BUYS);
+  CMP_ARRAY(handCount, a->numPlayers, F_HAND_COUNT);
+  CMP_PILE(hand, handCount, F_HAND);
+  CMP_ARRAY(deckCount, a->numPlayers, F_DECK_COUNT);
+  CMP_PILE(deck, deckCount, F_DECK);
+  CMP_ARRAY(discardCount, a->numPlayers, F_DISCARD_COUNT);
+  CMP_PILE(discard, discardCount, F_DISCARD);
+  CMP_SCALAR(playedCardCount, F_PLAYED_COUNT);
+  CMP_ARRAY(playedCards, a->playedCardCount, F_PLAYED);
+  return -1;
+}
+
+static void record(int variant, int field, int index) {
+  struct workerStats *w = stats;
+  if (w->counts[variant][field]++ == 0) {
+    w->examples[variant][field].seed = w->seed;
+    w->examples[variant][field].step = w->step;
+    w->examples[variant][field].action = w->action;
+    w->examples[variant][field].index = index;
+  }
+}
+
+static void randomKingdom(int k[10]) {
+  int pool[treasure_map - adventurer + 1];
+  int n = treasure_map - adventurer + 1;
+  int i, j, t;
+
+  for (i = 0; i < n; i++)
+    pool[i] = adventurer + i;
+  for (i = 0; i < 10; i++) {
+    j = i + diffRand() % (n - i);
+    t = pool[i];
+    pool[i] = pool[j];
+    pool[j] = t;
+    k[i] = pool[i];
+  }
+}
+
+static void runSeed(long seed) {
+  struct gameState states[NUM_ENGINES];
+  int live[NUM_ENGINES];
+  int ret[NUM_ENGINES];
+  int k[10];
+  int numPlayers, v, step, field, index;
+  int action, a0, a1, a2, a3;
+  struct gameState *ref = &states[0];
+
+  diffRng = 0x9E3779B97F4A7C15UL ^ (unsigned long)seed * 2654435761UL;
+  numPlayers = 2 + diffRand() % (MAX_PLAYERS - 1);
+  randomKingdom(k);
+
+  stats->seed = seed;
+  stats->step = 0;
+  stats->action = -1;
+  for (v = 0; v < NUM_ENGINES; v++) {
+    stats->variant = v;
+    memset(&states[v], 0, sizeof(struct gameState));
+    ret[v] = engines[v].initializeGame(numPlayers, k, (int)(seed % 2147483646) + 1, &states[v]);
+    live[v] = 1;
+  }
+
+  for (step = 0; step <= maxSteps; step++) {
+    stats->step = step;
+
+    //Compare against the reference; a variant drops out at its first divergence
+    for (v = 1; v < NUM_ENGINES; v++) {
+      if (!live[v])
+	continue;
+      field = ret[v] != ret[0] ? F_RETURN : compareStates(ref, &states[v], &index);
+      if (field == F_RETURN)
+	index = ret[v];
+      if (field >= 0) {
+	record(v, field, index);
+	live[v] = 0;
+      }
+    }
+    for (v = 1; v < NUM_ENGINES && !live[v]; v++)
+      ;
+    if (v == NUM_ENGINES || step == maxSteps || engines[0].isGameOver(ref))
+      break;
+
+    //Raw action drawn once, mapped onto the (identical) reference state
+    action = diffRand() % NUM_ACTIONS;
+    a0 = (int)(diffRand() % 1000000);
+    a1 = (int)(diffRand() % (treasure_map + 2)) - 1;
+    a2 = (int)(diffRand() % (treasure_map + 2)) - 1;
+    a3 = (int)(diffRand() % (treasure_map + 2)) - 1;
+    if (action == A_PLAY && ref->handCount[ref->whoseTurn] < 1)
+      action = A_END;
+    stats->action = action;
+
+    for (v = 0; v < NUM_ENGINES; v++) {
+      if (v > 0 && !live[v])
+	continue;
+      stats->variant = v;
+      switch (action) {
+      case A_PLAY:
+	ret[v] = engines[v].playCard(a0 % states[v].handCount[states[v].whoseTurn], a1, a2, a3, &states[v]);
+	break;
+      case A_BUY:
+	ret[v] = engines[v].buyCard(a0 % (treasure_map + 1), &states[v]);
+	break;
+      case A_GAIN:
+	ret[v] = engines[v].gainCard(a0 % (treasure_map + 1), &states[v], 2, states[v].whoseTurn);
+	break;
+      default:
+	ret[v] = engines[v].endTurn(&states[v]);
+	break;
+      }
+    }
+    stats->actionsDone++;
+  }
+  stats->seedsDone++;
+}
+
+static void runWorker(long first, long last) {
+  long seed;
+  int devNull;
+  struct itimerval timeout = { { 0, 0 }, { 0, DIFF_TIMEOUT_MS * 1000 } };
+  struct itimerval off = { { 0, 0 }, { 0, 0 } };
+
+  //Some variants print from inside card effects (feast can do so forever)
+  devNull = open("/dev/null", O_WRONLY);
+  if (devNull >= 0)
+    dup2(devNull, STDOUT_FILENO);
+
+  for (seed = first; seed < last; seed++) {
+    setitimer(ITIMER_REAL, &timeout, NULL);
+    runSeed(seed);
+  }
+  setitimer(ITIMER_REAL, &off, NULL);
+  exit(0);
+}
+
+static void printReport(int workers) {
+  long seeds = 0, actions = 0, total;
+  int w, v, f;
+  struct example *ex;
+
+  for (w = 0; w < workers; w++) {
+    seeds += stats[w].seedsDone;
+    actions += stats[w].actionsDone;
+  }
+  printf("%ld seeds, %ld actions compared against %s\n", seeds, actions, engines[0].name);
+
+  for (v = 0; v < NUM_ENGINES; v++) {
+    printf("\n%s%s:\n", engines[v].name, v == 0 ? " (reference)" : "");
+    for (f = 0; f < NUM_FIELDS; f++) {
+      total = 0;
+      ex = NULL;
+      for (w = 0; w < workers; w++) {
+	total += stats[w].counts[v][f];
+	if (ex == NULL && stats[w].counts[v][f] > 0)
+	  ex = &stats[w].examples[v][f];
+      }
+      if (total == 0)
+	continue;
+      printf("  %-16s %8ld  first: seed %ld step %d after %s",
+	     fieldNames[f], total, ex->seed, ex->step,
+	     ex->action >= 0 ? actionNames[ex->action] : "initializeGame");
+      if (ex->index >= 0 && f != F_RETURN)
+	printf(" [%d]", ex->index);
+      printf("\n");
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  int workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  long first, count, per, next;
+  int argi = 1;
+  int i, w, status;
+  pid_t pid, *pids;
+  long *ends;
+
+  while (argi < argc && argv[argi][0] == '-') {
+    if (strcmp(argv[argi], "-j") == 0 && argi + 1 < argc)
+      workers = atoi(argv[++argi]);
+    else if (strcmp(argv[argi], "-steps") == 0 && argi + 1 < argc)
+      maxSteps = atoi(argv[++argi]);
+    argi++;
+  }
+  if (argc - argi != 2) {
+    printf("Usage: difftest [-j workers] [-steps n] firstSeed numSeeds\n");
+    return EXIT_SUCCESS;
+  }
+  first = atol(argv[argi]);
+  count = atol(argv[argi + 1]);
+  if (workers < 1)
+    workers = 1;
+
+  stats = mmap(NULL, sizeof(struct workerStats) * workers, PROT_READ | PROT_WRITE,
+	       MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (stats == MAP_FAILED) {
+    perror("mmap");
+    return EXIT_FAILURE;
+  }
+  pids = calloc(workers, sizeof(pid_t));
+  ends = calloc(workers, sizeof(long));
+
+  per = (count + workers - 1) / workers;
+  for (w = 0; w < workers; w++) {
+    next = first + per * w;
+    ends[w] = next + per < first + count ? next + per : first + count;
+    if (next >= ends[w])
+      continue;
+    stats[w].seed = next;
+    pids[w] = fork();
+    if (pids[w] == 0) {
+      stats = &stats[w];
+      runWorker(next, ends[w]);
+    }
+  }
+
+  while ((pid = wait(&status)) > 0) {
+    for (w = 0; w < workers && pids[w] != pid; w++)
+      ;
+    if (w == workers || WIFEXITED(status))
+      continue;
+
+    //Charge the variant that was running, then carry on after that seed
+    i = WTERMSIG(status) == SIGALRM ? F_HANG : F_CRASH;
+    if (stats[w].counts[stats[w].variant][i]++ == 0) {
+      stats[w].examples[stats[w].variant][i].seed = stats[w].seed;
+      stats[w].examples[stats[w].variant][i].step = stats[w].step;
+      stats[w].examples[stats[w].variant][i].action = stats[w].action;
+      stats[w].examples[stats[w].variant][i].index = -1;
+    }
+    stats[w].seedsDone++;
+    next = stats[w].seed + 1;
+    if (next >= ends[w])
+      continue;
+    pids[w] = fork();
+    if (pids[w] == 0) {
+      stats = &stats[w];
+      runWorker(next, ends[w]);
+    }
+  }
+
+  printReport(workers);
+  free(pids);
+  free(ends);
+  return EXIT_SUCCESS;
+}
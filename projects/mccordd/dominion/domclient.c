@@ -0,0 +1,224 @@
+/* 	Dominion Server Load Generator
+
+	Opens many connections to domserver and plays scripted games on all of
+	them at once: each game is "init 2 1 <seed>" followed by turns of
+	"stat", "buy 4" (copper) and "end", so the bot seat is exercised on
+	every turn.  One request is outstanding per connection; the reply
+	rate and the worst round trip are reported at the end.  The exit
+	status is a failure if any reply was "err", a connection was closed
+	before its games were done, or a write failed, so make loadtest
+	fails with it.
+
+	Usage:	domclient [-p port | -u socketPath] [-c connections] [-g games] [-t turns]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#define CLIENT_BUF 4096
+#define CLIENT_STEPS 3		//stat, buy, end
+
+struct connection {
+  int fd;
+  int game;		//games started so far
+  int turn;		//turns played in the current game
+  int step;		//next command within the turn, -1 for init
+  char in[CLIENT_BUF];
+  int inLen;
+  double sentAt;
+};
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int connectServer(int port, const char *path) {
+  int fd, one = 1;
+
+  if (path != NULL) {
+    struct sockaddr_un addr;
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    if (fd < 0 || connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0)
+      return -1;
+  }
+  else {
+    struct sockaddr_in addr;
+    fd = socket(AF_INET, SOCK_STREAM, 0);
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (fd < 0 || connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0)
+      return -1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  }
+  return fd;
+}
+
+//Send the next command; returns 0 once this connection has played all its games
+static int sendNext(struct connection *c, int games) {
+  char line[64];
+  int n;
+
+  if (c->step < 0) {
+    if (c->game == games)
+      return 0;
+    n = snprintf(line, sizeof(line), "init 2 1 %d\n", c->game + 1);
+  }
+  else if (c->step == 0) {
+    n = snprintf(line, sizeof(line), "stat\n");
+  }
+  else if (c->step == 1) {
+    n = snprintf(line, sizeof(line), "buy 4\n");
+  }
+  else {
+    n = snprintf(line, sizeof(line), "end\n");
+  }
+  c->sentAt = now();
+  if (write(c->fd, line, n) != n)
+    return -1;
+  return 1;
+}
+
+//Work out what follows the reply that just came back
+static void advance(struct connection *c, const char *reply, int turns) {
+  if (c->step < 0) {
+    c->game++;
+    c->turn = 0;
+    c->step = 0;
+  }
+  else if (c->step < CLIENT_STEPS - 1) {
+    c->step++;
+  }
+  else {
+    c->turn++;
+    c->step = 0;
+  }
+  if (strncmp(reply, "over", 4) == 0 || c->turn == turns)
+    c->step = -1;
+}
+
+int main(int argc, char **argv) {
+  const char *path = NULL;
+  int port = 7777, conns = 100, games = 10, turns = 20;
+  struct connection *c;
+  struct pollfd *fds;
+  long replies = 0, errors = 0, dropped = 0;	//dropped: closed early or write failed
+  double start, elapsed, rtt, worst = 0, total = 0;
+  int i, active, n, r;
+  char *nl;
+
+  for (i = 1; i + 1 < argc; i += 2) {
+    if (strcmp(argv[i], "-p") == 0)
+      port = atoi(argv[i + 1]);
+    else if (strcmp(argv[i], "-u") == 0)
+      path = argv[i + 1];
+    else if (strcmp(argv[i], "-c") == 0)
+      conns = atoi(argv[i + 1]);
+    else if (strcmp(argv[i], "-g") == 0)
+      games = atoi(argv[i + 1]);
+    else if (strcmp(argv[i], "-t") == 0)
+      turns = atoi(argv[i + 1]);
+  }
+  if (i != argc || conns < 1) {
+    printf("Usage: domclient [-p port | -u socketPath] [-c connections] [-g games] [-t turns]\n");
+    return EXIT_SUCCESS;
+  }
+
+  c = calloc(conns, sizeof(struct connection));
+  fds = calloc(conns, sizeof(struct pollfd));
+  for (i = 0; i < conns; i++) {
+    c[i].fd = connectServer(port, path);
+    if (c[i].fd < 0) {
+      perror("domclient: connect");
+      return EXIT_FAILURE;
+    }
+    c[i].step = -1;
+    fds[i].fd = c[i].fd;
+    fds[i].events = POLLIN;
+  }
+
+  start = now();
+  active = 0;
+  for (i = 0; i < conns; i++) {
+    r = sendNext(&c[i], games);
+    if (r > 0)
+      active++;
+    else
+      fds[i].fd = -1;
+    if (r < 0) {
+      fprintf(stderr, "domclient: write failed on connection %d\n", i);
+      dropped++;
+    }
+  }
+
+  while (active > 0) {
+    if (poll(fds, conns, -1) < 0) {
+      perror("domclient: poll");
+      dropped += active;
+      break;
+    }
+    for (i = 0; i < conns; i++) {
+      if (fds[i].fd < 0 || !(fds[i].revents & (POLLIN | POLLHUP | POLLERR)))
+	continue;
+      n = read(c[i].fd, c[i].in + c[i].inLen, CLIENT_BUF - c[i].inLen - 1);
+      if (n <= 0) {
+	fprintf(stderr, "domclient: connection %d closed by server\n", i);
+	fds[i].fd = -1;
+	active--;
+	dropped++;
+	continue;
+      }
+      c[i].inLen += n;
+      c[i].in[c[i].inLen] = '\0';
+
+      while ((nl = strchr(c[i].in, '\n')) != NULL) {
+	*nl = '\0';
+	rtt = now() - c[i].sentAt;
+	total += rtt;
+	if (rtt > worst)
+	  worst = rtt;
+	replies++;
+	if (strncmp(c[i].in, "err", 3) == 0)
+	  errors++;
+	advance(&c[i], c[i].in, turns);
+	c[i].inLen -= nl - c[i].in + 1;
+	memmove(c[i].in, nl + 1, c[i].inLen + 1);
+
+	r = sendNext(&c[i], games);
+	if (r <= 0) {
+	  if (r < 0) {
+	    fprintf(stderr, "domclient: write failed on connection %d\n", i);
+	    dropped++;
+	  }
+	  close(c[i].fd);
+	  fds[i].fd = -1;
+	  active--;
+	  break;
+	}
+      }
+    }
+  }
+
+  elapsed = now() - start;
+  printf("%d connections (%ld dropped), %ld replies (%ld err) in %.3fs: %.0f replies/s, mean rtt %.1fus, max rtt %.1fus\n",
+	 conns, dropped, replies, errors, elapsed, replies / elapsed,
+	 replies ? total / replies * 1e6 : 0.0, worst * 1e6);
+  free(c);
+  free(fds);
+  return errors == 0 && dropped == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
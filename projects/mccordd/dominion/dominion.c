@@ -1,9 +1,12 @@
 #include "dominion.h"
 #include "dominion_helpers.h"
 #include "rngs.h"
+#include "profile.h"
+#include "statepool.h"
 #include <stdio.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 int compare(const void* a, const void* b) {
   if (*(int*)a > *(int*)b)
@@ -14,24 +17,15 @@ int compare(const void* a, const void* b) {
 }
 
 struct gameState* newGame() {
-  struct gameState* g = malloc(sizeof(struct gameState));
-  return g;
+  return poolNewGame();
 }
 
 int* kingdomCards(int k1, int k2, int k3, int k4, int k5, int k6, int k7,
 		  int k8, int k9, int k10) {
-  int* k = malloc(10 * sizeof(int));
-  k[0] = k1;
-  k[1] = k2;
-  k[2] = k3;
-  k[3] = k4;
-  k[4] = k5;
-  k[5] = k6;
-  k[6] = k7;
-  k[7] = k8;
-  k[8] = k9;
-  k[9] = k10;
-  return k;
+  int* k = poolKingdomCards();
+  if (k == NULL)
+    return NULL;
+  return setKingdomCards(k, k1, k2, k3, k4, k5, k6, k7, k8, k9, k10);
 }
 
 int initializeGame(int numPlayers, int kingdomCards[10], int randomSeed,
@@ -45,7 +39,7 @@ int initializeGame(int numPlayers, int kingdomCards[10], int randomSeed,
   PutSeed((long)randomSeed);
   
   //check number of players
-  if (numPlayers > MAX_PLAYERS || numPlayers < 2)
+  if (numPlayers > MAX_PLAYERS || numPlayers < MIN_PLAYERS)
     {
       return -1;
     }
@@ -135,7 +129,7 @@ int initializeGame(int numPlayers, int kingdomCards[10], int randomSeed,
   //supply intilization complete
 
   //set player decks
-  for (i = 0; i < numPlayers; i++)
+  for (i = 0; i < NUM_PLAYERS(state); i++)
     {
       state->deckCount[i] = 0;
       for (j = 0; j < 3; j++)
@@ -151,7 +145,7 @@ int initializeGame(int numPlayers, int kingdomCards[10], int randomSeed,
     }
 
   //shuffle player decks
-  for (i = 0; i < numPlayers; i++)
+  for (i = 0; i < NUM_PLAYERS(state); i++)
     {
       if ( shuffle(i, state) < 0 )
 	{
@@ -160,7 +154,7 @@ int initializeGame(int numPlayers, int kingdomCards[10], int randomSeed,
     }
 
   //draw player hands
-  for (i = 0; i < numPlayers; i++)
+  for (i = 0; i < NUM_PLAYERS(state); i++)
     {  
       //initialize hand size to zero
       state->handCount[i] = 0;
@@ -198,19 +192,112 @@ int initializeGame(int numPlayers, int kingdomCards[10], int randomSeed,
   return 0;
 }
 
-int shuffle(int player, struct gameState *state) {
- 
+int initializePrototype(int numPlayers, int kingdomCards[10],
+			struct gamePrototype *prototype) {
+  int i, j;
+  int victory = numPlayers == 2 ? 8 : 12;
 
-  int newDeck[MAX_DECK];
-  int newDeckPos = 0;
-  int card;
+  if (numPlayers > MAX_PLAYERS || numPlayers < MIN_PLAYERS)
+    {
+      return -1;
+    }
+  for (i = 0; i < 10; i++)
+    {
+      for (j = i + 1; j < 10; j++)
+	{
+	  if (kingdomCards[j] == kingdomCards[i])
+	    {
+	      return -1;
+	    }
+	}
+    }
+
+  prototype->numPlayers = numPlayers;
+  for (i = adventurer; i <= treasure_map; i++)
+    {
+      prototype->supplyCount[i] = -1;
+    }
+  for (j = 0; j < 10; j++)
+    {
+      i = kingdomCards[j];
+      if (i >= adventurer && i <= treasure_map)
+	{
+	  prototype->supplyCount[i] = i == great_hall || i == gardens ? victory : 10;
+	}
+    }
+  prototype->supplyCount[curse] = 10 * (numPlayers - 1);
+  prototype->supplyCount[estate] = victory;
+  prototype->supplyCount[duchy] = victory;
+  prototype->supplyCount[province] = victory;
+  prototype->supplyCount[copper] = 60 - (7 * numPlayers);
+  prototype->supplyCount[silver] = 40;
+  prototype->supplyCount[gold] = 30;
+  return 0;
+}
+
+
+//The starting deck, already in the order shuffle() sorts a deck into
+static const int startingDeck[10] = { estate, estate, estate, copper, copper,
+				      copper, copper, copper, copper, copper };
+
+static void shuffleSorted(int player, struct gameState *state);
+
+int initializeFromPrototype(const struct gamePrototype *prototype, int randomSeed,
+			    struct gameState *state) {
   int i;
 
+  SelectStream(1);
+  PutSeed((long)randomSeed);
+
+  state->numPlayers = prototype->numPlayers;
+  memcpy(state->supplyCount, prototype->supplyCount, sizeof(state->supplyCount));
+  memset(state->embargoTokens, 0, sizeof(state->embargoTokens));
+
+  //The same shuffles initializeGame() makes, less the sort each starts with
+  for (i = 0; i < NUM_PLAYERS(prototype); i++)
+    {
+      PROFILE_SHUFFLE();
+      memcpy(state->deck[i], startingDeck, sizeof(startingDeck));
+      state->deckCount[i] = 10;
+      shuffleSorted(i, state);
+      state->handCount[i] = 0;
+      state->discardCount[i] = 0;
+    }
+
+  state->outpostPlayed = 0;
+  state->phase = 0;
+  state->numActions = 1;
+  state->numBuys = 1;
+  state->playedCardCount = 0;
+  state->whoseTurn = 0;
+  for (i = 0; i < 5; i++)
+    {
+      drawCard(0, state);
+    }
+  updateCoins(0, state, 0);
+
+  return 0;
+}
+
+int shuffle(int player, struct gameState *state) {
+
+  PROFILE_SHUFFLE();
+
   if (state->deckCount[player] < 1)
     return -1;
   qsort ((void*)(state->deck[player]), state->deckCount[player], sizeof(int), compare); 
   /* SORT CARDS IN DECK TO ENSURE DETERMINISM! */
 
+  shuffleSorted(player, state);
+  return 0;
+}
+
+static void shuffleSorted(int player, struct gameState *state) {
+  int newDeck[MAX_DECK];
+  int newDeckPos = 0;
+  int card;
+  int i;
+
   while (state->deckCount[player] > 0) {
     card = floor(Random() * state->deckCount[player]);
     newDeck[newDeckPos] = state->deck[player][card];
@@ -224,8 +311,6 @@ int shuffle(int player, struct gameState *state) {
     state->deck[player][i] = newDeck[i];
     state->deckCount[player]++;
   }
-
-  return 0;
 }
 
 int playCard(int handPos, int choice1, int choice2, int choice3, struct gameState *state) 
@@ -255,10 +340,13 @@ int playCard(int handPos, int choice1, int choice2, int choice3, struct gameStat
     }
 	
   //play card
+  PROFILE_CARD_BEGIN(card);
   if ( cardEffect(card, choice1, choice2, choice3, state, handPos, &coin_bonus) < 0 )
     {
+      PROFILE_CARD_END(card);
       return -1;
     }
+  PROFILE_CARD_END(card);
 	
   //reduce number of actions
   state->numActions--;
@@ -359,14 +447,8 @@ int endTurn(struct gameState *state) {
   }
   state->handCount[currentPlayer] = 0;//Reset hand count
     
-    //int k; move to top
-  //Next player draws hand
-  for (k = 0; k < 5; k++){
-    drawCard(state->whoseTurn, state);//Draw a card
-  }
-
   //Code for determining the player
-  if (currentPlayer < (state->numPlayers - 1)){ 
+  if (currentPlayer < (NUM_PLAYERS(state) - 1)){ 
     state->whoseTurn = currentPlayer + 1;//Still safe to increment
   }
   else{
@@ -381,6 +463,11 @@ int endTurn(struct gameState *state) {
   state->playedCardCount = 0;
   state->handCount[state->whoseTurn] = 0;
 
+  //Next player draws hand
+  for (k = 0; k < 5; k++){
+    drawCard(state->whoseTurn, state);//Draw a card
+  }
+
   //Update money
   updateCoins(state->whoseTurn, state , 0);
 
@@ -425,8 +512,8 @@ int scoreFor (int player, struct gameState *state) {
       if (state->hand[player][i] == estate) { score = score + 1; };
       if (state->hand[player][i] == duchy) { score = score + 3; };
       if (state->hand[player][i] == province) { score = score + 6; };
-      if (state->hand[player][i] == great_hall) { score = score + 1; };
-      if (state->hand[player][i] == gardens) { score = score + ( fullDeckCount(player, 0, state) / 10 ); };
+      if (CARD_ENABLED(great_hall) && state->hand[player][i] == great_hall) { score = score + 1; };
+      if (CARD_ENABLED(gardens) && state->hand[player][i] == gardens) { score = score + ( fullDeckCount(player, 0, state) / 10 ); };
     }
 
   //score from discard
@@ -436,8 +523,8 @@ int scoreFor (int player, struct gameState *state) {
       if (state->discard[player][i] == estate) { score = score + 1; };
       if (state->discard[player][i] == duchy) { score = score + 3; };
       if (state->discard[player][i] == province) { score = score + 6; };
-      if (state->discard[player][i] == great_hall) { score = score + 1; };
-      if (state->discard[player][i] == gardens) { score = score + ( fullDeckCount(player, 0, state) / 10 ); };
+      if (CARD_ENABLED(great_hall) && state->discard[player][i] == great_hall) { score = score + 1; };
+      if (CARD_ENABLED(gardens) && state->discard[player][i] == gardens) { score = score + ( fullDeckCount(player, 0, state) / 10 ); };
     }
 
   //score from deck
@@ -447,8 +534,8 @@ int scoreFor (int player, struct gameState *state) {
       if (state->deck[player][i] == estate) { score = score + 1; };
       if (state->deck[player][i] == duchy) { score = score + 3; };
       if (state->deck[player][i] == province) { score = score + 6; };
-      if (state->deck[player][i] == great_hall) { score = score + 1; };
-      if (state->deck[player][i] == gardens) { score = score + ( fullDeckCount(player, 0, state) / 10 ); };
+      if (CARD_ENABLED(great_hall) && state->deck[player][i] == great_hall) { score = score + 1; };
+      if (CARD_ENABLED(gardens) && state->deck[player][i] == gardens) { score = score + ( fullDeckCount(player, 0, state) / 10 ); };
     }
 
   return score;
@@ -464,7 +551,7 @@ int getWinners(int players[MAX_PLAYERS], struct gameState *state) {
   for (i = 0; i < MAX_PLAYERS; i++)
     {
       //set unused player scores to -9999
-      if (i >= state->numPlayers)
+      if (i >= NUM_PLAYERS(state))
 	{
 	  players[i] = -9999;
 	}
@@ -525,6 +612,7 @@ int getWinners(int players[MAX_PLAYERS], struct gameState *state) {
 int drawCard(int player, struct gameState *state)
 {	int count;
   int deckCounter;
+  PROFILE_DRAW();
   if (state->deckCount[player] <= 0){//Deck is empty
     
     //Step 1 Shuffle the discard pile back into a deck
@@ -750,7 +838,7 @@ int councilCard(struct gameState *state, int handPos) {
 	state->numBuys++;
 
 	//All other players draw a card, too:
-	for (i = 0; i < state->numPlayers; i++)
+	for (i = 0; i < NUM_PLAYERS(state); i++)
 	{
 		if ( i == currentPlayer )
 	   	{
@@ -850,7 +938,7 @@ int cardEffect(int card, int choice1, int choice2, int choice3, struct gameState
   //int z = 0;// this is the counter for the temp hand
 //END DKM
 
-  if (nextPlayer > (state->numPlayers - 1)){
+  if (nextPlayer > (NUM_PLAYERS(state) - 1)){
     nextPlayer = 0;
   }
   
@@ -863,16 +951,21 @@ int cardEffect(int card, int choice1, int choice2, int choice3, struct gameState
  *
  *****************************************************************************/
 
+  //A kingdom-specialized build (kingdomgen) drops the cases its kingdom
+  //cannot have; a dropped card breaks out to the -1 below
   switch( card ) 
     {
     case adventurer:
+      if (!CARD_ENABLED(adventurer)) break;
 	return advenCard(state);
       
 			
     case council_room:
+      if (!CARD_ENABLED(council_room)) break;
     	return councilCard(state, handPos); 
 			
     case feast:
+      if (!CARD_ENABLED(feast)) break;
       //gain card with cost up to 5
       //Backup hand
       for (i = 0; i <= state->handCount[currentPlayer]; i++){
@@ -929,15 +1022,19 @@ int cardEffect(int card, int choice1, int choice2, int choice3, struct gameState
       return -1;
 			
     case mine:
+      if (!CARD_ENABLED(mine)) break;
 	return mineCard(choice1, choice2, state, handPos);
 			
     case remodel:
+      if (!CARD_ENABLED(remodel)) break;
 	return remodelCard(choice1, choice2, state, handPos);
 	
     case smithy:
+      if (!CARD_ENABLED(smithy)) break;
 	return smithyCard(state, handPos);
 		
     case village:
+      if (!CARD_ENABLED(village)) break;
       //+1 Card
       drawCard(currentPlayer, state);
 			
@@ -949,6 +1046,7 @@ int cardEffect(int card, int choice1, int choice2, int choice3, struct gameState
       return 0;
 		
     case baron:
+      if (!CARD_ENABLED(baron)) break;
       state->numBuys++;//Increase buys by 1!
       if (choice1 > 0){//Boolean true or going to discard an estate
 	int p = 0;//Iterator for hand!
@@ -1000,6 +1098,7 @@ int cardEffect(int card, int choice1, int choice2, int choice3, struct gameState
       return 0;
 		
     case great_hall:
+      if (!CARD_ENABLED(great_hall)) break;
       //+1 Card
       drawCard(currentPlayer, state);
 			
@@ -1011,6 +1110,7 @@ int cardEffect(int card, int choice1, int choice2, int choice3, struct gameState
       return 0;
 		
     case minion:
+      if (!CARD_ENABLED(minion)) break;
       //+1 action
       state->numActions++;
 			
@@ -1037,7 +1137,7 @@ int cardEffect(int card, int choice1, int choice2, int choice3, struct gameState
 	    }
 				
 	  //other players discard hand and redraw if hand size > 4
-	  for (i = 0; i < state->numPlayers; i++)
+	  for (i = 0; i < NUM_PLAYERS(state); i++)
 	    {
 	      if (i != currentPlayer)
 		{
@@ -1062,6 +1162,7 @@ int cardEffect(int card, int choice1, int choice2, int choice3, struct gameState
       return 0;
 		
     case steward:
+      if (!CARD_ENABLED(steward)) break;
       if (choice1 == 1)
 	{
 	  //+2 cards
@@ -1085,6 +1186,7 @@ int cardEffect(int card, int choice1, int choice2, int choice3, struct gameState
       return 0;
 		
     case tribute:
+      if (!CARD_ENABLED(tribute)) break;
       if ((state->discardCount[nextPlayer] + state->deckCount[nextPlayer]) <= 1){
 	if (state->deckCount[nextPlayer] > 0){
 	  tributeRevealedCards[0] = state->deck[nextPlayer][state->deckCount[nextPlayer]-1];
@@ -1127,7 +1229,7 @@ int cardEffect(int card, int choice1, int choice2, int choice3, struct gameState
 	tributeRevealedCards[1] = -1;
       }
 
-      for (i = 0; i <= 2; i ++){
+      for (i = 0; i < 2; i ++){
 	if (tributeRevealedCards[i] == copper || tributeRevealedCards[i] == silver || tributeRevealedCards[i] == gold){//Treasure cards
 	  state->coins += 2;
 	}
@@ -1144,6 +1246,7 @@ int cardEffect(int card, int choice1, int choice2, int choice3, struct gameState
       return 0;
 		
     case ambassador:
+      if (!CARD_ENABLED(ambassador)) break;
       j = 0;		//used to check if player has enough cards to discard
 
       if (choice2 > 2 || choice2 < 0)
@@ -1175,7 +1278,7 @@ int cardEffect(int card, int choice1, int choice2, int choice3, struct gameState
       state->supplyCount[state->hand[currentPlayer][choice1]] += choice2;
 			
       //each other player gains a copy of revealed card
-      for (i = 0; i < state->numPlayers; i++)
+      for (i = 0; i < NUM_PLAYERS(state); i++)
 	{
 	  if (i != currentPlayer)
 	    {
@@ -1202,9 +1305,10 @@ int cardEffect(int card, int choice1, int choice2, int choice3, struct gameState
       return 0;
 		
     case cutpurse:
+      if (!CARD_ENABLED(cutpurse)) break;
 
       updateCoins(currentPlayer, state, 2);
-      for (i = 0; i < state->numPlayers; i++)
+      for (i = 0; i < NUM_PLAYERS(state); i++)
 	{
 	  if (i != currentPlayer)
 	    {
@@ -1237,6 +1341,7 @@ int cardEffect(int card, int choice1, int choice2, int choice3, struct gameState
 
 		
     case embargo: 
+      if (!CARD_ENABLED(embargo)) break;
       //+2 Coins
       state->coins = state->coins + 2;
 			
@@ -1254,6 +1359,7 @@ int cardEffect(int card, int choice1, int choice2, int choice3, struct gameState
       return 0;
 		
     case outpost:
+      if (!CARD_ENABLED(outpost)) break;
       //set outpost flag
       state->outpostPlayed++;
 			
@@ -1262,6 +1368,7 @@ int cardEffect(int card, int choice1, int choice2, int choice3, struct gameState
       return 0;
 		
     case salvager:
+      if (!CARD_ENABLED(salvager)) break;
       //+1 buy
       state->numBuys++;
 			
@@ -1278,7 +1385,8 @@ int cardEffect(int card, int choice1, int choice2, int choice3, struct gameState
       return 0;
 		
     case sea_hag:
-      for (i = 0; i < state->numPlayers; i++){
+      if (!CARD_ENABLED(sea_hag)) break;
+      for (i = 0; i < NUM_PLAYERS(state); i++){
 	if (i != currentPlayer){
 	  state->discard[i][state->discardCount[i]] = state->deck[i][state->deckCount[i]--];			    state->deckCount[i]--;
 	  state->discardCount[i]++;
@@ -1288,6 +1396,7 @@ int cardEffect(int card, int choice1, int choice2, int choice3, struct gameState
       return 0;
 		
     case treasure_map:
+      if (!CARD_ENABLED(treasure_map)) break;
       //search hand for another treasure_map
       index = -1;
       for (i = 0; i < state->handCount[currentPlayer]; i++)
@@ -6,10 +6,28 @@
 #define MAX_HAND 500
 #define MAX_DECK 500
 
+//-DFIXED_PLAYERS=n builds an engine for n-player games only: the state
+//holds n players and every loop over the players has a constant bound.
+//The simulation tools that only play 2-player games are built this way
+#ifdef FIXED_PLAYERS
+#define MIN_PLAYERS FIXED_PLAYERS
+#define MAX_PLAYERS FIXED_PLAYERS
+#define NUM_PLAYERS(state) FIXED_PLAYERS
+#else
+#define MIN_PLAYERS 2
 #define MAX_PLAYERS 4
+#define NUM_PLAYERS(state) ((state)->numPlayers)
+#endif
 
 #define DEBUG 0
 
+//Whether a card can be in the game at all.  Every card can, except in the
+//kingdom-specialized engines kingdomgen generates (kingdomengine.h),
+//which define it before including dominion.c so dead card code folds away
+#ifndef CARD_ENABLED
+#define CARD_ENABLED(card) 1
+#endif
+
 
 
 /* http://dominion.diehrstraits.com has card texts */
@@ -75,13 +93,24 @@ struct gameState {
   int playedCardCount;
 };
 
+//The part of a new game that depends only on the players and kingdom,
+//built once by initializePrototype() for any number of seeds
+struct gamePrototype {
+  int numPlayers;
+  int supplyCount[treasure_map+1];
+};
+
 /* All functions return -1 on failure, and DO NOT CHANGE GAME STATE;
    unless specified for other return, return 0 on success */
 
 struct gameState* newGame();
+/* Allocated from the calling thread's state pool (statepool.h): release
+   with poolFreeGame() or poolResetAll(), never free() */
 
 int* kingdomCards(int k1, int k2, int k3, int k4, int k5, int k6, int k7,
 		  int k8, int k9, int k10);
+/* Pool allocated like newGame(); setKingdomCards() fills a caller-owned
+   array instead */
 
 int initializeGame(int numPlayers, int kingdomCards[10], int randomSeed,
 		   struct gameState *state);
@@ -91,6 +120,17 @@ int initializeGame(int numPlayers, int kingdomCards[10], int randomSeed,
 
 Cards not in game should initialize supply position to -1 */
 
+int initializePrototype(int numPlayers, int kingdomCards[10],
+			struct gamePrototype *prototype);
+/* Check the arguments and build the supply as initializeGame() does,
+   once for a kingdom; -1 where initializeGame() would refuse them */
+
+int initializeFromPrototype(const struct gamePrototype *prototype, int randomSeed,
+			    struct gameState *state);
+/* initializeGame() for the prototype's players and kingdom: the same
+   state for the same seed, with only the starting decks, their shuffles
+   and the first hand done per game */
+
 int shuffle(int player, struct gameState *state);
 /* Assumes all cards are now in deck array (or hand/played):  discard is
  empty */
@@ -0,0 +1,523 @@
+/* 	Dominion Game Server
+
+	Hosts many games at once on one epoll loop.  Every connection is one
+	game session whose gameState comes from the state pool; bot seats are
+	played by a small pool of worker threads so a long bot turn never
+	holds up the I/O thread.
+
+	Protocol: one command per line, exactly one reply line per command.
+	  init <players> <bots> [seed]	bots take the last seats
+	  play <hand#> <choice1> <choice2> <choice3>
+	  buy <supply#>
+	  end				replies once the bot seats have played
+	  stat | hand | supp | score
+	  quit
+	Replies are "ok ...", "err <reason>" or, for the command that ended the
+	game, "over scores=<a,b,..> winners=<players>".
+
+	-e gives the bots that many positions of endgame search per buy
+	(interface.h); off by default.
+
+	Usage:	domserver [-p port | -u socketPath] [-w botWorkers] [-s strategyFile]
+			  [-e endgameNodes]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include "dominion.h"
+#include "interface.h"
+#include "statepool.h"
+#include "rngs.h"
+
+#define SERVER_PORT 7777
+#define SERVER_EVENTS 256
+#define SESSION_IN 1024
+#define SESSION_OUT 8192
+#define BOT_MAX_TURNS 1000	//bot-only games are called off here
+
+struct session {
+  int fd;
+  char in[SESSION_IN];
+  int inLen;
+  char out[SESSION_OUT];
+  int outLen;
+  struct gameState *game;
+  long rngSeed;		//this game's position in rngs stream 1
+  int isBot[MAX_PLAYERS];
+  int started;
+  int turnNum;
+  int busy;		//a bot worker owns the game; input waits
+  int closing;
+  struct session *nextJob;
+};
+
+//Jobs for the bot workers and finished jobs coming back
+struct jobQueue {
+  struct session *head, *tail;
+};
+
+static struct jobQueue botJobs, botDone;
+static pthread_mutex_t jobLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t jobReady = PTHREAD_COND_INITIALIZER;
+static int doneEvent;		//eventfd the workers ring when botDone fills
+static int epollFd;
+
+static int listenMarker, doneMarker;	//epoll tags that are not sessions
+
+//Default cards, as defined in playDom
+static int kCards[10] = {adventurer, gardens, embargo, village, minion, mine, cutpurse, sea_hag, tribute, smithy};
+
+
+static void pushJob(struct jobQueue *q, struct session *s) {
+  s->nextJob = NULL;
+  if (q->tail)
+    q->tail->nextJob = s;
+  else
+    q->head = s;
+  q->tail = s;
+}
+
+static struct session* popJob(struct jobQueue *q) {
+  struct session *s = q->head;
+  if (s) {
+    q->head = s->nextJob;
+    if (q->head == NULL)
+      q->tail = NULL;
+  }
+  return s;
+}
+
+//Every game keeps its own place in the shared rngs stream
+static void rngEnter(struct session *s) {
+  SelectStream(1);
+  PutSeed(s->rngSeed);
+}
+
+static void rngLeave(struct session *s) {
+  GetSeed(&s->rngSeed);
+}
+
+static void reply(struct session *s, const char *fmt, ...) {
+  va_list ap;
+  int n;
+
+  va_start(ap, fmt);
+  n = vsnprintf(s->out + s->outLen, SESSION_OUT - s->outLen, fmt, ap);
+  va_end(ap);
+  if (n < 0 || n >= SESSION_OUT - s->outLen) {
+    s->closing = 1;	//client is not reading its replies
+    return;
+  }
+  s->outLen += n;
+}
+
+static void replyOver(struct session *s) {
+  int players[MAX_PLAYERS];
+  int p;
+
+  reply(s, "over scores=");
+  for (p = 0; p < s->game->numPlayers; p++)
+    reply(s, "%s%d", p ? "," : "", scoreFor(p, s->game));
+  getWinners(players, s->game);
+  reply(s, " winners=");
+  for (p = 0; p < s->game->numPlayers; p++)
+    if (players[p] == WINNER)
+      reply(s, "%d", p);
+  reply(s, "\n");
+  s->started = FALSE;
+}
+
+//Runs on a bot worker: play bot seats until a human is up or the game ends
+static void playBots(struct session *s) {
+  int player;
+
+  rngEnter(s);
+  while (!isGameOver(s->game) && s->turnNum < BOT_MAX_TURNS) {
+    player = whoseTurn(s->game);
+    if (!s->isBot[player])
+      break;
+    botBuyCard(player, s->turnNum, s->game);
+    if (player == s->game->numPlayers - 1)
+      s->turnNum++;
+    endTurn(s->game);
+  }
+  rngLeave(s);
+}
+
+static void* botWorker(void *arg) {
+  struct session *s;
+  unsigned long long one = 1;
+
+  for (;;) {
+    pthread_mutex_lock(&jobLock);
+    while ((s = popJob(&botJobs)) == NULL)
+      pthread_cond_wait(&jobReady, &jobLock);
+    pthread_mutex_unlock(&jobLock);
+
+    playBots(s);
+
+    pthread_mutex_lock(&jobLock);
+    pushJob(&botDone, s);
+    pthread_mutex_unlock(&jobLock);
+    if (write(doneEvent, &one, sizeof(one)) < 0)
+      perror("eventfd");
+  }
+  return NULL;
+}
+
+//Reply for the command that handed the turn over (init or end)
+static void replyTurn(struct session *s) {
+  if (isGameOver(s->game) || s->turnNum >= BOT_MAX_TURNS)
+    replyOver(s);
+  else
+    reply(s, "ok turn player=%d number=%d\n", whoseTurn(s->game), s->turnNum);
+}
+
+//Hand the game to the workers if a bot is up; otherwise reply now
+static void afterTurnChange(struct session *s) {
+  if (s->started && !isGameOver(s->game) && s->isBot[whoseTurn(s->game)]) {
+    //Take the socket out of epoll until the worker hands the game back;
+    //one merely muted would still report hangups and errors
+    s->busy = 1;
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, s->fd, NULL);
+    pthread_mutex_lock(&jobLock);
+    pushJob(&botJobs, s);
+    pthread_cond_signal(&jobReady);
+    pthread_mutex_unlock(&jobLock);
+    return;
+  }
+  replyTurn(s);
+}
+
+static void handleCommand(struct session *s, char *line) {
+  char command[MAX_STRING_LENGTH] = "";
+  int arg0 = UNUSED, arg1 = UNUSED, arg2 = UNUSED, arg3 = UNUSED;
+  struct gameState *game = s->game;
+  int player, i, outcome;
+
+  sscanf(line, "%31s %d %d %d %d", command, &arg0, &arg1, &arg2, &arg3);
+  if (strcmp(command, "quit") == 0) {
+    s->closing = 1;
+    return;
+  }
+  //Protocol names for the interface commands that print in player.c
+  if (strcmp(command, "hand") == 0)
+    strcpy(command, "show");
+  else if (strcmp(command, "score") == 0)
+    strcpy(command, "resi");
+
+  if (commandLookup(command) != CMD_INIT && s->started == FALSE) {
+    reply(s, "err no game\n");
+    return;
+  }
+
+  player = whoseTurn(game);
+  rngEnter(s);
+  switch (commandLookup(command)) {
+  case CMD_INIT:
+    memset(s->isBot, 0, sizeof(s->isBot));
+    for (i = arg0 - arg1; i < arg0; i++)
+      if (i >= 0 && i < MAX_PLAYERS)
+	s->isBot[i] = TRUE;
+    memset(game, 0, sizeof(struct gameState));
+    s->turnNum = 0;
+    s->started = initializeGame(arg0, kCards, arg2 > 0 ? arg2 : 1, game) == SUCCESS;
+    rngLeave(s);
+    if (!s->started)
+      reply(s, "err bad init\n");
+    else
+      afterTurnChange(s);
+    return;
+  case CMD_PLAY:
+    outcome = arg0 >= 0 && arg0 < numHandCards(game) ?
+      playCard(arg0, arg1, arg2, arg3, game) : FAILURE;
+    break;
+  case CMD_BUY:
+    outcome = arg0 >= curse && arg0 <= treasure_map ? buyCard(arg0, game) : FAILURE;
+    break;
+  case CMD_END:
+    if (player == game->numPlayers - 1)
+      s->turnNum++;
+    endTurn(game);
+    rngLeave(s);
+    afterTurnChange(s);
+    return;
+  case CMD_STAT:
+    reply(s, "ok player=%d phase=%d actions=%d coins=%d buys=%d hand=%d\n", player,
+	  game->phase, game->numActions, game->coins, game->numBuys, game->handCount[player]);
+    rngLeave(s);
+    return;
+  case CMD_SHOW:
+    reply(s, "ok");
+    for (i = 0; i < game->handCount[player]; i++)
+      reply(s, " %d", game->hand[player][i]);
+    reply(s, "\n");
+    rngLeave(s);
+    return;
+  case CMD_SUPPLY:
+    reply(s, "ok");
+    for (i = 0; i <= treasure_map; i++)
+      reply(s, " %d", game->supplyCount[i]);
+    reply(s, "\n");
+    rngLeave(s);
+    return;
+  case CMD_RESIGN:
+    reply(s, "ok scores=");
+    for (i = 0; i < game->numPlayers; i++)
+      reply(s, "%s%d", i ? "," : "", scoreFor(i, game));
+    reply(s, "\n");
+    rngLeave(s);
+    return;
+  default:
+    rngLeave(s);
+    reply(s, "err unknown command\n");
+    return;
+  }
+  rngLeave(s);
+
+  if (isGameOver(game))
+    replyOver(s);
+  else if (outcome == SUCCESS)
+    reply(s, "ok coins=%d buys=%d actions=%d\n", game->coins, game->numBuys, game->numActions);
+  else
+    reply(s, "err rejected\n");
+}
+
+static void closeSession(struct session *s) {
+  epoll_ctl(epollFd, EPOLL_CTL_DEL, s->fd, NULL);
+  close(s->fd);
+  poolFreeGame(s->game);
+  free(s);
+}
+
+static void flushOutput(struct session *s) {
+  struct epoll_event ev;
+  ssize_t n;
+
+  while (s->outLen > 0) {
+    n = write(s->fd, s->out, s->outLen);
+    if (n < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK)
+	s->closing = 1;
+      break;
+    }
+    memmove(s->out, s->out + n, s->outLen - n);
+    s->outLen -= n;
+  }
+
+  ev.events = EPOLLIN | (s->outLen > 0 ? EPOLLOUT : 0);
+  ev.data.ptr = s;
+  epoll_ctl(epollFd, EPOLL_CTL_MOD, s->fd, &ev);
+}
+
+//Run every complete line we have, stopping while a bot turn is out
+static void processInput(struct session *s) {
+  char *nl;
+  int used;
+
+  while (!s->busy && !s->closing && (nl = memchr(s->in, '\n', s->inLen)) != NULL) {
+    *nl = '\0';
+    used = nl - s->in + 1;
+    handleCommand(s, s->in);
+    memmove(s->in, s->in + used, s->inLen - used);
+    s->inLen -= used;
+  }
+  if (s->inLen == SESSION_IN)
+    s->closing = 1;	//line too long
+}
+
+static void readSession(struct session *s) {
+  ssize_t n;
+
+  for (;;) {
+    n = read(s->fd, s->in + s->inLen, SESSION_IN - s->inLen);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+      s->closing = 1;
+      break;
+    }
+    if (n < 0)
+      break;
+    s->inLen += n;
+    if (s->inLen == SESSION_IN)
+      break;
+  }
+  processInput(s);
+}
+
+static void acceptSessions(int listenFd) {
+  struct epoll_event ev;
+  struct session *s;
+  int fd, one = 1;
+
+  while ((fd = accept(listenFd, NULL, NULL)) >= 0) {
+    fcntl(fd, F_SETFL, O_NONBLOCK);
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    s = calloc(1, sizeof(struct session));
+    if (s != NULL)
+      s->game = poolNewGame();
+    if (s == NULL || s->game == NULL) {
+      free(s);
+      close(fd);
+      continue;
+    }
+    s->fd = fd;
+    s->rngSeed = 1;
+    ev.events = EPOLLIN;
+    ev.data.ptr = s;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+  }
+}
+
+//Deliver the replies for bot turns that finished, then resume the input
+static void collectBots(void) {
+  struct epoll_event ev;
+  unsigned long long count;
+  struct session *s;
+
+  if (read(doneEvent, &count, sizeof(count)) < 0)
+    return;
+  for (;;) {
+    pthread_mutex_lock(&jobLock);
+    s = popJob(&botDone);
+    pthread_mutex_unlock(&jobLock);
+    if (s == NULL)
+      break;
+    s->busy = 0;
+    ev.events = EPOLLIN;
+    ev.data.ptr = s;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, s->fd, &ev);
+    replyTurn(s);
+    processInput(s);
+    if (!s->busy)
+      flushOutput(s);
+    if (s->closing && !s->busy)
+      closeSession(s);
+  }
+}
+
+static int openListener(int port, const char *path) {
+  int fd, one = 1;
+
+  if (path != NULL) {
+    struct sockaddr_un addr;
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    unlink(path);
+    if (fd < 0 || bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0)
+      return -1;
+  }
+  else {
+    struct sockaddr_in addr;
+    fd = socket(AF_INET, SOCK_STREAM, 0);
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (fd < 0 || bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0)
+      return -1;
+  }
+  if (listen(fd, SOMAXCONN) < 0)
+    return -1;
+  fcntl(fd, F_SETFL, O_NONBLOCK);
+  return fd;
+}
+
+int main(int argc, char **argv) {
+  struct epoll_event ev, events[SERVER_EVENTS];
+  struct session *s;
+  const char *path = NULL;
+  const char *strategyPath = NULL;
+  int port = SERVER_PORT;
+  int workers = 2;
+  int listenFd, n, i;
+  pthread_t thread;
+
+  for (i = 1; i + 1 < argc; i += 2) {
+    if (strcmp(argv[i], "-p") == 0)
+      port = atoi(argv[i + 1]);
+    else if (strcmp(argv[i], "-u") == 0)
+      path = argv[i + 1];
+    else if (strcmp(argv[i], "-w") == 0)
+      workers = atoi(argv[i + 1]);
+    else if (strcmp(argv[i], "-s") == 0)
+      strategyPath = argv[i + 1];
+    else if (strcmp(argv[i], "-e") == 0)
+      setBotEndgameNodes(atol(argv[i + 1]));
+  }
+  if (i != argc) {
+    printf("Usage: domserver [-p port | -u socketPath] [-w botWorkers] [-s strategyFile]\n"
+	   "                 [-e endgameNodes]\n");
+    return EXIT_SUCCESS;
+  }
+  //Loaded before any worker starts; the workers only read it
+  if (loadBotStrategy(strategyPath) == FAILURE) {
+    fprintf(stderr, "domserver: cannot load strategy %s\n", strategyPath);
+    return EXIT_FAILURE;
+  }
+
+  signal(SIGPIPE, SIG_IGN);
+  listenFd = openListener(port, path);
+  if (listenFd < 0) {
+    perror("domserver");
+    return EXIT_FAILURE;
+  }
+  epollFd = epoll_create1(0);
+  doneEvent = eventfd(0, EFD_NONBLOCK);
+
+  ev.events = EPOLLIN;
+  ev.data.ptr = &listenMarker;
+  epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev);
+  ev.data.ptr = &doneMarker;
+  epoll_ctl(epollFd, EPOLL_CTL_ADD, doneEvent, &ev);
+
+  for (i = 0; i < (workers > 0 ? workers : 1); i++) {
+    pthread_create(&thread, NULL, botWorker, NULL);
+    pthread_detach(thread);
+  }
+
+  if (path != NULL)
+    printf("domserver listening on %s\n", path);
+  else
+    printf("domserver listening on 127.0.0.1:%d\n", port);
+  fflush(stdout);
+
+  for (;;) {
+    n = epoll_wait(epollFd, events, SERVER_EVENTS, -1);
+    for (i = 0; i < n; i++) {
+      if (events[i].data.ptr == &listenMarker) {
+	acceptSessions(listenFd);
+	continue;
+      }
+      if (events[i].data.ptr == &doneMarker) {
+	collectBots();
+	continue;
+      }
+
+      //A busy session is out of epoll, so every session here is idle
+      s = events[i].data.ptr;
+      if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+	readSession(s);
+      if (!s->busy)
+	flushOutput(s);
+      if (s->closing && !s->busy)
+	closeSession(s);
+    }
+  }
+  return EXIT_SUCCESS;
+}
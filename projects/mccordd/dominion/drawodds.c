@@ -0,0 +1,124 @@
+/* 	Draw Odds
+*/
+
+#include <string.h>
+#include <pthread.h>
+#include "drawodds.h"
+
+static double binomial[DRAWODDS_MAX_PILE + 1][DRAWODDS_MAX_DRAW + 1];
+static pthread_once_t binomialOnce = PTHREAD_ONCE_INIT;
+
+
+static void makeBinomials(void) {
+  int n, k;
+  for (n = 0; n <= DRAWODDS_MAX_PILE; n++) {
+    binomial[n][0] = 1;
+    for (k = 1; k <= DRAWODDS_MAX_DRAW; k++) {
+      binomial[n][k] = n == 0 ? 0 : binomial[n - 1][k - 1] + binomial[n - 1][k];
+    }
+  }
+}
+
+
+void countKinds(const int *cards, int count, int kinds[DRAWODDS_KINDS]) {
+  int i;
+  for (i = 0; i < count; i++) {
+    if (cards[i] == copper) {
+      kinds[DRAW_COPPER]++;
+    }
+    else if (cards[i] == silver) {
+      kinds[DRAW_SILVER]++;
+    }
+    else if (cards[i] == gold) {
+      kinds[DRAW_GOLD]++;
+    }
+    else {
+      kinds[DRAW_OTHER]++;
+    }
+  }
+}
+
+
+//Add weight times the distribution of draw cards from pile, shifted by base coins
+static void addHypergeometric(const int pile[DRAWODDS_KINDS], int draw, int base, double weight,
+			      double p[DRAWODDS_MAX_COINS + 1]) {
+  int g, s, c, o;
+  double pg, ps, pc;
+  int total = pile[DRAW_OTHER] + pile[DRAW_COPPER] + pile[DRAW_SILVER] + pile[DRAW_GOLD];
+
+  weight /= binomial[total][draw];
+  for (g = 0; g <= draw && g <= pile[DRAW_GOLD]; g++) {
+    pg = weight * binomial[pile[DRAW_GOLD]][g];
+    for (s = 0; g + s <= draw && s <= pile[DRAW_SILVER]; s++) {
+      ps = pg * binomial[pile[DRAW_SILVER]][s];
+      for (c = 0; g + s + c <= draw && c <= pile[DRAW_COPPER]; c++) {
+	o = draw - g - s - c;
+	if (o > pile[DRAW_OTHER]) {
+	  continue;
+	}
+	pc = ps * binomial[pile[DRAW_COPPER]][c] * binomial[pile[DRAW_OTHER]][o];
+	p[base + 3 * g + 2 * s + c] += pc;
+      }
+    }
+  }
+}
+
+
+int drawCoinDistribution(const int deck[DRAWODDS_KINDS], const int discard[DRAWODDS_KINDS],
+			 int draw, struct coinDistribution *dist) {
+  int deckTotal = 0, discardTotal = 0, deckCoins = 0, i;
+
+  for (i = 0; i < DRAWODDS_KINDS; i++) {
+    deckTotal += deck[i];
+    discardTotal += discard[i];
+    deckCoins += i * deck[i];
+  }
+  if (draw < 0 || draw > DRAWODDS_MAX_DRAW || deckTotal > DRAWODDS_MAX_PILE || discardTotal > DRAWODDS_MAX_PILE) {
+    return -1;
+  }
+  pthread_once(&binomialOnce, makeBinomials);
+
+  memset(dist, 0, sizeof(struct coinDistribution));
+  if (draw <= deckTotal) {
+    dist->cards = draw;
+    addHypergeometric(deck, draw, 0, 1.0, dist->p);
+    return 0;
+  }
+
+  //The whole deck, then what is left from the reshuffled discard pile
+  draw -= deckTotal;
+  if (draw > discardTotal) {
+    draw = discardTotal;
+  }
+  dist->cards = deckTotal + draw;
+  addHypergeometric(discard, draw, deckCoins, 1.0, dist->p);
+  return 0;
+}
+
+
+int nextHandCoins(int player, struct gameState *state, struct coinDistribution *dist) {
+  int deck[DRAWODDS_KINDS] = {0};
+  int discard[DRAWODDS_KINDS] = {0};
+
+  if (player < 0 || player >= state->numPlayers) {
+    return -1;
+  }
+  countKinds(state->deck[player], state->deckCount[player], deck);
+  //endTurn() discards the hand but not playedCards, so played cards never come back
+  countKinds(state->discard[player], state->discardCount[player], discard);
+  countKinds(state->hand[player], state->handCount[player], discard);
+  return drawCoinDistribution(deck, discard, DRAWODDS_HAND, dist);
+}
+
+
+double coinsAtLeast(const struct coinDistribution *dist, int coins) {
+  double p = 0;
+  int c;
+  if (coins < 0) {
+    coins = 0;
+  }
+  for (c = coins; c <= DRAWODDS_MAX_COINS; c++) {
+    p += dist->p[c];
+  }
+  return p;
+}
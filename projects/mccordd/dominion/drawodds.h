@@ -0,0 +1,55 @@
+/* 	Draw Odds
+
+	Exact coin distributions for a draw, without simulating.  Cards are
+	sorted into four kinds by the coins they give (other, copper, silver,
+	gold, so a kind's index is its value), and a draw of n cards from a
+	pile is a multivariate hypergeometric over those kinds.  When the
+	deck holds fewer than n cards the whole deck is drawn and the rest
+	comes from the shuffled discard pile, exactly as drawCard() does.
+
+	The binomial coefficients are tabulated once, so a distribution is a
+	few hundred multiply-adds: microseconds, against the milliseconds a
+	useful number of rollouts costs.
+*/
+
+#ifndef _DRAWODDS_H
+#define _DRAWODDS_H
+
+#include "dominion.h"
+
+#define DRAWODDS_KINDS 4
+#define DRAWODDS_HAND 5				//cards endTurn() draws
+#define DRAWODDS_MAX_DRAW 10
+#define DRAWODDS_MAX_COINS (3 * DRAWODDS_MAX_DRAW)
+#define DRAWODDS_MAX_PILE (MAX_DECK + MAX_HAND)
+
+enum DRAW_KIND {
+  DRAW_OTHER = 0,
+  DRAW_COPPER,
+  DRAW_SILVER,
+  DRAW_GOLD
+};
+
+struct coinDistribution {
+  double p[DRAWODDS_MAX_COINS + 1];	//p[c]: chance the draw is worth exactly c coins
+  int cards;				//cards actually drawn, less than asked if both piles run out
+};
+
+void countKinds(const int *cards, int count, int kinds[DRAWODDS_KINDS]);
+/* Add the kinds of count cards to kinds[] (which is not cleared first) */
+
+int drawCoinDistribution(const int deck[DRAWODDS_KINDS], const int discard[DRAWODDS_KINDS],
+			 int draw, struct coinDistribution *dist);
+/* Distribution of the coins in draw cards taken from a deck with the
+   given kinds, reshuffling discard once the deck is empty.  Returns -1
+   if draw is over DRAWODDS_MAX_DRAW or a pile over DRAWODDS_MAX_PILE */
+
+int nextHandCoins(int player, struct gameState *state, struct coinDistribution *dist);
+/* Distribution of the coins in the hand player draws when their turn
+   ends: their current hand joins the discard pile, then DRAWODDS_HAND
+   cards are drawn.  Returns -1 on a bad player */
+
+double coinsAtLeast(const struct coinDistribution *dist, int coins);
+/* Chance of coins or more */
+
+#endif
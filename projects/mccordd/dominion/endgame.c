@@ -0,0 +1,330 @@
+/* 	Endgame Solver
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include "drawodds.h"
+#include "endgame.h"
+
+#define ENDGAME_MEMO_SIZE (1 << ENDGAME_MEMO_BITS)
+#define ENDGAME_CHECK_MASK 1023		//nodes between looks at the clock
+
+//A seat about to draw; also the memo key, so every byte is set
+struct endgamePosition {
+  signed char toMove;
+  signed char depth;		//turns left to search, this one included
+  signed char provinces, duchies, estates;
+  signed char pad[3];
+  short score[MAX_PLAYERS];
+  short dead[MAX_PLAYERS];	//victory cards bought during the search
+};
+
+struct endgameEntry {
+  struct endgamePosition key;
+  unsigned int generation;	//valid only in the search that wrote it
+  int horizon;			//some line below stopped at the depth limit
+  double value[MAX_PLAYERS];
+};
+
+struct endgameSearch {
+  int numPlayers;
+  int emptyOther;		//empty piles besides the three victory piles
+  int kinds[MAX_PLAYERS][DRAWODDS_KINDS];
+  struct endgameEntry *memo;
+  unsigned int generation;
+  double deadline;		//0 for no time limit
+  long maxNodes;		//0 for no node limit
+  int timed;			//this pass may be cut short
+  int aborted;
+  int horizon;
+  long nodes;
+};
+
+
+//This thread's memo table, reused by every search on it
+static __thread struct endgameEntry *threadMemo;
+static __thread unsigned int threadGeneration;
+
+static pthread_key_t memoKey;
+static pthread_once_t memoKeyOnce = PTHREAD_ONCE_INIT;
+
+
+static void memoThreadExit(void *memo) {
+  free(memo);
+}
+
+static void memoKeyCreate(void) {
+  pthread_key_create(&memoKey, memoThreadExit);
+}
+
+
+//A fresh generation of this thread's memo table, or NULL
+static struct endgameEntry *memoTable(unsigned int *generation) {
+  if (threadMemo == NULL) {
+    threadMemo = calloc(ENDGAME_MEMO_SIZE, sizeof(struct endgameEntry));
+    if (threadMemo == NULL) {
+      return NULL;
+    }
+    pthread_once(&memoKeyOnce, memoKeyCreate);
+    pthread_setspecific(memoKey, threadMemo);
+  }
+  //Generation 0 marks an empty entry, so clear the table when it wraps
+  if (++threadGeneration == 0) {
+    memset(threadMemo, 0, sizeof(struct endgameEntry) * ENDGAME_MEMO_SIZE);
+    threadGeneration = 1;
+  }
+  *generation = threadGeneration;
+  return threadMemo;
+}
+
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+static unsigned int hashPosition(const struct endgamePosition *pos) {
+  const unsigned char *b = (const unsigned char*)pos;
+  unsigned int h = 2166136261u;
+  size_t i;
+  for (i = 0; i < sizeof(struct endgamePosition); i++) {
+    h = (h ^ b[i]) * 16777619u;
+  }
+  return h;
+}
+
+
+static int gameEnded(struct endgameSearch *s, const struct endgamePosition *pos) {
+  return pos->provinces == 0 || s->emptyOther + (pos->duchies == 0) + (pos->estates == 0) >= 3;
+}
+
+
+//Final scores: the top score wins, shared between the seats tied on it
+static void finalValue(struct endgameSearch *s, const struct endgamePosition *pos, double value[]) {
+  int p, best = pos->score[0], tied = 0;
+  for (p = 1; p < s->numPlayers; p++) {
+    if (pos->score[p] > best) {
+      best = pos->score[p];
+    }
+  }
+  for (p = 0; p < s->numPlayers; p++) {
+    tied += pos->score[p] == best;
+  }
+  for (p = 0; p < s->numPlayers; p++) {
+    value[p] = pos->score[p] == best ? 1.0 / tied : 0.0;
+  }
+}
+
+
+//Out of depth: odds from the scores alone, a softmax with ENDGAME_SCALE
+static void horizonValue(struct endgameSearch *s, const struct endgamePosition *pos, double value[]) {
+  double total = 0;
+  int p;
+  for (p = 0; p < s->numPlayers; p++) {
+    value[p] = exp((pos->score[p] - pos->score[0]) / ENDGAME_SCALE);
+    total += value[p];
+  }
+  for (p = 0; p < s->numPlayers; p++) {
+    value[p] /= total;
+  }
+}
+
+
+static void chanceValue(struct endgameSearch *s, struct endgamePosition *pos, double value[]);
+
+
+//The seat to move buys card (ENDGAME_NONE for none) and its turn ends
+static void buyValue(struct endgameSearch *s, const struct endgamePosition *pos, int card, double value[]) {
+  struct endgamePosition next = *pos;
+  int p = pos->toMove;
+
+  if (card == province) {
+    next.provinces--;
+    next.score[p] += 6;
+  }
+  else if (card == duchy) {
+    next.duchies--;
+    next.score[p] += 3;
+  }
+  else if (card == estate) {
+    next.estates--;
+    next.score[p] += 1;
+  }
+  if (card != ENDGAME_NONE) {
+    next.dead[p]++;
+  }
+  next.toMove = (p + 1) % s->numPlayers;
+  next.depth--;
+
+  if (gameEnded(s, &next)) {
+    finalValue(s, &next, value);
+  }
+  else if (next.depth == 0) {
+    s->horizon = 1;
+    horizonValue(s, &next, value);
+  }
+  else {
+    chanceValue(s, &next, value);
+  }
+}
+
+
+//Best buy for the seat to move with coins; its value goes in value[]
+static int bestBuy(struct endgameSearch *s, const struct endgamePosition *pos, int coins, double value[]) {
+  static const int options[] = {province, duchy, estate, ENDGAME_NONE};
+  double child[MAX_PLAYERS];
+  int i, best = ENDGAME_NONE, first = 1;
+  int outer = s->horizon, below = 0;
+
+  for (i = 0; i < 4; i++) {
+    if ((options[i] == province && (coins < 8 || pos->provinces <= 0))
+	|| (options[i] == duchy && (coins < 5 || pos->duchies <= 0))
+	|| (options[i] == estate && (coins < 2 || pos->estates <= 0))) {
+      continue;
+    }
+    s->horizon = 0;
+    buyValue(s, pos, options[i], child);
+    if (s->aborted) {
+      return ENDGAME_NONE;
+    }
+    //Nothing beats a certain win, so the other buys need no search
+    if (!s->horizon && child[pos->toMove] >= 1.0) {
+      memcpy(value, child, sizeof(double) * s->numPlayers);
+      best = options[i];
+      below = 0;
+      break;
+    }
+    below |= s->horizon;
+    if (first || child[pos->toMove] > value[pos->toMove]) {
+      memcpy(value, child, sizeof(double) * s->numPlayers);
+      best = options[i];
+      first = 0;
+    }
+  }
+  s->horizon = outer | below;
+  return best;
+}
+
+
+//A seat about to draw its hand: the buys averaged over its coin distribution
+static void chanceValue(struct endgameSearch *s, struct endgamePosition *pos, double value[]) {
+  //Only these coin totals change what can be bought
+  static const int levels[] = {0, 2, 5, 8};
+  struct endgameEntry *entry = &s->memo[hashPosition(pos) & (ENDGAME_MEMO_SIZE - 1)];
+  struct coinDistribution dist;
+  int kinds[DRAWODDS_KINDS], empty[DRAWODDS_KINDS] = {0};
+  double child[MAX_PLAYERS], chance, above;
+  int horizon = s->horizon;
+  int i, p;
+
+  if (entry->generation == s->generation && memcmp(&entry->key, pos, sizeof(struct endgamePosition)) == 0) {
+    memcpy(value, entry->value, sizeof(double) * s->numPlayers);
+    s->horizon |= entry->horizon;
+    return;
+  }
+  s->nodes++;
+  if (s->timed && ((s->maxNodes > 0 && s->nodes > s->maxNodes)
+		   || (s->deadline > 0 && (s->nodes & ENDGAME_CHECK_MASK) == 0 && now() >= s->deadline))) {
+    s->aborted = 1;
+    return;
+  }
+
+  memcpy(kinds, s->kinds[(int)pos->toMove], sizeof(kinds));
+  kinds[DRAW_OTHER] += pos->dead[(int)pos->toMove];
+  drawCoinDistribution(kinds, empty, DRAWODDS_HAND, &dist);
+
+  s->horizon = 0;
+  memset(value, 0, sizeof(double) * s->numPlayers);
+  for (i = 3; i >= 0; i--) {
+    above = i == 3 ? 0 : coinsAtLeast(&dist, levels[i + 1]);
+    chance = coinsAtLeast(&dist, levels[i]) - above;
+    if (chance <= 0) {
+      continue;
+    }
+    bestBuy(s, pos, levels[i], child);
+    if (s->aborted) {
+      return;
+    }
+    for (p = 0; p < s->numPlayers; p++) {
+      value[p] += chance * child[p];
+    }
+  }
+
+  entry->key = *pos;
+  entry->generation = s->generation;
+  entry->horizon = s->horizon;
+  memcpy(entry->value, value, sizeof(double) * s->numPlayers);
+  s->horizon |= horizon;
+}
+
+
+int endgameNear(struct gameState *state) {
+  int i, empty = 0;
+  for (i = 0; i < 25; i++) {
+    empty += state->supplyCount[i] == 0;
+  }
+  return state->supplyCount[province] <= ENDGAME_PROVINCES || empty >= ENDGAME_EMPTY_PILES;
+}
+
+
+int endgameSolve(int player, struct gameState *state, int coins, double budgetSeconds,
+		 long maxNodes, struct endgameChoice *choice) {
+  struct endgameSearch s;
+  struct endgamePosition root;
+  double value[MAX_PLAYERS];
+  double start = now();
+  int p, i, depth, card;
+
+  memset(&s, 0, sizeof(s));
+  memset(&root, 0, sizeof(root));
+  memset(choice, 0, sizeof(struct endgameChoice));
+  s.memo = memoTable(&s.generation);
+  if (s.memo == NULL) {
+    return -1;
+  }
+  s.numPlayers = state->numPlayers;
+  s.deadline = budgetSeconds > 0 ? start + budgetSeconds : 0;
+  s.maxNodes = maxNodes;
+  //isGameOver() counts every pile of the 25 that is at zero
+  for (i = 0; i < 25; i++) {
+    if (i != province && i != duchy && i != estate) {
+      s.emptyOther += state->supplyCount[i] == 0;
+    }
+  }
+  for (p = 0; p < s.numPlayers; p++) {
+    countKinds(state->hand[p], state->handCount[p], s.kinds[p]);
+    countKinds(state->deck[p], state->deckCount[p], s.kinds[p]);
+    countKinds(state->discard[p], state->discardCount[p], s.kinds[p]);
+    root.score[p] = scoreFor(p, state);
+  }
+  root.toMove = player;
+  root.provinces = state->supplyCount[province];
+  root.duchies = state->supplyCount[duchy];
+  root.estates = state->supplyCount[estate];
+
+  choice->card = ENDGAME_NONE;
+  for (depth = 1; depth <= ENDGAME_MAX_DEPTH; depth++) {
+    root.depth = depth;
+    s.timed = depth > 1;	//the first pass always finishes
+    s.horizon = 0;
+    card = bestBuy(&s, &root, coins, value);
+    if (s.aborted) {
+      break;
+    }
+    choice->card = card;
+    choice->value = value[player];
+    choice->depth = depth;
+    if (!s.horizon) {
+      choice->exact = 1;
+      break;
+    }
+  }
+  choice->nodes = s.nodes;
+  choice->seconds = now() - start;
+  return 0;
+}
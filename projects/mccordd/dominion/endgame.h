@@ -0,0 +1,53 @@
+/* 	Endgame Solver
+
+	Expectimax over the last few turns of a game, when the choice that
+	matters is province, duchy, estate or nothing.  Each player's future
+	hands are drawn fresh from their whole deck (drawodds.h), buying a
+	victory card adds one dead card to the buyer's deck, and money buys
+	are left to the ordinary strategy.  Every seat maximizes its own
+	chance of winning, a tie sharing the win.
+
+	The tree is searched one turn deeper each pass until the time budget
+	or the node limit runs out or a pass reaches the end of every line
+	that matters (a buy that wins for certain makes the others moot), in
+	which case the answer is exact for this model.  With a node limit and
+	no time budget the answer depends only on the position, which is how
+	the bots use it.  Chance nodes (a seat about to draw) are memoized on
+	the supply, scores and deck sizes, so lines that buy the same cards
+	in a different order are only searched once.  The memo table is
+	allocated once per thread and given back when the thread exits.
+*/
+
+#ifndef _ENDGAME_H
+#define _ENDGAME_H
+
+#include "dominion.h"
+
+#define ENDGAME_PROVINCES 3		//endgameNear() at this many provinces or fewer
+#define ENDGAME_EMPTY_PILES 2		//or this many empty piles
+#define ENDGAME_MAX_DEPTH 24		//turns searched, all seats together
+#define ENDGAME_MEMO_BITS 15
+#define ENDGAME_SCALE 4.0		//points per e-fold of a horizon leaf's odds
+#define ENDGAME_NONE -1			//no victory card, the same as UNUSED in interface.h
+
+struct endgameChoice {
+  int card;		//province, duchy or estate; ENDGAME_NONE to buy none
+  double value;		//the player's chance of winning with perfect play
+  int depth;		//turns searched by the last full pass
+  int exact;		//the last pass reached the end of every line that matters
+  long nodes;
+  double seconds;
+};
+
+int endgameNear(struct gameState *state);
+/* True once the game is close enough to its end for endgameSolve() */
+
+int endgameSolve(int player, struct gameState *state, int coins, double budgetSeconds,
+		 long maxNodes, struct endgameChoice *choice);
+/* Best victory card for player to buy now with coins, player's turn
+   ending after the buy.  A deeper pass is abandoned once the search
+   passes budgetSeconds or maxNodes positions (0 for no limit of that
+   kind); the one-turn pass is always finished.  Returns -1 if the memo
+   table cannot be allocated */
+
+#endif
@@ -0,0 +1,227 @@
+/* 	Evaluation Network
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "evalnet.h"
+
+#define EVALNET_SPARSE 16	//a row that differs from the first in more entries is built in full
+
+typedef signed char v16qi __attribute__((vector_size(EVALNET_LANES)));
+typedef short v16hi __attribute__((vector_size(EVALNET_LANES * sizeof(short))));
+typedef int v16si __attribute__((vector_size(EVALNET_LANES * sizeof(int))));
+typedef float v16sf __attribute__((vector_size(EVALNET_LANES * sizeof(float))));
+
+//The file layout depends on the header being exactly 64 bytes
+typedef char headerSizeCheck[sizeof(struct evalnetHeader) == 64 ? 1 : -1];
+
+//The float arrays, padded so the int8 weights start on a cache line
+static long floatBytes(int hidden) {
+  return (3 * hidden * (long)sizeof(float) + 63) / 64 * 64;
+}
+
+
+long evalnetFileSize(int hidden) {
+  return sizeof(struct evalnetHeader) + floatBytes(hidden) + (long)hidden * FEATURE_STRIDE;
+}
+
+
+int evalnetOpen(const char *path, struct evalNet *net) {
+  const struct evalnetHeader *header;
+  const char *base;
+  struct stat info;
+  int fd;
+
+  memset(net, 0, sizeof(struct evalNet));
+  fd = open(path, O_RDONLY);
+  if (fd == -1) {
+    return -1;
+  }
+  if (fstat(fd, &info) == -1 || info.st_size < (off_t)sizeof(struct evalnetHeader)) {
+    close(fd);
+    return -1;
+  }
+  net->map = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (net->map == MAP_FAILED) {
+    net->map = NULL;
+    return -1;
+  }
+  net->size = info.st_size;
+
+  base = net->map;
+  header = net->map;
+  if (memcmp(header->magic, EVALNET_MAGIC, sizeof(header->magic)) != 0
+      || header->version != EVALNET_VERSION || header->inputs != FEATURE_STRIDE
+      || header->hidden < 1 || header->hidden > EVALNET_MAX_HIDDEN
+      || header->hidden % EVALNET_LANES != 0
+      || (header->activation != EVALNET_RELU && header->activation != EVALNET_LINEAR)
+      || net->size != evalnetFileSize(header->hidden)) {
+    evalnetClose(net);
+    return -1;
+  }
+  net->hidden = header->hidden;
+  net->activation = header->activation;
+  net->outputBias = header->outputBias;
+  net->scale = (const float*)(base + sizeof(struct evalnetHeader));
+  net->bias = net->scale + net->hidden;
+  net->output = net->bias + net->hidden;
+  net->weight = (const signed char*)(base + sizeof(struct evalnetHeader) + floatBytes(net->hidden));
+  return 0;
+}
+
+
+void evalnetClose(struct evalNet *net) {
+  if (net->map != NULL) {
+    munmap(net->map, net->size);
+  }
+  memset(net, 0, sizeof(struct evalNet));
+}
+
+
+int evalnetWrite(const char *path, int hidden, int activation, const float scale[],
+		 const float bias[], const float output[], float outputBias,
+		 const signed char weight[]) {
+  static const char zero[64];
+  struct evalnetHeader header;
+  long padding = floatBytes(hidden) - 3 * hidden * (long)sizeof(float);
+  FILE *file;
+  int ok;
+
+  if (hidden < 1 || hidden > EVALNET_MAX_HIDDEN || hidden % EVALNET_LANES != 0) {
+    return -1;
+  }
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, EVALNET_MAGIC, sizeof(header.magic));
+  header.version = EVALNET_VERSION;
+  header.inputs = FEATURE_STRIDE;
+  header.hidden = hidden;
+  header.activation = activation;
+  header.outputBias = outputBias;
+
+  file = fopen(path, "wb");
+  if (file == NULL) {
+    return -1;
+  }
+  ok = fwrite(&header, sizeof(header), 1, file) == 1
+    && fwrite(scale, sizeof(float), hidden, file) == (size_t)hidden
+    && fwrite(bias, sizeof(float), hidden, file) == (size_t)hidden
+    && fwrite(output, sizeof(float), hidden, file) == (size_t)hidden
+    && fwrite(zero, 1, padding, file) == (size_t)padding
+    && fwrite(weight, hidden, FEATURE_STRIDE, file) == FEATURE_STRIDE;
+  if (fclose(file) != 0) {
+    ok = 0;
+  }
+  return ok ? 0 : -1;
+}
+
+
+//sums += times * column.  |times| is at most 255, so every product fits
+//in 16 bits and only the sums are widened; the memcpy loads need no alignment
+static void addColumn(int *sums, const signed char *column, int times, int hidden) {
+  v16qi w;
+  v16si sum;
+  int h;
+
+  for (h = 0; h < hidden; h += EVALNET_LANES) {
+    memcpy(&w, column + h, sizeof(w));
+    memcpy(&sum, sums + h, sizeof(sum));
+    sum += __builtin_convertvector(__builtin_convertvector(w, v16hi) * (short)times, v16si);
+    memcpy(sums + h, &sum, sizeof(sum));
+  }
+}
+
+
+static void buildSums(const struct evalNet *net, const signed char *row, int *sums) {
+  int i;
+
+  memset(sums, 0, sizeof(int) * net->hidden);
+  for (i = 0; i < FEATURE_STRIDE; i++) {
+    if (row[i] != 0) {
+      addColumn(sums, net->weight + (long)i * net->hidden, row[i], net->hidden);
+    }
+  }
+}
+
+
+static float outputOf(const struct evalNet *net, const int *sums) {
+  v16sf total = {0}, unit, scale, bias, output;
+  v16si sum;
+  float score = net->outputBias;
+  int h;
+
+  for (h = 0; h < net->hidden; h += EVALNET_LANES) {
+    memcpy(&sum, sums + h, sizeof(sum));
+    memcpy(&scale, net->scale + h, sizeof(scale));
+    memcpy(&bias, net->bias + h, sizeof(bias));
+    memcpy(&output, net->output + h, sizeof(output));
+    unit = __builtin_convertvector(sum, v16sf) * scale + bias;
+    if (net->activation == EVALNET_RELU) {
+      unit = (v16sf)((v16si)unit & (unit > 0));
+    }
+    total += output * unit;
+  }
+  for (h = 0; h < EVALNET_LANES; h++) {
+    score += total[h];
+  }
+  return score;
+}
+
+
+//Where row differs from first, up to EVALNET_SPARSE entries; more than that
+//returns EVALNET_SPARSE + 1
+static int differences(const signed char *first, const signed char *row, int changed[], int delta[]) {
+  int i, j, n = 0;
+
+  for (i = 0; i < FEATURE_STRIDE; i += EVALNET_LANES) {
+    if (memcmp(first + i, row + i, EVALNET_LANES) == 0) {
+      continue;
+    }
+    for (j = i; j < i + EVALNET_LANES; j++) {
+      if (row[j] != first[j]) {
+	if (n == EVALNET_SPARSE) {
+	  return n + 1;
+	}
+	changed[n] = j;
+	delta[n] = row[j] - first[j];
+	n++;
+      }
+    }
+  }
+  return n;
+}
+
+
+int evalnetScore(const struct evalNet *net, const signed char *rows, int count, float scores[]) {
+  int first[EVALNET_MAX_HIDDEN], sums[EVALNET_MAX_HIDDEN];
+  int changed[EVALNET_SPARSE], delta[EVALNET_SPARSE];
+  const signed char *row;
+  int i, j, n;
+
+  if (count < 0 || count > EVALNET_MAX_BATCH) {
+    return -1;
+  }
+  if (count == 0) {
+    return 0;
+  }
+  buildSums(net, rows, first);
+  scores[0] = outputOf(net, first);
+  for (i = 1; i < count; i++) {
+    row = rows + (long)i * FEATURE_STRIDE;
+    n = differences(rows, row, changed, delta);
+    if (n > EVALNET_SPARSE) {
+      buildSums(net, row, sums);
+    } else {
+      memcpy(sums, first, sizeof(int) * net->hidden);
+      for (j = 0; j < n; j++) {
+	addColumn(sums, net->weight + (long)changed[j] * net->hidden, delta[j], net->hidden);
+      }
+    }
+    scores[i] = outputOf(net, sums);
+  }
+  return 0;
+}
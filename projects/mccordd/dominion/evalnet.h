@@ -0,0 +1,93 @@
+/* 	Evaluation Network
+
+	A small value network over int8 feature rows (featurevec.h): one
+	hidden layer of int8 weights, each unit's sum dequantized by its own
+	scale, then an optional ReLU and a float output layer.  The score is
+	the perspective player's value; only the order of scores matters to
+	the bot, so the training target is up to the trainer.  A hidden
+	layer with EVALNET_LINEAR is a linear model.
+
+	Weight files are mapped read-only and used in place, so opening one
+	costs nothing however large it is and every process playing with the
+	same file shares its pages.  The layout, native byte order:
+
+	    struct evalnetHeader			64 bytes
+	    float scale[hidden]			unit sum to unit input
+	    float bias[hidden]
+	    float output[hidden]			output layer weights
+	    zero padding to a multiple of 64 bytes
+	    signed char weight[FEATURE_STRIDE][hidden]
+
+	The weights are stored by input, so the hidden layer is built as a
+	sum of columns, one for each nonzero entry of the row (most are
+	zero), with GCC vector types EVALNET_LANES units at a time; these
+	become packed instructions on whatever the target has, and the
+	output layer runs the same way.  hidden is a multiple of
+	EVALNET_LANES.
+
+	evalnetScore() takes a whole batch of rows, e.g. the position before
+	a decision followed by each of its successors.  A later row that
+	differs from the first in only a few entries, as a successor does,
+	starts from the first row's unit sums and adds just those entries'
+	columns, so a whole decision costs little more than one row.  The
+	sums are integers either way, so the scores are the same.  A net is
+	only read once open, so any number of threads may share it.
+*/
+
+#ifndef _EVALNET_H
+#define _EVALNET_H
+
+#include "featurevec.h"
+
+#define EVALNET_MAGIC "DOMEVNET"
+#define EVALNET_VERSION 1
+#define EVALNET_LANES 16
+#define EVALNET_MAX_HIDDEN 1024
+#define EVALNET_MAX_BATCH 64		//rows per evalnetScore() call
+
+enum EVALNET_ACTIVATION {
+  EVALNET_RELU = 0,
+  EVALNET_LINEAR
+};
+
+struct evalnetHeader {
+  char magic[8];		//EVALNET_MAGIC, unterminated
+  int version;
+  int inputs;			//FEATURE_STRIDE
+  int hidden;			//EVALNET_LANES..EVALNET_MAX_HIDDEN, a multiple of EVALNET_LANES
+  int activation;		//enum EVALNET_ACTIVATION
+  float outputBias;
+  char reserved[36];		//zero
+};
+
+struct evalNet {
+  void *map;
+  long size;
+  int hidden;
+  int activation;
+  float outputBias;
+  const float *scale, *bias, *output;
+  const signed char *weight;	//FEATURE_STRIDE columns of hidden
+};
+
+long evalnetFileSize(int hidden);
+/* Bytes in a weight file with hidden units */
+
+int evalnetOpen(const char *path, struct evalNet *net);
+/* Map the weight file at path.  Returns -1, with net unusable, if the
+   file cannot be mapped or its header or size do not match this build */
+
+void evalnetClose(struct evalNet *net);
+
+int evalnetWrite(const char *path, int hidden, int activation, const float scale[],
+		 const float bias[], const float output[], float outputBias,
+		 const signed char weight[]);
+/* Write a weight file, for trainers and tests; weight is FEATURE_STRIDE
+   columns of hidden.  Returns -1 on a bad hidden or if the file cannot
+   be written */
+
+int evalnetScore(const struct evalNet *net, const signed char *rows, int count, float scores[]);
+/* scores[i] = the net's value of row i of count (at most EVALNET_MAX_BATCH)
+   rows of FEATURE_STRIDE.  Returns -1 on a bad count */
+
+#endif
@@ -0,0 +1,377 @@
+/* 	Strategy Evolver
+
+	Genetic search over the parameters of a big-money-plus-one-action
+	strategy: buy thresholds, the action card's copy cap and coin window,
+	and when to start greening.  Each genome is written out as strategy
+	text (strategy.h) and played head to head against the current
+	champion on every core, in-process through simulatePrototype() on
+	the engine kingdomgen specialized for the kingdom (kingdomengine.h).
+
+	Every genome in a generation meets the champion on the same seeds
+	(common random numbers) with seats swapped on each seed, so fitness
+	differences come from the genomes rather than the shuffles.  Matches
+	run in batches and stop as soon as the result is significant either
+	way; a challenger only takes over when it beats the champion
+	significantly, and the run stops once no challenger has for -patience
+	generations.  The population is checkpointed after every generation
+	and -r resumes from the checkpoint.
+
+	Usage:	evolve [-j threads] [-p population] [-g generations] [-m maxGames]
+		       [-a actionCard] [-s seed] [-c checkpointFile] [-patience n] [-r]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "dominion.h"
+#include "dominion_helpers.h"
+#include "strategy.h"
+#include "simulate.h"
+#include "kingdomengine.h"
+
+#define EVOLVE_MAX_POPULATION 256
+#define EVOLVE_BATCH 20			//seeds per batch; each seed is two games
+#define EVOLVE_Z_STOP 2.58		//two sided 99%
+#define EVOLVE_ELITE 2
+#define EVOLVE_TEXT_LENGTH 512
+
+struct geneSpec {
+  const char *name;
+  int low, high, start;
+};
+
+//The start values are plain big money with two of the action card
+static const struct geneSpec genes[] = {
+  { "gold_coins",	6, 9, 6 },	//gold at or above this many coins
+  { "silver_coins",	3, 5, 3 },
+  { "action_cap",	0, 5, 2 },	//terminal draw limit: own fewer than this
+  { "action_max_coins",	2, 7, 5 },	//prefer the action up to this many coins
+  { "action_last_turn",	1, 30, 30 },	//stop buying the action after this turn
+  { "duchy_provinces",	0, 8, 0 },	//duchy once this few provinces are left
+  { "estate_provinces",	0, 8, 0 }
+};
+#define NUM_GENES ((int)(sizeof(genes) / sizeof(genes[0])))
+
+struct genome {
+  int gene[NUM_GENES];
+  double score;		//challenger's points per game, a tie is half
+  double z;		//significance of score against 0.5
+  int games;
+};
+
+//Shared with the worker threads for one generation
+static struct genome population[EVOLVE_MAX_POPULATION];
+static int populationSize = 16;
+static struct strategy champion;
+static int nextGenome;
+static int generationSeed;
+static int maxGames = 400;
+static int actionCard = smithy;
+static int kingdom[10] = {adventurer, gardens, embargo, village, minion, mine, cutpurse,
+			  council_room, tribute, smithy};
+
+
+static void genomeText(const struct genome *g, char *text) {
+  const int *x = g->gene;
+  //An action rule capped below the card's cost could never fire, and
+  //strategyParse() refuses it; "#" leaves the line a comment instead
+  snprintf(text, EVOLVE_TEXT_LENGTH,
+	   "name evolved\n"
+	   "province if coins >= 8\n"
+	   "duchy if coins >= 5 and supply:province <= %d\n"
+	   "%s%s if coins <= %d and owned < %d and turn <= %d\n"
+	   "gold if coins >= %d\n"
+	   "estate if supply:province <= %d\n"
+	   "silver if coins >= %d\n",
+	   x[5], x[3] < getCost(actionCard) ? "# " : "", strategyCardId(actionCard),
+	   x[3], x[2], x[4], x[0], x[6], x[1]);
+}
+
+
+static void genomeStart(struct genome *g) {
+  int i;
+  memset(g, 0, sizeof(struct genome));
+  for (i = 0; i < NUM_GENES; i++) {
+    g->gene[i] = genes[i].start;
+  }
+}
+
+
+//Play g against the champion on this generation's seeds
+static void evaluate(struct genome *g) {
+  const struct strategy *seats[2];
+  struct strategy challenger;
+  const struct kingdomEngine *engine = kingdomEngineFor(kingdom);
+  struct gamePrototype prototype;
+  struct gameResult result;
+  char text[EVOLVE_TEXT_LENGTH];
+  double points = 0;
+  int n = 0, seat, b;
+
+  genomeText(g, text);
+  strategyParse(&challenger, text);
+  initializePrototype(2, kingdom, &prototype);
+
+  while (n < maxGames) {
+    for (b = 0; b < EVOLVE_BATCH; b++, n += 2) {
+      for (seat = 0; seat < 2; seat++) {
+	seats[seat] = &challenger;
+	seats[1 - seat] = &champion;
+	engine->simulatePrototype(seats, &prototype, generationSeed + n / 2, SIMULATE_MAX_TURNS, &result);
+	points += result.winner == seat ? 1.0 : result.winner < 0 ? 0.5 : 0.0;
+      }
+    }
+    g->score = points / n;
+    g->z = (g->score - 0.5) / sqrt(0.25 / n);
+    if (fabs(g->z) >= EVOLVE_Z_STOP) {
+      break;
+    }
+  }
+  g->games = n;
+}
+
+
+static void *worker(void *arg) {
+  int i;
+  while ((i = __sync_fetch_and_add(&nextGenome, 1)) < populationSize) {
+    evaluate(&population[i]);
+  }
+  return NULL;
+}
+
+
+static int byScore(const void *a, const void *b) {
+  double d = ((const struct genome*)b)->score - ((const struct genome*)a)->score;
+  return d > 0 ? 1 : d < 0 ? -1 : 0;
+}
+
+
+//Better of two random genomes from the sorted population
+static const struct genome *tournament(unsigned int *rng) {
+  int a = rand_r(rng) % populationSize;
+  int b = rand_r(rng) % populationSize;
+  return &population[a < b ? a : b];
+}
+
+
+static void breed(struct genome *child, const struct genome *p1, const struct genome *p2, unsigned int *rng) {
+  int i, x;
+  memset(child, 0, sizeof(struct genome));
+  for (i = 0; i < NUM_GENES; i++) {
+    x = rand_r(rng) % 2 ? p1->gene[i] : p2->gene[i];
+    //Mutate about one gene per child, mostly by a single step
+    if (rand_r(rng) % NUM_GENES == 0) {
+      if (rand_r(rng) % 4 == 0) {
+	x = genes[i].low + rand_r(rng) % (genes[i].high - genes[i].low + 1);
+      }
+      else {
+	x += rand_r(rng) % 2 ? 1 : -1;
+      }
+    }
+    child->gene[i] = x < genes[i].low ? genes[i].low : x > genes[i].high ? genes[i].high : x;
+  }
+}
+
+
+static void printGenome(FILE *out, const char *tag, const struct genome *g) {
+  int i;
+  fprintf(out, "%s", tag);
+  for (i = 0; i < NUM_GENES; i++) {
+    fprintf(out, " %d", g->gene[i]);
+  }
+  fprintf(out, "\n");
+}
+
+
+static int readGenome(FILE *in, const char *tag, struct genome *g) {
+  char word[64];
+  int i;
+  memset(g, 0, sizeof(struct genome));
+  if (fscanf(in, "%63s", word) != 1 || strcmp(word, tag) != 0) {
+    return -1;
+  }
+  for (i = 0; i < NUM_GENES; i++) {
+    if (fscanf(in, "%d", &g->gene[i]) != 1) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+
+//Written to a temporary file and renamed, so a crash never leaves half a checkpoint
+static int saveCheckpoint(const char *path, int generation, int stall, unsigned int rng, const struct genome *best) {
+  char tmp[1024];
+  FILE *out;
+  int i;
+
+  snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+  out = fopen(tmp, "w");
+  if (out == NULL) {
+    return -1;
+  }
+  fprintf(out, "evolve %d %d %d %u %d %s\n", NUM_GENES, generation, stall, rng,
+	  populationSize, strategyCardId(actionCard));
+  printGenome(out, "champion", best);
+  for (i = 0; i < populationSize; i++) {
+    printGenome(out, "genome", &population[i]);
+  }
+  if (fclose(out) != 0) {
+    return -1;
+  }
+  return rename(tmp, path);
+}
+
+
+static int loadCheckpoint(const char *path, int *generation, int *stall, unsigned int *rng, struct genome *best) {
+  char card[64];
+  int numGenes, i;
+  FILE *in = fopen(path, "r");
+
+  if (in == NULL) {
+    return -1;
+  }
+  if (fscanf(in, "evolve %d %d %d %u %d %63s", &numGenes, generation, stall, rng, &populationSize, card) != 6
+      || numGenes != NUM_GENES || populationSize < EVOLVE_ELITE + 1 || populationSize > EVOLVE_MAX_POPULATION
+      || (actionCard = strategyCardNumber(card)) < 0 || readGenome(in, "champion", best) < 0) {
+    fclose(in);
+    return -1;
+  }
+  for (i = 0; i < populationSize; i++) {
+    if (readGenome(in, "genome", &population[i]) < 0) {
+      fclose(in);
+      return -1;
+    }
+  }
+  fclose(in);
+  return 0;
+}
+
+
+int main(int argc, char **argv) {
+  struct genome best, confirmed, next[EVOLVE_MAX_POPULATION];
+  char text[EVOLVE_TEXT_LENGTH];
+  const char *checkpoint = "evolve.ckpt";
+  pthread_t threads[64];
+  unsigned int rng = 1;
+  int threadCount = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  int generations = 50, patience = 5, resume = 0;
+  int generation = 0, stall = 0;
+  int i, a;
+
+  for (a = 1; a < argc; a++) {
+    if (strcmp(argv[a], "-r") == 0) {
+      resume = 1;
+    }
+    else if (a + 1 < argc && strcmp(argv[a], "-j") == 0) {
+      threadCount = atoi(argv[++a]);
+    }
+    else if (a + 1 < argc && strcmp(argv[a], "-p") == 0) {
+      populationSize = atoi(argv[++a]);
+    }
+    else if (a + 1 < argc && strcmp(argv[a], "-g") == 0) {
+      generations = atoi(argv[++a]);
+    }
+    else if (a + 1 < argc && strcmp(argv[a], "-m") == 0) {
+      maxGames = atoi(argv[++a]);
+    }
+    else if (a + 1 < argc && strcmp(argv[a], "-a") == 0) {
+      actionCard = strategyCardNumber(argv[++a]);
+    }
+    else if (a + 1 < argc && strcmp(argv[a], "-s") == 0) {
+      rng = (unsigned int)atoi(argv[++a]);
+    }
+    else if (a + 1 < argc && strcmp(argv[a], "-c") == 0) {
+      checkpoint = argv[++a];
+    }
+    else if (a + 1 < argc && strcmp(argv[a], "-patience") == 0) {
+      patience = atoi(argv[++a]);
+    }
+    else {
+      break;
+    }
+  }
+  if (a != argc || actionCard < 0 || populationSize < EVOLVE_ELITE + 1
+      || populationSize > EVOLVE_MAX_POPULATION || maxGames < 2 * EVOLVE_BATCH) {
+    printf("Usage: evolve [-j threads] [-p population] [-g generations] [-m maxGames]\n"
+	   "              [-a actionCard] [-s seed] [-c checkpointFile] [-patience n] [-r]\n");
+    return EXIT_SUCCESS;
+  }
+  if (threadCount < 1) {
+    threadCount = 1;
+  }
+  if (threadCount > 64) {
+    threadCount = 64;
+  }
+
+  if (resume) {
+    if (loadCheckpoint(checkpoint, &generation, &stall, &rng, &best) < 0) {
+      fprintf(stderr, "evolve: cannot resume from %s\n", checkpoint);
+      return EXIT_FAILURE;
+    }
+    printf("resumed %s at generation %d\n", checkpoint, generation);
+  }
+  else {
+    genomeStart(&best);
+    for (i = 0; i < populationSize; i++) {
+      breed(&population[i], &best, &best, &rng);
+    }
+    population[0] = best;
+  }
+
+  for (; generation < generations && stall < patience; generation++) {
+    genomeText(&best, text);
+    strategyParse(&champion, text);
+    generationSeed = 1 + (int)(((long long)generation * maxGames) % 1000000000);
+    nextGenome = 0;
+    for (i = 0; i < threadCount; i++) {
+      pthread_create(&threads[i], NULL, worker, NULL);
+    }
+    for (i = 0; i < threadCount; i++) {
+      pthread_join(threads[i], NULL);
+    }
+    qsort(population, populationSize, sizeof(struct genome), byScore);
+
+    //The best of many is flattered by its seeds; it has to win again on fresh ones
+    confirmed = population[0];
+    if (confirmed.z >= EVOLVE_Z_STOP) {
+      generationSeed = 1000000001 + generationSeed % 1000000000;
+      evaluate(&confirmed);
+    }
+    printf("gen %3d best %.3f z %+6.2f games %4d %s", generation, population[0].score,
+	   population[0].z, population[0].games,
+	   confirmed.z >= EVOLVE_Z_STOP ? "new champion:" : "champion holds:");
+    if (confirmed.z >= EVOLVE_Z_STOP) {
+      best = population[0];
+      stall = 0;
+    }
+    else {
+      stall++;
+    }
+    printGenome(stdout, "", &best);
+    fflush(stdout);
+
+    //Elites carry over (the champion always among them), the rest are bred
+    next[0] = best;
+    for (i = 1; i < EVOLVE_ELITE; i++) {
+      next[i] = population[i - 1];
+    }
+    for (; i < populationSize; i++) {
+      breed(&next[i], tournament(&rng), tournament(&rng), &rng);
+    }
+    memcpy(population, next, sizeof(struct genome) * populationSize);
+
+    if (saveCheckpoint(checkpoint, generation + 1, stall, rng, &best) < 0) {
+      perror(checkpoint);
+    }
+  }
+
+  printf("%s after %d generation(s); champion strategy:\n",
+	 stall >= patience ? "converged" : "stopped", generation);
+  genomeText(&best, text);
+  printf("%s", text);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,112 @@
+/* 	Feature Vectors
+*/
+
+#include <string.h>
+#include "featurevec.h"
+
+
+static void countCards(const int *cards, int count, short histogram[FEATURE_CARDS]) {
+  int i;
+  for (i = 0; i < count; i++) {
+    if (cards[i] >= 0 && cards[i] < FEATURE_CARDS) {
+      histogram[cards[i]]++;
+    }
+  }
+}
+
+
+//One row in shorts, wide enough for any count before it is narrowed
+static int buildRow(const struct gameState *state, int perspective, int turn, short row[FEATURE_STRIDE]) {
+  int n = state->numPlayers;
+  int seat, p, c;
+  short *histogram, *scalars = row + FEATURE_SCALARS;
+
+  if (n < 2 || n > MAX_PLAYERS || perspective < 0 || perspective >= n) {
+    return -1;
+  }
+  memset(row, 0, sizeof(short) * FEATURE_STRIDE);
+
+  for (seat = 0; seat < n; seat++) {
+    p = (perspective + seat) % n;
+    histogram = row + FEATURE_HISTOGRAM + seat * FEATURE_CARDS;
+    countCards(state->hand[p], state->handCount[p], histogram);
+    countCards(state->deck[p], state->deckCount[p], histogram);
+    countCards(state->discard[p], state->discardCount[p], histogram);
+    if (p == state->whoseTurn) {
+      countCards(state->playedCards, state->playedCardCount, histogram);
+    }
+  }
+  countCards(state->hand[perspective], state->handCount[perspective], row + FEATURE_HAND);
+  for (c = 0; c < FEATURE_CARDS; c++) {
+    row[FEATURE_SUPPLY + c] = state->supplyCount[c];
+    row[FEATURE_EMBARGO + c] = state->embargoTokens[c];
+  }
+
+  scalars[FEATURE_TO_MOVE] = (state->whoseTurn - perspective + n) % n;
+  scalars[FEATURE_PLAYERS] = n;
+  scalars[FEATURE_PHASE] = state->phase;
+  scalars[FEATURE_ACTIONS] = state->numActions;
+  scalars[FEATURE_BUYS] = state->numBuys;
+  scalars[FEATURE_COINS] = state->coins;
+  scalars[FEATURE_TURN] = turn > 32767 ? 32767 : turn;
+  scalars[FEATURE_OUTPOST] = state->outpostPlayed;
+  return 0;
+}
+
+
+int featuresInt8(const struct gameState states[], int count, const int perspective[],
+		 const int turns[], signed char *out) {
+  short row[FEATURE_STRIDE];
+  int i, j, v;
+
+  for (i = 0; i < count; i++, out += FEATURE_STRIDE) {
+    if (buildRow(&states[i], perspective ? perspective[i] : states[i].whoseTurn,
+		 turns ? turns[i] : 0, row) == -1) {
+      return -1;
+    }
+    //A plain saturating narrow, which the compiler turns into packed instructions
+    for (j = 0; j < FEATURE_STRIDE; j++) {
+      v = row[j];
+      out[j] = (signed char)(v > 127 ? 127 : v < -128 ? -128 : v);
+    }
+  }
+  return 0;
+}
+
+
+int featuresFloat(const struct gameState states[], int count, const int perspective[],
+		  const int turns[], float *out) {
+  short row[FEATURE_STRIDE];
+  int i, j;
+
+  for (i = 0; i < count; i++, out += FEATURE_STRIDE) {
+    if (buildRow(&states[i], perspective ? perspective[i] : states[i].whoseTurn,
+		 turns ? turns[i] : 0, row) == -1) {
+      return -1;
+    }
+    for (j = 0; j < FEATURE_STRIDE; j++) {
+      out[j] = row[j];
+    }
+  }
+  return 0;
+}
+
+
+static signed char addSaturated(signed char value, int delta) {
+  int v = value + delta;
+  return (signed char)(v > 127 ? 127 : v < -128 ? -128 : v);
+}
+
+
+void featuresAfterBuy(const signed char *row, int card, int cost, signed char *out) {
+  signed char *scalars = out + FEATURE_SCALARS;
+
+  if (out != row) {
+    memcpy(out, row, FEATURE_STRIDE);
+  }
+  out[FEATURE_HISTOGRAM + card] = addSaturated(out[FEATURE_HISTOGRAM + card], 1);
+  out[FEATURE_SUPPLY + card] = addSaturated(out[FEATURE_SUPPLY + card], -1);
+  scalars[FEATURE_BUYS] = addSaturated(scalars[FEATURE_BUYS], -1);
+  scalars[FEATURE_COINS] = addSaturated(scalars[FEATURE_COINS], -cost);
+  scalars[FEATURE_PHASE] = 1;	//buyCard() moves the game to the buy phase
+}
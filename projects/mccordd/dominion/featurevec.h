@@ -0,0 +1,71 @@
+/* 	Feature Vectors
+
+	Fixed-layout features of game states for training and running value
+	networks, written for a whole batch straight into a caller's buffer.
+	One row per state, FEATURE_STRIDE entries long, seen from one
+	player's seat (seat 0 below; the others follow in turn order):
+
+	    FEATURE_CARDS	histogram of each seat's cards: hand, deck,
+			x	discard, and the table for the seat whose
+	    MAX_PLAYERS		turn it is; empty seats are zero
+	    FEATURE_CARDS	the perspective player's hand alone
+	    FEATURE_CARDS	supply counts, -1 for cards not in the game
+	    FEATURE_CARDS	embargo tokens
+	    8			scalars, see enum FEATURE_SCALAR
+	    padding		zero, up to FEATURE_STRIDE
+
+	FEATURE_STRIDE is a multiple of 64 entries, so each row starts on a
+	cache line (and any vector width) when the buffer does, and a batch
+	is one contiguous [count][FEATURE_STRIDE] array.  The int8 version
+	saturates at -128..127; the float version holds the same values
+	unscaled.  Nothing is allocated, and the states are only read.
+*/
+
+#ifndef _FEATUREVEC_H
+#define _FEATUREVEC_H
+
+#include "dominion.h"
+
+#define FEATURE_CARDS (treasure_map + 1)
+
+enum FEATURE_OFFSET {
+  FEATURE_HISTOGRAM = 0,
+  FEATURE_HAND = FEATURE_HISTOGRAM + MAX_PLAYERS * FEATURE_CARDS,
+  FEATURE_SUPPLY = FEATURE_HAND + FEATURE_CARDS,
+  FEATURE_EMBARGO = FEATURE_SUPPLY + FEATURE_CARDS,
+  FEATURE_SCALARS = FEATURE_EMBARGO + FEATURE_CARDS,
+  FEATURE_USED = FEATURE_SCALARS + 8
+};
+
+//Entries at FEATURE_SCALARS + one of these
+enum FEATURE_SCALAR {
+  FEATURE_TO_MOVE = 0,	//seat whose turn it is, relative to the perspective player
+  FEATURE_PLAYERS,
+  FEATURE_PHASE,
+  FEATURE_ACTIONS,
+  FEATURE_BUYS,
+  FEATURE_COINS,
+  FEATURE_TURN,		//from the caller; gameState has no turn counter
+  FEATURE_OUTPOST	//outpostPlayed
+};
+
+#define FEATURE_STRIDE ((FEATURE_USED + 63) / 64 * 64)
+
+int featuresInt8(const struct gameState states[], int count, const int perspective[],
+		 const int turns[], signed char *out);
+int featuresFloat(const struct gameState states[], int count, const int perspective[],
+		  const int turns[], float *out);
+/* Write count rows of FEATURE_STRIDE entries to out for states[0..count-1].
+   perspective[i] is the seat row i is seen from, whoseTurn if perspective
+   is NULL; turns[i] its turn number, 0 if turns is NULL.  Returns -1,
+   writing nothing more, at the first state with a bad player count or
+   perspective */
+
+void featuresAfterBuy(const signed char *row, int card, int cost, signed char *out);
+/* out = the int8 row as it would be after the perspective player, whose
+   turn it is, buys card for cost: one more of card in their histogram,
+   one less in the supply, a buy and cost coins spent.  Cheaper than
+   buying on a copy of the state and featurizing it again, and the same
+   row unless a count saturates.  row and out may be the same */
+
+#endif
@@ -0,0 +1,513 @@
+/* 	Dominion Engine Fuzzer
+
+	Decodes a byte stream into a legal initializeGame() call followed by a
+	sequence of playCard/buyCard/endTurn actions (plus gaining a supply card
+	straight to hand, so card effects are reachable from any turn) and
+	checks the engine
+	invariants after every step:
+	  - no negative or oversized hand/deck/discard/played counts
+	  - every card held by a player is a real card
+	  - supply piles never drop below -1 (not in game)
+	  - whoseTurn and phase stay in range
+	  - no card type is ever created: per type, supply + every player's
+	    cards + played cards never exceeds the count at the start of the game
+
+	LLVMFuzzerTestOneInput() is the libFuzzer entry point (make
+	libfuzzdominion, clang only).  Built with -DFUZZ_STANDALONE (make
+	fuzzdominion) the same harness gets its own driver: gcc's
+	-fsanitize-coverage=trace-pc edges guide a mutator, one forked worker
+	per core shares a corpus directory, and inputs that crash, hang or
+	break an invariant are copied into a crash directory.  Each worker
+	keeps the input it is running in a slot of memory shared with the
+	parent, so nothing is written per run; the parent saves the slot of
+	any worker that dies by a signal or exits nonzero (a sanitizer
+	report).
+
+	Usage:	fuzzdominion [-j workers] [-runs n] corpusDir crashDir
+		fuzzdominion input...		(replay)
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "dominion.h"
+#include "dominion_helpers.h"
+
+#define FUZZ_MAX_ACTIONS 256
+#define FUZZ_NUM_KINGDOM (treasure_map - adventurer + 1)
+
+struct fuzzInput {
+  const uint8_t *data;
+  size_t size;
+  size_t pos;
+};
+
+static uint8_t nextByte(struct fuzzInput *in) {
+  if (in->pos >= in->size)
+    return 0;
+  return in->data[in->pos++];
+}
+
+static int nextInt(struct fuzzInput *in, int range) {
+  int v = nextByte(in);
+  v = (v << 8) | nextByte(in);
+  return v % range;
+}
+
+static void fuzzFail(const char *what, struct gameState *state) {
+  fprintf(stderr, "INVARIANT VIOLATED: %s (player %d, phase %d)\n",
+	  what, state->whoseTurn, state->phase);
+  abort();
+}
+
+//Per card type: supply + all player cards + played cards
+static void countCards(struct gameState *state, int totals[treasure_map+1]) {
+  int i, p;
+
+  memset(totals, 0, sizeof(int) * (treasure_map+1));
+  for (i = 0; i <= treasure_map; i++) {
+    if (state->supplyCount[i] > 0)
+      totals[i] += state->supplyCount[i];
+  }
+  for (p = 0; p < state->numPlayers; p++) {
+    for (i = 0; i < state->handCount[p]; i++)
+      totals[state->hand[p][i]]++;
+    for (i = 0; i < state->deckCount[p]; i++)
+      totals[state->deck[p][i]]++;
+    for (i = 0; i < state->discardCount[p]; i++)
+      totals[state->discard[p][i]]++;
+  }
+  for (i = 0; i < state->playedCardCount; i++)
+    totals[state->playedCards[i]]++;
+}
+
+static int validCard(int card) {
+  return card >= curse && card <= treasure_map;
+}
+
+static void checkInvariants(struct gameState *state, int start[treasure_map+1]) {
+  int i, p;
+  int now[treasure_map+1];
+
+  if (state->whoseTurn < 0 || state->whoseTurn >= state->numPlayers)
+    fuzzFail("whoseTurn out of range", state);
+  if (state->phase < 0 || state->phase > 2)
+    fuzzFail("phase out of range", state);
+  if (state->playedCardCount < 0 || state->playedCardCount > MAX_DECK)
+    fuzzFail("playedCardCount out of range", state);
+  for (i = 0; i <= treasure_map; i++) {
+    if (state->supplyCount[i] < -1)
+      fuzzFail("negative supply count", state);
+  }
+  for (p = 0; p < state->numPlayers; p++) {
+    if (state->handCount[p] < 0 || state->handCount[p] > MAX_HAND)
+      fuzzFail("handCount out of range", state);
+    if (state->deckCount[p] < 0 || state->deckCount[p] > MAX_DECK)
+      fuzzFail("deckCount out of range", state);
+    if (state->discardCount[p] < 0 || state->discardCount[p] > MAX_DECK)
+      fuzzFail("discardCount out of range", state);
+    for (i = 0; i < state->handCount[p]; i++)
+      if (!validCard(state->hand[p][i]))
+	fuzzFail("invalid card in hand", state);
+    for (i = 0; i < state->deckCount[p]; i++)
+      if (!validCard(state->deck[p][i]))
+	fuzzFail("invalid card in deck", state);
+    for (i = 0; i < state->discardCount[p]; i++)
+      if (!validCard(state->discard[p][i]))
+	fuzzFail("invalid card in discard", state);
+  }
+  for (i = 0; i < state->playedCardCount; i++)
+    if (!validCard(state->playedCards[i]))
+      fuzzFail("invalid played card", state);
+
+  countCards(state, now);
+  for (i = 0; i <= treasure_map; i++) {
+    if (now[i] > start[i])
+      fuzzFail("card created from nothing", state);
+  }
+}
+
+//Choices are hand positions, supply positions or small flags depending on
+//the card, so draw them from -1 up to the larger of the two ranges
+static int nextChoice(struct fuzzInput *in, struct gameState *state) {
+  int range = state->handCount[state->whoseTurn];
+  if (range < treasure_map + 1)
+    range = treasure_map + 1;
+  return nextInt(in, range + 1) - 1;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  struct fuzzInput in = { data, size, 0 };
+  struct gameState state;
+  int pool[FUZZ_NUM_KINGDOM];
+  int k[10];
+  int start[treasure_map+1];
+  int numPlayers, seed, i, j, t, step;
+  int handPos, c1, c2, c3;
+
+  numPlayers = 2 + nextByte(&in) % (MAX_PLAYERS - 1);
+  seed = 1 + nextInt(&in, 65535);
+
+  //Partial Fisher-Yates over the kingdom cards keeps the ten distinct
+  for (i = 0; i < FUZZ_NUM_KINGDOM; i++)
+    pool[i] = adventurer + i;
+  for (i = 0; i < 10; i++) {
+    j = i + nextByte(&in) % (FUZZ_NUM_KINGDOM - i);
+    t = pool[i];
+    pool[i] = pool[j];
+    pool[j] = t;
+    k[i] = pool[i];
+  }
+
+  memset(&state, 0, sizeof(struct gameState));
+  if (initializeGame(numPlayers, k, seed, &state) != 0)
+    return 0;
+  countCards(&state, start);
+  checkInvariants(&state, start);
+
+  for (step = 0; step < FUZZ_MAX_ACTIONS && in.pos < in.size; step++) {
+    if (isGameOver(&state))
+      break;
+
+    switch (nextByte(&in) % 4) {
+    case 0:
+      if (state.handCount[state.whoseTurn] < 1)
+	continue;
+      handPos = nextInt(&in, state.handCount[state.whoseTurn]);
+      c1 = nextChoice(&in, &state);
+      c2 = nextChoice(&in, &state);
+      c3 = nextChoice(&in, &state);
+      playCard(handPos, c1, c2, c3, &state);
+      break;
+    case 1:
+      buyCard(nextByte(&in) % (treasure_map + 1), &state);
+      break;
+    case 2:
+      //Like the interactive "add" command, but taken from the supply so
+      //card conservation still holds
+      gainCard(nextByte(&in) % (treasure_map + 1), &state, 2, state.whoseTurn);
+      break;
+    default:
+      endTurn(&state);
+      break;
+    }
+    checkInvariants(&state, start);
+  }
+
+  return 0;
+}
+
+
+#ifdef FUZZ_STANDALONE
+
+#include <unistd.h>
+#include <signal.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#define FUZZ_MAP_SIZE 65536
+#define FUZZ_MAX_INPUT 1024
+#define FUZZ_MAX_CORPUS 4096
+#define FUZZ_TIMEOUT 2		//seconds before an input counts as a hang
+#define FUZZ_RESCAN 1000	//runs between rereads of the shared corpus
+#define FUZZ_MAX_RESTARTS 100	//stop replacing dead workers after this many
+
+//The input a worker is running, in memory shared with the parent
+struct inputSlot {
+  size_t size;
+  uint8_t data[FUZZ_MAX_INPUT];
+};
+
+static uint8_t edgeMap[FUZZ_MAP_SIZE];	 //edges hit by the current input
+static uint8_t seenMap[FUZZ_MAP_SIZE];	 //edges hit by anything so far
+static uintptr_t prevLocation;
+
+//Read by AddressSanitizer at startup: abort on an error, so a report
+//ends the worker with SIGABRT rather than exit status 1
+const char* __asan_default_options(void) {
+  return "abort_on_error=1";
+}
+
+//Called by gcc at every basic block of files built with
+//-fsanitize-coverage=trace-pc (only dominion.c is)
+void __sanitizer_cov_trace_pc(void) {
+  uintptr_t loc = (uintptr_t)__builtin_return_address(0);
+  loc = (loc >> 4) ^ (loc << 8);
+  edgeMap[(loc ^ prevLocation) % FUZZ_MAP_SIZE] = 1;
+  prevLocation = loc >> 1;
+}
+
+struct corpusEntry {
+  uint8_t *data;
+  size_t size;
+};
+
+static struct corpusEntry corpus[FUZZ_MAX_CORPUS];
+static int corpusCount = 0;
+static unsigned long fuzzRng = 88172645463325252UL;
+
+static unsigned long fuzzRand(void) {
+  fuzzRng ^= fuzzRng << 13;
+  fuzzRng ^= fuzzRng >> 7;
+  fuzzRng ^= fuzzRng << 17;
+  return fuzzRng;
+}
+
+static size_t readFile(const char *path, uint8_t *buf, size_t max) {
+  size_t n;
+  FILE *f = fopen(path, "rb");
+  if (f == NULL)
+    return 0;
+  n = fread(buf, 1, max, f);
+  fclose(f);
+  return n;
+}
+
+static void writeFile(const char *path, const uint8_t *buf, size_t n) {
+  FILE *f = fopen(path, "wb");
+  if (f == NULL)
+    return;
+  fwrite(buf, 1, n, f);
+  fclose(f);
+}
+
+static unsigned long hashInput(const uint8_t *buf, size_t n) {
+  unsigned long h = 14695981039346656037UL;
+  size_t i;
+  for (i = 0; i < n; i++)
+    h = (h ^ buf[i]) * 1099511628211UL;
+  return h;
+}
+
+static int addCorpus(const uint8_t *buf, size_t n) {
+  if (corpusCount >= FUZZ_MAX_CORPUS)
+    return -1;
+  corpus[corpusCount].data = malloc(n ? n : 1);
+  if (corpus[corpusCount].data == NULL)
+    return -1;
+  memcpy(corpus[corpusCount].data, buf, n);
+  corpus[corpusCount].size = n;
+  corpusCount++;
+  return 0;
+}
+
+//Reload the corpus directory so each worker picks up what the others found
+static void loadCorpus(const char *dir) {
+  DIR *d;
+  struct dirent *e;
+  char path[4096];
+  uint8_t buf[FUZZ_MAX_INPUT];
+  size_t n;
+
+  while (corpusCount > 0)
+    free(corpus[--corpusCount].data);
+  d = opendir(dir);
+  if (d == NULL)
+    return;
+  while ((e = readdir(d)) != NULL) {
+    if (e->d_name[0] == '.')
+      continue;
+    snprintf(path, sizeof(path), "%s/%s", dir, e->d_name);
+    n = readFile(path, buf, sizeof(buf));
+    if (addCorpus(buf, n) < 0)
+      break;
+  }
+  closedir(d);
+}
+
+static size_t mutate(uint8_t *buf, size_t n) {
+  int ops = 1 + fuzzRand() % 4;
+  size_t i;
+
+  while (ops-- > 0) {
+    switch (fuzzRand() % 4) {
+    case 0:	//flip a bit
+      if (n > 0)
+	buf[fuzzRand() % n] ^= 1 << (fuzzRand() % 8);
+      break;
+    case 1:	//random byte
+      if (n > 0)
+	buf[fuzzRand() % n] = fuzzRand();
+      break;
+    case 2:	//insert a byte
+      if (n < FUZZ_MAX_INPUT) {
+	i = n ? fuzzRand() % n : 0;
+	memmove(buf + i + 1, buf + i, n - i);
+	buf[i] = fuzzRand();
+	n++;
+      }
+      break;
+    default:	//drop a byte
+      if (n > 1) {
+	i = fuzzRand() % n;
+	memmove(buf + i, buf + i + 1, n - i - 1);
+	n--;
+      }
+      break;
+    }
+  }
+  return n;
+}
+
+static int newCoverage(void) {
+  int i, found = 0;
+  for (i = 0; i < FUZZ_MAP_SIZE; i++) {
+    if (edgeMap[i] && !seenMap[i]) {
+      seenMap[i] = 1;
+      found = 1;
+    }
+  }
+  return found;
+}
+
+static void runWorker(int id, long runs, const char *corpusDir, struct inputSlot *slot) {
+  uint8_t buf[FUZZ_MAX_INPUT];
+  char path[4096];
+  size_t n;
+  long r;
+  int e;
+
+  fuzzRng ^= (unsigned long)getpid() * 2654435761UL + id;
+  loadCorpus(corpusDir);
+
+  //Rebuild the coverage map from what is already in the corpus
+  for (e = 0; e < corpusCount; e++) {
+    memset(edgeMap, 0, sizeof(edgeMap));
+    prevLocation = 0;
+    LLVMFuzzerTestOneInput(corpus[e].data, corpus[e].size);
+    newCoverage();
+  }
+
+  for (r = 0; r < runs; r++) {
+    if (r % FUZZ_RESCAN == FUZZ_RESCAN - 1)
+      loadCorpus(corpusDir);
+
+    if (corpusCount > 0) {
+      e = fuzzRand() % corpusCount;
+      n = corpus[e].size;
+      memcpy(buf, corpus[e].data, n);
+    }
+    else {
+      n = 16 + fuzzRand() % 48;
+      for (e = 0; e < (int)n; e++)
+	buf[e] = fuzzRand();
+    }
+    n = mutate(buf, n);
+
+    //Leave the input where the parent can find it if we die running it
+    memcpy(slot->data, buf, n);
+    slot->size = n;
+    memset(edgeMap, 0, sizeof(edgeMap));
+    prevLocation = 0;
+    alarm(FUZZ_TIMEOUT);
+    LLVMFuzzerTestOneInput(buf, n);
+    alarm(0);
+
+    if (newCoverage()) {
+      snprintf(path, sizeof(path), "%s/%016lx", corpusDir, hashInput(buf, n));
+      writeFile(path, buf, n);
+      addCorpus(buf, n);
+    }
+  }
+  exit(0);
+}
+
+static void replay(int argc, char **argv) {
+  uint8_t buf[FUZZ_MAX_INPUT];
+  size_t n;
+  int i;
+
+  for (i = 1; i < argc; i++) {
+    n = readFile(argv[i], buf, sizeof(buf));
+    printf("%s: %lu bytes\n", argv[i], (unsigned long)n);
+    LLVMFuzzerTestOneInput(buf, n);
+  }
+}
+
+int main(int argc, char **argv) {
+  int workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  long runs = 100000;
+  long perWorker;
+  int argi = 1;
+  int i, status, crashes = 0;
+  pid_t pid, *pids;
+  struct inputSlot *slots;
+  char crashPath[4096];
+  const char *corpusDir, *crashDir;
+  const char *kind;
+
+  while (argi < argc && argv[argi][0] == '-') {
+    if (strcmp(argv[argi], "-j") == 0 && argi + 1 < argc)
+      workers = atoi(argv[++argi]);
+    else if (strcmp(argv[argi], "-runs") == 0 && argi + 1 < argc)
+      runs = atol(argv[++argi]);
+    argi++;
+  }
+
+  if (argc - argi != 2) {
+    if (argc - argi < 1) {
+      printf("Usage: fuzzdominion [-j workers] [-runs n] corpusDir crashDir\n");
+      printf("       fuzzdominion input...\n");
+      return EXIT_SUCCESS;
+    }
+    replay(argc - argi + 1, argv + argi - 1);
+    return EXIT_SUCCESS;
+  }
+  corpusDir = argv[argi];
+  crashDir = argv[argi + 1];
+  mkdir(corpusDir, 0755);
+  mkdir(crashDir, 0755);
+
+  if (workers < 1)
+    workers = 1;
+  perWorker = runs / workers;
+  pids = calloc(workers, sizeof(pid_t));
+  slots = mmap(NULL, workers * sizeof(struct inputSlot), PROT_READ | PROT_WRITE,
+	       MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (pids == NULL || slots == MAP_FAILED) {
+    perror("fuzzdominion");
+    return EXIT_FAILURE;
+  }
+
+  for (i = 0; i < workers; i++) {
+    pids[i] = fork();
+    if (pids[i] == 0)
+      runWorker(i, perWorker, corpusDir, &slots[i]);
+  }
+
+  //Collect workers; one that dies leaves its input behind in its slot
+  while ((pid = wait(&status)) > 0) {
+    for (i = 0; i < workers && pids[i] != pid; i++)
+      ;
+    if (i == workers || (WIFEXITED(status) && WEXITSTATUS(status) == 0))
+      continue;
+
+    kind = WIFSIGNALED(status) && WTERMSIG(status) == SIGALRM ? "hang" : "crash";
+    snprintf(crashPath, sizeof(crashPath), "%s/%s-%016lx", crashDir,
+	     kind, hashInput(slots[i].data, slots[i].size));
+    writeFile(crashPath, slots[i].data, slots[i].size);
+    if (WIFSIGNALED(status))
+      printf("worker %d: signal %d, input saved to %s\n", i, WTERMSIG(status), crashPath);
+    else
+      printf("worker %d: exit status %d, input saved to %s\n", i, WEXITSTATUS(status), crashPath);
+    crashes++;
+
+    //Give the slot a fresh worker so the run keeps going
+    if (crashes >= FUZZ_MAX_RESTARTS)
+      continue;
+    pids[i] = fork();
+    if (pids[i] == 0)
+      runWorker(i, perWorker, corpusDir, &slots[i]);
+  }
+
+  printf("fuzzing finished: %d crash(es) saved in %s\n", crashes, crashDir);
+  munmap(slots, workers * sizeof(struct inputSlot));
+  free(pids);
+  return EXIT_SUCCESS;
+}
+
+#endif
@@ -11,68 +11,31 @@ Sam Heinith CS362
 #include "rngs.h"
 #include "interface.h"
 #include "dominion.h"
+#include "strategy.h"
 
 
-void cardNumToName(int card, char *name){
-  switch(card){
-  case curse: strcpy(name,"Curse");
-    break;
-  case estate: strcpy(name,"Estate");
-    break;
-  case duchy: strcpy(name,"Duchy");
-    break;
-  case province: strcpy(name,"Province");
-    break;
-  case copper: strcpy(name,"Copper");
-    break;
-  case silver: strcpy(name,"Silver");
-    break;
-  case gold: strcpy(name,"Gold");
-    break;
-  case adventurer: strcpy(name,"Adventurer");
-    break;
-  case council_room: strcpy(name,"Council Room");
-    break;
-  case feast: strcpy(name,"Feast");
-    break;
-  case gardens: strcpy(name,"Gardens");
-    break;
-  case mine: strcpy(name,"Mine");
-    break;
-  case remodel: strcpy(name,"Remodel");
-    break;
-  case smithy: strcpy(name,"Smithy");
-    break;
-  case village: strcpy(name,"Village");
-    break;
-  case baron: strcpy(name,"Baron");
-    break;
-  case great_hall: strcpy(name,"Great Hall");
-    break;
-  case minion: strcpy(name,"Minion");
-    break;
-  case steward: strcpy(name,"Steward");
-    break;
-  case tribute: strcpy(name,"Tribute");
-    break;
-  case ambassador: strcpy(name,"Ambassador");
-    break;
-  case cutpurse: strcpy(name,"Cutpurse");
-    break;
-  case embargo: strcpy(name,"Embargo");
-    break;
-  case outpost: strcpy(name,"Outpost");
-    break;
-  case salvager: strcpy(name,"Salvager");
-    break;
-  case sea_hag: strcpy(name,"Sea Hag");
-    break;
-  case treasure_map: strcpy(name,"Treasure Map");
-    break;
+//Indexed by card number, in enum CARD order
+static const char *cardNames[NUM_TOTAL_K_CARDS] = {
+  "Curse", "Estate", "Duchy", "Province", "Copper", "Silver", "Gold",
+  "Adventurer", "Council Room", "Feast", "Gardens", "Mine", "Remodel",
+  "Smithy", "Village", "Baron", "Great Hall", "Minion", "Steward",
+  "Tribute", "Ambassador", "Cutpurse", "Embargo", "Outpost", "Salvager",
+  "Sea Hag", "Treasure Map"
+};
+
+static const char *phaseNames[] = { "Action", "Buy", "Cleanup" };
+
+static int printMode = PRINT_HUMAN;
 
-  default: strcpy(name,"?");
-  }
 
+const char *cardName(int card) {
+  if(card < curse || card >= NUM_TOTAL_K_CARDS) return "?";
+  return cardNames[card];
+}
+
+
+void cardNumToName(int card, char *name){
+  strcpy(name, cardName(card));
 }
 
 
@@ -144,103 +107,234 @@ int getCardCost(int card) {
 
 
 
-void printHand(int player, struct gameState *game) {
-  int handCount = game->handCount[player];
-  int handIndex;
-  printf("Player %d's hand:\n", player);
-  if(handCount > 0) printf("#  Card\n");
-  for(handIndex = 0; handIndex < handCount; handIndex++) {
-    int card = game->hand[player][handIndex];
-    char name[MAX_STRING_LENGTH];
-    cardNumToName(card, name);
-    printf("%-2d %-13s\n", handIndex, name);
-  }
-  printf("\n");
+void printBufferInit(struct printBuffer *buffer, char *data, int size, int mode) {
+  buffer->data = data;
+  buffer->size = size;
+  buffer->length = 0;
+  buffer->overflow = 0;
+  buffer->mode = mode;
 }
 
 
-
-void printDeck(int player, struct gameState *game) {
-  int deckCount = game->deckCount[player];
-  int deckIndex;
-  printf("Player %d's deck: \n", player);
-  if(deckCount > 0) printf("#  Card\n");
-  for(deckIndex = 0; deckIndex < deckCount; deckIndex++) {
-    int card = game->deck[player][deckIndex];
-    char name[MAX_STRING_LENGTH];
-    cardNumToName(card, name);
-    printf("%-2d %-13s\n", deckIndex, name);
+int printBufferFlush(struct printBuffer *buffer, FILE *out) {
+  int status = SUCCESS;
+  if(buffer->length > 0 && fwrite(buffer->data, 1, buffer->length, out) != (size_t)buffer->length) {
+    status = FAILURE;
+  }
+  //Say so in the output itself, so a cut-short listing is never silent
+  if(buffer->overflow > 0) {
+    fprintf(out, buffer->mode == PRINT_COMPACT ? "dropped bytes=%d\n" : "[%d bytes of output dropped]\n",
+	    buffer->overflow);
+    status = FAILURE;
   }
-  printf("\n");
+  buffer->length = 0;
+  buffer->overflow = 0;
+  return status;
 }
 
-void printPlayed(int player, struct gameState *game) {
-  int playedCount = game->playedCardCount;
-  int playedIndex;
-  printf("Player %d's played cards: \n", player);
-  if(playedCount > 0) printf("#  Card\n");
-  for(playedIndex = 0; playedIndex < playedCount; playedIndex++) {
-    int card = game->playedCards[playedIndex];
-    char name[MAX_STRING_LENGTH];
-    cardNumToName(card, name);
-    printf("%-2d %-13s \n", playedIndex, name);
+
+//Append text left justified in a field of width characters, like %-*s
+static void putText(struct printBuffer *buffer, const char *text, int width) {
+  int length = strlen(text);
+  int padding = width > length ? width - length : 0;
+  if(buffer->length + length + padding > buffer->size) {
+    buffer->overflow += length + padding;
+    return;
   }
-  printf("\n");
+  memcpy(buffer->data + buffer->length, text, length);
+  memset(buffer->data + buffer->length + length, ' ', padding);
+  buffer->length += length + padding;
 }
 
 
+//Append a number left justified in a field of width characters, like %-*d
+static void putNumber(struct printBuffer *buffer, int number, int width) {
+  char digits[16];
+  char *start = digits + sizeof(digits) - 1;
+  unsigned int magnitude = number < 0 ? 0u - (unsigned int)number : (unsigned int)number;
+  *start = '\0';
+  do {
+    *--start = '0' + magnitude % 10;
+    magnitude /= 10;
+  } while(magnitude > 0);
+  if(number < 0) *--start = '-';
+  putText(buffer, start, width);
+}
 
-void printDiscard(int player, struct gameState *game) {
-  int discardCount = game->discardCount[player];
-  int discardIndex;
-  printf("Player %d's discard: \n", player);
-  if(discardCount > 0) printf("#  Card\n");
-  for(discardIndex = 0; discardIndex < discardCount; discardIndex++) {
-    int card = game->discard[player][discardIndex];
-    char name[MAX_STRING_LENGTH];
-    cardNumToName(card, name);
-    printf("%-2d %-13s \n", discardIndex, name);
+
+//Human: a numbered table under a title.  Compact: "tag p=N cards=a,b,c"
+static void formatCards(struct printBuffer *buffer, int player, const char *title, const char *tag,
+			const char *rowEnd, const int *cards, int count) {
+  int index;
+  if(buffer->mode == PRINT_COMPACT) {
+    putText(buffer, tag, 0);
+    putText(buffer, " p=", 0);
+    putNumber(buffer, player, 0);
+    putText(buffer, " cards=", 0);
+    for(index = 0; index < count; index++) {
+      if(index > 0) putText(buffer, ",", 0);
+      putNumber(buffer, cards[index], 0);
+    }
+    putText(buffer, "\n", 0);
+    return;
   }
-  printf("\n");
+  putText(buffer, "Player ", 0);
+  putNumber(buffer, player, 0);
+  putText(buffer, title, 0);
+  if(count > 0) putText(buffer, "#  Card\n", 0);
+  for(index = 0; index < count; index++) {
+    putNumber(buffer, index, 2);
+    putText(buffer, " ", 0);
+    putText(buffer, cardName(cards[index]), 13);
+    putText(buffer, rowEnd, 0);
+  }
+  putText(buffer, "\n", 0);
 }
 
 
+void formatHand(struct printBuffer *buffer, int player, struct gameState *game) {
+  formatCards(buffer, player, "'s hand:\n", "hand", "\n",
+	      game->hand[player], game->handCount[player]);
+}
 
 
-void printSupply(struct gameState *game) {
-  int cardNum, cardCost, cardCount;
-  char name[MAX_STRING_LENGTH];
-  printf("#   Card          Cost   Copies\n");
+void formatDeck(struct printBuffer *buffer, int player, struct gameState *game) {
+  formatCards(buffer, player, "'s deck: \n", "deck", "\n",
+	      game->deck[player], game->deckCount[player]);
+}
+
+
+void formatDiscard(struct printBuffer *buffer, int player, struct gameState *game) {
+  formatCards(buffer, player, "'s discard: \n", "discard", " \n",
+	      game->discard[player], game->discardCount[player]);
+}
+
+
+void formatPlayed(struct printBuffer *buffer, int player, struct gameState *game) {
+  formatCards(buffer, player, "'s played cards: \n", "played", " \n",
+	      game->playedCards, game->playedCardCount);
+}
+
+
+void formatSupply(struct printBuffer *buffer, struct gameState *game) {
+  int cardNum, cardCount, listed = 0;
+  if(buffer->mode == PRINT_COMPACT) {
+    putText(buffer, "supply", 0);
+  } else {
+    putText(buffer, "#   Card          Cost   Copies\n", 0);
+  }
   for(cardNum = 0; cardNum < NUM_TOTAL_K_CARDS; cardNum++){
     cardCount = game->supplyCount[cardNum];
     if(cardCount == -1) continue;
-    cardNumToName(cardNum, name);
-    cardCost = getCardCost(cardNum);
-    printf("%-2d  %-13s %-5d  %-5d", cardNum, name, cardCost, cardCount);
-    printf("\n");
+    if(buffer->mode == PRINT_COMPACT) {
+      putText(buffer, listed++ ? "," : " ", 0);
+      putNumber(buffer, cardNum, 0);
+      putText(buffer, ":", 0);
+      putNumber(buffer, cardCount, 0);
+      continue;
+    }
+    putNumber(buffer, cardNum, 2);
+    putText(buffer, "  ", 0);
+    putText(buffer, cardName(cardNum), 13);
+    putText(buffer, " ", 0);
+    putNumber(buffer, getCardCost(cardNum), 5);
+    putText(buffer, "  ", 0);
+    putNumber(buffer, cardCount, 5);
+    putText(buffer, "\n", 0);
   }
-  printf("\n");
+  putText(buffer, "\n", 0);
 }
 
 
-void printState(struct gameState *game) {
-  int numActions = game->numActions;
-  int numCoins = game->coins;
-  int numBuys = game->numBuys;
-  int currentPlayer = game->whoseTurn;
+void formatState(struct printBuffer *buffer, struct gameState *game) {
   int phase = game->phase;
-  char phaseName[MAX_STRING_LENGTH];
-  phaseNumToName(phase,phaseName);
-  printf("Player %d:\n%s phase\n%d actions\n%d coins\n%d buys\n\n", currentPlayer, phaseName, numActions, numCoins, numBuys);
+  const char *phaseName = phase >= ACTION_PHASE && phase <= CLEANUP_PHASE ? phaseNames[phase] : "?";
+  if(buffer->mode == PRINT_COMPACT) {
+    putText(buffer, "state p=", 0);
+    putNumber(buffer, game->whoseTurn, 0);
+    putText(buffer, " phase=", 0);
+    putNumber(buffer, phase, 0);
+    putText(buffer, " actions=", 0);
+    putNumber(buffer, game->numActions, 0);
+    putText(buffer, " coins=", 0);
+    putNumber(buffer, game->coins, 0);
+    putText(buffer, " buys=", 0);
+    putNumber(buffer, game->numBuys, 0);
+    putText(buffer, "\n", 0);
+    return;
+  }
+  putText(buffer, "Player ", 0);
+  putNumber(buffer, game->whoseTurn, 0);
+  putText(buffer, ":\n", 0);
+  putText(buffer, phaseName, 0);
+  putText(buffer, " phase\n", 0);
+  putNumber(buffer, game->numActions, 0);
+  putText(buffer, " actions\n", 0);
+  putNumber(buffer, game->coins, 0);
+  putText(buffer, " coins\n", 0);
+  putNumber(buffer, game->numBuys, 0);
+  putText(buffer, " buys\n\n", 0);
 }
 
-void printScores(struct gameState *game) {
-  int playerNum, score[MAX_PLAYERS];
-  int numPlayers = game->numPlayers;
-  for(playerNum = 0; playerNum < numPlayers; playerNum++) {
-    score[playerNum] = scoreFor(playerNum,game);
-    printf("Player %d has a score of %d\n", playerNum, score[playerNum]);
+
+void formatScores(struct printBuffer *buffer, struct gameState *game) {
+  int playerNum;
+  if(buffer->mode == PRINT_COMPACT) putText(buffer, "scores ", 0);
+  for(playerNum = 0; playerNum < game->numPlayers; playerNum++) {
+    if(buffer->mode == PRINT_COMPACT) {
+      if(playerNum > 0) putText(buffer, ",", 0);
+      putNumber(buffer, scoreFor(playerNum,game), 0);
+      continue;
+    }
+    putText(buffer, "Player ", 0);
+    putNumber(buffer, playerNum, 0);
+    putText(buffer, " has a score of ", 0);
+    putNumber(buffer, scoreFor(playerNum,game), 0);
+    putText(buffer, "\n", 0);
   }
+  if(buffer->mode == PRINT_COMPACT) putText(buffer, "\n", 0);
+}
+
+
+void setPrintMode(int mode) {
+  printMode = mode;
+}
+
+
+//Each printX is one snapshot: formatted on the stack, one write to stdout
+#define PRINT_SNAPSHOT(format) \
+  char data[PRINT_BUFFER_SIZE]; \
+  struct printBuffer buffer; \
+  printBufferInit(&buffer, data, PRINT_BUFFER_SIZE, printMode); \
+  format; \
+  printBufferFlush(&buffer, stdout)
+
+void printHand(int player, struct gameState *game) {
+  PRINT_SNAPSHOT(formatHand(&buffer, player, game));
+}
+
+void printDeck(int player, struct gameState *game) {
+  PRINT_SNAPSHOT(formatDeck(&buffer, player, game));
+}
+
+void printPlayed(int player, struct gameState *game) {
+  PRINT_SNAPSHOT(formatPlayed(&buffer, player, game));
+}
+
+void printDiscard(int player, struct gameState *game) {
+  PRINT_SNAPSHOT(formatDiscard(&buffer, player, game));
+}
+
+void printSupply(struct gameState *game) {
+  PRINT_SNAPSHOT(formatSupply(&buffer, game));
+}
+
+void printState(struct gameState *game) {
+  PRINT_SNAPSHOT(formatState(&buffer, game));
+}
+
+void printScores(struct gameState *game) {
+  PRINT_SNAPSHOT(formatScores(&buffer, game));
 }
 
 
@@ -251,6 +345,7 @@ void printHelp(void) {
   end 			      			- end your turn\n\
   init [Number of Players] [Number of Bots] 	- initialize the game\n\
   num 			      			- print number of cards in your hand\n\
+  odds 						- your chance of winning, and of next hand's coins\n\
   play [Hand Index] [Choice] [Choice] [Choice]	- play a card from your hand\n\
   resign					- end the game showing the current scores\n\
   show 						- show your current hand\n\
@@ -264,14 +359,7 @@ void printHelp(void) {
 
 
 void phaseNumToName(int phase, char *name) {
-  switch(phase){
-  case ACTION_PHASE: strcpy(name,"Action");
-    break;
-  case BUY_PHASE: strcpy(name,"Buy");
-    break;
-  case CLEANUP_PHASE: strcpy(name,"Cleanup");
-    break;	
-  }
+  if(phase >= ACTION_PHASE && phase <= CLEANUP_PHASE) strcpy(name, phaseNames[phase]);
 }
 
 
@@ -328,36 +416,190 @@ int countHandCoins(int player, struct gameState *game) {
 }
 
 
-void executeBotTurn(int player, int *turnNum, struct gameState *game) {
-  int coins = countHandCoins(player, game);
-	
-  printf("*****************Executing Bot Player %d Turn Number %d*****************\n", player, *turnNum);
-  printSupply(game);	
-  //sleep(1); //Thinking...
-	
-  if(coins >= PROVINCE_COST && supplyCount(province,game) > 0) {
-    buyCard(province,game);
-    printf("Player %d buys card Province\n\n", player);
+//Compiled once, then only read, so bot threads can share it
+static struct strategy botStrategy;
+static int botStrategyReady = FALSE;
+
+
+int loadBotStrategy(const char *path) {
+  if(path == NULL) {
+    botStrategyReady = strategyParse(&botStrategy, STRATEGY_DEFAULT) == SUCCESS;
+  } else {
+    botStrategyReady = strategyLoad(&botStrategy, path) == SUCCESS;
   }
-  else if(supplyCount(province,game) == 0 && coins >= DUCHY_COST ) {
-    buyCard(duchy,game);
-    printf("Player %d buys card Duchy\n\n", player);
+  return botStrategyReady ? SUCCESS : FAILURE;
+}
+
+
+//Positions of endgame search per bot buy; a count, not a time, so bot play repeats
+static long botEndgameNodes = 0;
+
+void setBotEndgameNodes(long maxNodes) {
+  botEndgameNodes = maxNodes;
+}
+
+
+//Mapped once, then only read, like the strategy
+static struct evalNet botNet;
+static int botNetReady = FALSE;
+
+
+int loadBotNet(const char *path) {
+  if(botNetReady == TRUE) evalnetClose(&botNet);
+  botNetReady = FALSE;
+  if(path == NULL) return SUCCESS;
+  botNetReady = evalnetOpen(path, &botNet) == 0;
+  return botNetReady ? SUCCESS : FAILURE;
+}
+
+
+//Row 0 is buying nothing; the rest are derived from it, one per affordable card
+static int botNetChoice(int player, int coins, int turnNum, struct gameState *game) {
+  signed char rows[(NUM_TOTAL_K_CARDS + 1) * FEATURE_STRIDE] __attribute__((aligned(64)));
+  int cards[NUM_TOTAL_K_CARDS + 1];
+  float scores[NUM_TOTAL_K_CARDS + 1];
+  int card, count = 1, best = 0, index;
+
+  if(featuresInt8(game, 1, &player, &turnNum, rows) == -1) return UNUSED;
+  cards[0] = UNUSED;
+  for(card = curse; card < NUM_TOTAL_K_CARDS && game->numBuys > 0; card++) {
+    if(supplyCount(card, game) > 0 && getCardCost(card) <= coins) {
+      featuresAfterBuy(rows, card, getCardCost(card), rows + count * FEATURE_STRIDE);
+      cards[count++] = card;
+    }
+  }
+  evalnetScore(&botNet, rows, count, scores);
+  for(index = 1; index < count; index++) {
+    if(scores[index] > scores[best]) best = index;
+  }
+  return cards[best];
+}
+
+
+int botBuyCard(int player, int turnNum, struct gameState *game) {
+  struct endgameChoice endgame;
+  int coins = countHandCoins(player, game);
+  int card;
+
+  if(botNetReady == TRUE) {
+    card = botNetChoice(player, coins, turnNum, game);
+  } else {
+    if(botStrategyReady == FALSE) loadBotStrategy(NULL);
+    card = strategyChoose(&botStrategy, player, coins, turnNum, game);
   }
-  else if(coins >= GOLD_COST && supplyCount(gold,game) > 0) {
-    buyCard(gold,game);
-    printf("Player %d buys card Gold\n\n", player);
+  //Near the end the solver decides the victory cards; money stays with the strategy
+  if(botEndgameNodes > 0 && endgameNear(game)
+     && endgameSolve(player, game, coins, 0, botEndgameNodes, &endgame) == 0
+     && (endgame.card != UNUSED || card == province || card == duchy || card == estate)) {
+    card = endgame.card;
   }
-  else if(coins >= SILVER_COST && supplyCount(silver,game) > 0) {
-    buyCard(silver,game);
-    printf("Player %d buys card Silver\n\n", player);
+  if(card != UNUSED) buyCard(card,game);
+  return card;
+}
+
+
+#define BOT_ODDS_SEED 12345	//a fixed seed, so the same position gives the same odds
+#define BOT_ODDS_ROLLOUTS 1000000	//the time budget is what normally stops rollouts
 
+int botWinProbability(int player, int turnNum, struct gameState *game, double budgetSeconds,
+		      struct winEstimate *estimate) {
+  const struct strategy *seats[MAX_PLAYERS];
+  int seat;
+
+  if(botStrategyReady == FALSE) loadBotStrategy(NULL);
+  for(seat = 0; seat < MAX_PLAYERS; seat++) seats[seat] = &botStrategy;
+  return winProbability(player, game, seats, turnNum, budgetSeconds, BOT_ODDS_ROLLOUTS,
+			0, BOT_ODDS_SEED, estimate);
+}
+
+
+//The whole bot turn is one snapshot: header, supply, buy and next turn
+void executeBotTurn(int player, int *turnNum, struct gameState *game) {
+  int card;
+  char data[PRINT_BUFFER_SIZE];
+  struct printBuffer buffer;
+  int compact = printMode == PRINT_COMPACT;
+
+  printBufferInit(&buffer, data, PRINT_BUFFER_SIZE, printMode);
+  putText(&buffer, compact ? "bot p=" : "*****************Executing Bot Player ", 0);
+  putNumber(&buffer, player, 0);
+  putText(&buffer, compact ? " turn=" : " Turn Number ", 0);
+  putNumber(&buffer, *turnNum, 0);
+  putText(&buffer, compact ? "\n" : "*****************\n", 0);
+  formatSupply(&buffer, game);
+  //sleep(1); //Thinking...
+	
+  card = botBuyCard(player, *turnNum, game);
+  if(card != UNUSED) {
+    putText(&buffer, compact ? "buy p=" : "Player ", 0);
+    putNumber(&buffer, player, 0);
+    if(compact) {
+      putText(&buffer, " card=", 0);
+      putNumber(&buffer, card, 0);
+      putText(&buffer, "\n", 0);
+    } else {
+      putText(&buffer, " buys card ", 0);
+      putText(&buffer, cardName(card), 0);
+      putText(&buffer, "\n\n", 0);
+    }
   }
 
 	
   if(player == (game->numPlayers -1)) (*turnNum)++;
   endTurn(game);
   if(! isGameOver(game)) {
-    int currentPlayer = whoseTurn(game);
-    printf("Player %d's turn number %d\n\n", currentPlayer, (*turnNum));
+    putText(&buffer, compact ? "turn p=" : "Player ", 0);
+    putNumber(&buffer, whoseTurn(game), 0);
+    putText(&buffer, compact ? " n=" : "'s turn number ", 0);
+    putNumber(&buffer, *turnNum, 0);
+    putText(&buffer, compact ? "\n" : "\n\n", 0);
+  }
+  printBufferFlush(&buffer, stdout);
+}
+
+
+//Four command characters packed into one key; bytes after the end of a
+//short word stay zero, which matches strncmp(.., 4) in COMPARE()
+static unsigned int commandKey(const char *command) {
+  unsigned int key = 0;
+  int i;
+  for(i = 0; i < 4 && command[i] != '\0'; i++) {
+    key |= (unsigned int)(unsigned char)command[i] << (8 * i);
+  }
+  return key;
+}
+
+#define COMMAND_TABLE_SIZE 32
+
+int commandLookup(const char *command) {
+  static const char *names[NUM_COMMANDS] = {
+    "add", "buy", "end", "exit", "help", "init", "num", "odds", "play",
+    "resi", "show", "stat", "supp", "whos"
+  };
+  static unsigned int keys[COMMAND_TABLE_SIZE];
+  static int commands[COMMAND_TABLE_SIZE];
+  static int built = FALSE;
+  unsigned int key, slot;
+  int i;
+
+  //Open addressed table built on first use
+  if(built == FALSE) {
+    for(slot = 0; slot < COMMAND_TABLE_SIZE; slot++) commands[slot] = CMD_UNKNOWN;
+    for(i = 0; i < NUM_COMMANDS; i++) {
+      key = commandKey(names[i]);
+      slot = key % COMMAND_TABLE_SIZE;
+      while(commands[slot] != CMD_UNKNOWN) slot = (slot + 1) % COMMAND_TABLE_SIZE;
+      keys[slot] = key;
+      commands[slot] = i;
+    }
+    built = TRUE;
+  }
+
+  key = commandKey(command);
+  slot = key % COMMAND_TABLE_SIZE;
+  while(commands[slot] != CMD_UNKNOWN) {
+    if(keys[slot] == key) return commands[slot];
+    slot = (slot + 1) % COMMAND_TABLE_SIZE;
   }
+  return CMD_UNKNOWN;
 }
@@ -11,7 +11,11 @@
 
 
 
+#include <stdio.h>
 #include "dominion.h"
+#include "winprob.h"
+#include "endgame.h"
+#include "evalnet.h"
 
 //Last card enum (Treasure map) card number plus one for the 0th card.
 #define NUM_TOTAL_K_CARDS (treasure_map + 1)
@@ -37,6 +41,43 @@
 #define SUCCESS 0
 #define FAILURE -1
 
+//Commands understood by the interface, see commandLookup()
+enum COMMAND
+  {CMD_UNKNOWN = -1,
+   CMD_ADD = 0,
+   CMD_BUY,
+   CMD_END,
+   CMD_EXIT,
+   CMD_HELP,
+   CMD_INIT,
+   CMD_NUM,
+   CMD_ODDS,
+   CMD_PLAY,
+   CMD_RESIGN,
+   CMD_SHOW,
+   CMD_STAT,
+   CMD_SUPPLY,
+   CMD_WHOS,
+   NUM_COMMANDS
+  };
+
+//Output styles for the print/format functions
+#define PRINT_HUMAN 0	//the original tables
+#define PRINT_COMPACT 1	//one "key field=value ..." line per snapshot, card numbers not names
+
+//Large enough for a full deck listing in either style
+#define PRINT_BUFFER_SIZE 16384
+
+//Caller-owned text buffer the format functions append to; text that does
+//not fit is dropped and counted in overflow rather than written past size
+struct printBuffer {
+  char *data;
+  int size;
+  int length;
+  int overflow;
+  int mode;
+};
+
 #define MATCH 0
 #define WINNER 1
 #define NOT_WINNER 0
@@ -92,9 +133,67 @@ int countHandCoins(int player, struct gameState *game);
 
 void executeBotTurn(int player, int *turnNum, struct gameState *game);
 
+int botBuyCard(int player, int turnNum, struct gameState *game);
+/* The bot's buy for this turn without any printing; returns the card
+   bought or UNUSED.  The choice comes from the bot strategy */
+
+int botWinProbability(int player, int turnNum, struct gameState *game, double budgetSeconds,
+		      struct winEstimate *estimate);
+/* player's odds of winning from here with every seat playing on by the
+   bot strategy, from as many rollouts as fit in budgetSeconds
+   (winprob.h).  game is not changed */
+
+int loadBotStrategy(const char *path);
+/* Replace the bot strategy with the strategy file at path (strategy.h),
+   or with STRATEGY_DEFAULT when path is NULL.  Call before any bot turn
+   is played; returns FAILURE, leaving no strategy loaded, on a bad file */
+
+int loadBotNet(const char *path);
+/* Score bot buys with the weight file at path (evalnet.h) instead of the
+   strategy: every affordable card and buying nothing are scored in one
+   batch, and the best is bought.  NULL goes back to the strategy.  Call
+   before any bot turn is played; returns FAILURE, leaving the strategy
+   in charge, on a bad file */
+
+void setBotEndgameNodes(long maxNodes);
+/* Positions botBuyCard() lets the endgame solver search per buy near
+   the end (endgame.h); 0, the default, leaves every buy to the strategy.
+   A node limit rather than a time budget keeps bot play reproducible.
+   Set before any bot turn is played */
+
+int commandLookup(const char *command);
+/* enum COMMAND for a command word, matched on its first four characters
+   exactly as COMPARE() does, or CMD_UNKNOWN */
+
 void phaseNumToName(int phase, char *name); 
 void cardNumToName(int card, char *name);
 
+const char *cardName(int card);
+/* Name of a card from a static table, "?" for anything out of range;
+   the string must not be modified */
+
+void printBufferInit(struct printBuffer *buffer, char *data, int size, int mode);
+/* Start an empty buffer over data[size] */
+
+int printBufferFlush(struct printBuffer *buffer, FILE *out);
+/* Write the whole buffer with one call and empty it.  If anything was
+   dropped for lack of room a line saying how much follows the text.
+   Returns -1 if the write failed or anything was dropped */
+
+void formatHand(struct printBuffer *buffer, int player, struct gameState *game);
+void formatDeck(struct printBuffer *buffer, int player, struct gameState *game);
+void formatDiscard(struct printBuffer *buffer, int player, struct gameState *game);
+void formatPlayed(struct printBuffer *buffer, int player, struct gameState *game);
+void formatSupply(struct printBuffer *buffer, struct gameState *game);
+void formatState(struct printBuffer *buffer, struct gameState *game);
+void formatScores(struct printBuffer *buffer, struct gameState *game);
+/* Append one snapshot to buffer in buffer->mode; the printX functions
+   below are each one of these flushed straight to stdout */
+
+void setPrintMode(int mode);
+/* PRINT_HUMAN (the default) or PRINT_COMPACT for every printX call and
+   the bot turn output */
+
 int getCardCost(int card);
 
 void printHelp(void);
@@ -0,0 +1,19 @@
+/* 	Kingdom Card Sets
+	Apart from kingdomengine.c, whose table kingdomgen writes
+*/
+
+#include "kingdomengine.h"
+
+
+unsigned int kingdomCardSet(const int kingdom[10]) {
+  unsigned int cards = KINGDOM_BASE_CARDS;
+  int i;
+
+  for (i = 0; i < 10; i++) {
+    if (kingdom[i] < adventurer || kingdom[i] > treasure_map || (cards >> kingdom[i]) & 1) {
+      return 0;
+    }
+    cards |= 1u << kingdom[i];
+  }
+  return cards;
+}
@@ -0,0 +1,19 @@
+/* 	Kingdom-Specialized Engines
+*/
+
+#include "kingdomengine.h"
+
+const struct kingdomEngine genericEngine = KINGDOM_ENGINE(, "generic", (1u << (treasure_map + 1)) - 1);
+
+
+const struct kingdomEngine *kingdomEngineFor(const int kingdom[10]) {
+  unsigned int cards = kingdomCardSet(kingdom);
+  int i;
+
+  for (i = 0; cards != 0 && i < numKingdomEngines; i++) {
+    if (kingdomEngines[i].cards == cards) {
+      return &kingdomEngines[i];
+    }
+  }
+  return &genericEngine;
+}
@@ -0,0 +1,65 @@
+/* 	Kingdom-Specialized Engines
+
+	kingdomgen turns each line of kingdoms.list into its own copy of
+	dominion.c and simulate.c, compiled with CARD_ENABLED() (dominion.h)
+	true only for the base cards and that kingdom's ten, so the code for
+	the other ten kingdom cards and the gardens and great_hall scoring
+	fold away.  Each copy's symbols are renamed with its prefix (see the
+	kingdomengines.o rule in the Makefile), like difftest's variants, and
+	kingdomEngineFor() picks the copy for a kingdom at run time.
+
+	A specialized engine plays exactly the games the generic one does
+	on its kingdom; it only refuses to play cards the kingdom lacks,
+	which no game on that kingdom can hold.
+*/
+
+#ifndef _KINGDOMENGINE_H
+#define _KINGDOMENGINE_H
+
+#include "dominion.h"
+#include "simulate.h"
+
+struct kingdomEngine {
+  const char *name;		//kingdoms.list name, "generic" for the full engine
+  unsigned int cards;		//bit c set for every card c the engine can play
+  int (*initializeFromPrototype)(const struct gamePrototype *, int, struct gameState *);
+  int (*playCard)(int, int, int, int, struct gameState *);
+  int (*buyCard)(int, struct gameState *);
+  int (*endTurn)(struct gameState *);
+  int (*isGameOver)(struct gameState *);
+  int (*scoreFor)(int, struct gameState *);
+  int (*simulatePrototype)(const struct strategy *[], const struct gamePrototype *,
+			   int, int, struct gameResult *);
+};
+
+#define KINGDOM_BASE_CARDS 0x7fu	//curse .. gold
+
+#define DECLARE_KINGDOM_ENGINE(p)					\
+  int p##initializeFromPrototype(const struct gamePrototype *, int, struct gameState *); \
+  int p##playCard(int, int, int, int, struct gameState *);		\
+  int p##buyCard(int, struct gameState *);				\
+  int p##endTurn(struct gameState *);					\
+  int p##isGameOver(struct gameState *);				\
+  int p##scoreFor(int, struct gameState *);				\
+  int p##simulatePrototype(const struct strategy *[], const struct gamePrototype *, \
+			   int, int, struct gameResult *);
+
+#define KINGDOM_ENGINE(p, name, cards)					\
+  { name, cards, p##initializeFromPrototype, p##playCard, p##buyCard,	\
+    p##endTurn, p##isGameOver, p##scoreFor, p##simulatePrototype }
+
+//The generated table (kingdomtable.c), in kingdoms.list order
+extern const struct kingdomEngine kingdomEngines[];
+extern const int numKingdomEngines;
+
+extern const struct kingdomEngine genericEngine;
+
+unsigned int kingdomCardSet(const int kingdom[10]);
+/* The cards field an engine for kingdom would have: the base cards and
+   the kingdom's, or 0 if kingdom is not 10 different kingdom cards */
+
+const struct kingdomEngine *kingdomEngineFor(const int kingdom[10]);
+/* The engine specialized for kingdom, in any order, or genericEngine if
+   none was built for it */
+
+#endif
@@ -0,0 +1,171 @@
+/* 	Kingdom-Specialized Engine Generator
+
+	Reads a kingdom list, one kingdom per line as a name and its ten
+	cards spelled as in enum CARD ('#' starts a comment), and writes
+	for each kingdom_<name>.c, which includes dominion.c and simulate.c
+	with CARD_ENABLED() set to that kingdom's cards, and kingdomtable.c,
+	the kingdomEngines[] table of them all (kingdomengine.h).  The
+	Makefile compiles and renames each copy; see kingdomengines.o.
+
+	Usage:	kingdomgen kingdomList
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include "kingdomengine.h"
+#include "strategy.h"
+
+#define KINGDOMGEN_MAX 64		//kingdoms in one list
+#define KINGDOMGEN_NAME_LENGTH 32
+#define KINGDOMGEN_LINE_LENGTH 512
+
+struct kingdomLine {
+  char name[KINGDOMGEN_NAME_LENGTH];
+  int cards[10];
+};
+
+static struct kingdomLine kingdoms[KINGDOMGEN_MAX];
+static int numKingdoms;
+
+
+//One kingdom from line; 0 for a blank or comment line, -1 if malformed
+static int parseLine(char *line, struct kingdomLine *k) {
+  char *word, *p;
+  int n = 0;
+
+  if ((p = strchr(line, '#')) != NULL) {
+    *p = '\0';
+  }
+  word = strtok(line, " \t\r\n");
+  if (word == NULL) {
+    return 0;
+  }
+  if (strlen(word) >= KINGDOMGEN_NAME_LENGTH) {
+    return -1;
+  }
+  for (p = word; *p != '\0'; p++) {
+    if (!isalnum((unsigned char)*p) && *p != '_') {
+      return -1;
+    }
+  }
+  strcpy(k->name, word);
+  while ((word = strtok(NULL, " \t\r\n")) != NULL) {
+    if (n == 10 || (k->cards[n++] = strategyCardNumber(word)) < 0) {
+      return -1;
+    }
+  }
+  return n == 10 && kingdomCardSet(k->cards) != 0 ? 1 : -1;
+}
+
+
+static int readList(const char *path) {
+  char line[KINGDOMGEN_LINE_LENGTH];
+  FILE *in = fopen(path, "r");
+  int number = 0, i, r;
+
+  if (in == NULL) {
+    perror(path);
+    return -1;
+  }
+  while (fgets(line, sizeof(line), in) != NULL) {
+    number++;
+    if (numKingdoms == KINGDOMGEN_MAX) {
+      fprintf(stderr, "%s:%d: more than %d kingdoms\n", path, number, KINGDOMGEN_MAX);
+      fclose(in);
+      return -1;
+    }
+    r = parseLine(line, &kingdoms[numKingdoms]);
+    if (r == -1) {
+      fprintf(stderr, "%s:%d: expected a name and ten different kingdom cards\n", path, number);
+      fclose(in);
+      return -1;
+    }
+    for (i = 0; r == 1 && i < numKingdoms; i++) {
+      if (strcmp(kingdoms[i].name, kingdoms[numKingdoms].name) == 0) {
+	fprintf(stderr, "%s:%d: %s is listed twice\n", path, number, kingdoms[i].name);
+	fclose(in);
+	return -1;
+      }
+    }
+    numKingdoms += r;
+  }
+  fclose(in);
+  return 0;
+}
+
+
+static int writeEngine(const char *list, const struct kingdomLine *k) {
+  char path[KINGDOMGEN_NAME_LENGTH + 16];
+  FILE *out;
+  int i;
+
+  //Names are checked shorter than KINGDOMGEN_NAME_LENGTH when read; the
+  //precision tells the compiler so
+  snprintf(path, sizeof(path), "kingdom_%.*s.c", KINGDOMGEN_NAME_LENGTH - 1, k->name);
+  if ((out = fopen(path, "w")) == NULL) {
+    perror(path);
+    return -1;
+  }
+  fprintf(out, "/* Generated by kingdomgen from %s; do not edit.\n\n", list);
+  fprintf(out, "   The engine for the kingdom %s:", k->name);
+  for (i = 0; i < 10; i++) {
+    fprintf(out, "%s%s", i % 5 == 0 ? "\n\t" : " ", strategyCardId(k->cards[i]));
+  }
+  fprintf(out, "\n*/\n\n");
+  fprintf(out, "#define CARD_ENABLED(card) ((0x%xu >> (card)) & 1)\n\n", kingdomCardSet(k->cards));
+  fprintf(out, "#include \"dominion.c\"\n#include \"simulate.c\"\n");
+  return fclose(out) == 0 ? 0 : -1;
+}
+
+
+static int writeTable(const char *list) {
+  FILE *out;
+  int i;
+
+  if ((out = fopen("kingdomtable.c", "w")) == NULL) {
+    perror("kingdomtable.c");
+    return -1;
+  }
+  fprintf(out, "/* Generated by kingdomgen from %s; do not edit */\n\n", list);
+  fprintf(out, "#include \"kingdomengine.h\"\n\n");
+  for (i = 0; i < numKingdoms; i++) {
+    fprintf(out, "DECLARE_KINGDOM_ENGINE(kingdom_%s_)\n", kingdoms[i].name);
+  }
+  fprintf(out, "\nconst struct kingdomEngine kingdomEngines[] = {\n");
+  for (i = 0; i < numKingdoms; i++) {
+    fprintf(out, "  KINGDOM_ENGINE(kingdom_%s_, \"%s\", 0x%xu),\n",
+	    kingdoms[i].name, kingdoms[i].name, kingdomCardSet(kingdoms[i].cards));
+  }
+  //C has no empty arrays; numKingdomEngines keeps this entry out of reach
+  if (numKingdoms == 0) {
+    fprintf(out, "  KINGDOM_ENGINE(, \"generic\", 0),\n");
+  }
+  fprintf(out, "};\n\nconst int numKingdomEngines = %d;\n", numKingdoms);
+  return fclose(out) == 0 ? 0 : -1;
+}
+
+
+int main(int argc, char **argv) {
+  int i, j;
+
+  if (argc != 2) {
+    fprintf(stderr, "Usage: kingdomgen kingdomList\n");
+    return 1;
+  }
+  if (readList(argv[1]) != 0) {
+    return 1;
+  }
+  for (i = 0; i < numKingdoms; i++) {
+    for (j = 0; j < i; j++) {
+      if (kingdomCardSet(kingdoms[i].cards) == kingdomCardSet(kingdoms[j].cards)) {
+	fprintf(stderr, "kingdomgen: %s and %s are the same kingdom\n", kingdoms[j].name, kingdoms[i].name);
+	return 1;
+      }
+    }
+    if (writeEngine(argv[1], &kingdoms[i]) != 0) {
+      return 1;
+    }
+  }
+  return writeTable(argv[1]) == 0 ? 0 : 1;
+}
@@ -0,0 +1,356 @@
+/* 	Kingdom Balance Sweep
+
+	Every kingdom of 10 distinct cards out of the 20 kingdom cards
+	(adventurer .. treasure_map) has a rank 0 .. 184755 in the
+	combinatorial number system, so the sweep needs no kingdom list: each
+	thread claims blocks of ranks and unranks them itself.  -sample n
+	instead plays n kingdoms spread evenly across the rank order, which
+	keeps every card in proportion.
+
+	On each kingdom, for each of its 10 cards X, big money plus two X
+	plays plain big money for -games games (seat swapped, shared seeds),
+	and BM+X's points are stored in halves: 2 a win, 1 a tie.  Results live in a fixed-layout
+	file, mapped into memory:
+
+	    header				struct sweepHeader
+	    record[i], i = 0 .. kingdoms-1	10 x uint16 half points, in card order
+
+	A record is written whole once its kingdom is finished, and records
+	still holding SWEEP_PENDING are played on the next run, so an
+	interrupted sweep resumes where it stopped.  The per-card lift table
+	(BM+X points per game minus one half, over every kingdom containing X) is
+	printed at the end, or alone with -report.
+
+	Simulations only play the draw and village cards (simulatePlays());
+	any other X would be bought and never played, so only those and
+	gardens, which scores without being played, are measured.  The rest
+	are skipped and listed under the table.
+
+	Usage:	kingdomsweep [-j threads] [-games n] [-sample n] [-o resultFile] [-report]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "dominion.h"
+#include "strategy.h"
+#include "simulate.h"
+#include "kingdomengine.h"
+
+#define SWEEP_CARDS 20			//adventurer .. treasure_map
+#define SWEEP_FIRST adventurer
+#define SWEEP_KINGDOM 10
+#define SWEEP_TOTAL 184756		//20 choose 10
+#define SWEEP_BLOCK 32			//kingdoms claimed at a time
+#define SWEEP_PENDING 0xFFFF
+#define SWEEP_MAGIC 0x5045575344ULL	//"DSWEP"
+
+struct sweepHeader {
+  uint64_t magic;
+  uint32_t games;	//games per card per kingdom
+  uint32_t kingdoms;	//records in the file
+  uint32_t sample;	//0 for the full sweep
+  uint32_t pad;
+};
+
+struct sweepRecord {
+  uint16_t halves[SWEEP_KINGDOM];
+};
+
+static int binomial[SWEEP_CARDS + 1][SWEEP_KINGDOM + 1];
+static struct sweepHeader *header;
+static struct sweepRecord *records;
+static int nextBlock;
+static int finished;
+static struct strategy bigMoney;
+static struct strategy bigMoneyPlus[SWEEP_CARDS];
+
+
+static void makeBinomials(void) {
+  int n, k;
+  for (n = 0; n <= SWEEP_CARDS; n++) {
+    binomial[n][0] = 1;
+    for (k = 1; k <= SWEEP_KINGDOM; k++) {
+      binomial[n][k] = n == 0 ? 0 : binomial[n - 1][k - 1] + binomial[n - 1][k];
+    }
+  }
+}
+
+
+//Kingdom with the given rank: rank = sum C(c_i, i) over c_1 < .. < c_10
+static void unrank(int rank, int kingdom[SWEEP_KINGDOM]) {
+  int i, c = SWEEP_CARDS - 1;
+  for (i = SWEEP_KINGDOM; i >= 1; i--) {
+    while (binomial[c][i] > rank) {
+      c--;
+    }
+    rank -= binomial[c][i];
+    kingdom[i - 1] = SWEEP_FIRST + c;
+    c--;
+  }
+}
+
+
+//X is worth measuring: simulations play it, or it scores unplayed
+static int measured(int card) {
+  return simulatePlays(card) || card == gardens;
+}
+
+
+static int recordRank(int index) {
+  if (header->sample == 0) {
+    return index;
+  }
+  return (int)((long long)index * SWEEP_TOTAL / header->sample);
+}
+
+
+static void playKingdom(int index) {
+  const struct strategy *seats[2];
+  struct sweepRecord done;
+  const struct kingdomEngine *engine;
+  struct gamePrototype prototype;
+  struct gameResult result;
+  int kingdom[SWEEP_KINGDOM];
+  int rank = recordRank(index);
+  //Every card of a kingdom is measured on the same seeds
+  int seed = 1 + (int)((long long)rank * header->games % 2000000000);
+  int x, g, seat;
+
+  unrank(rank, kingdom);
+  initializePrototype(2, kingdom, &prototype);
+  engine = kingdomEngineFor(kingdom);
+  for (x = 0; x < SWEEP_KINGDOM; x++) {
+    done.halves[x] = 0;
+    for (g = 0; g < (int)header->games && measured(kingdom[x]); g++) {
+      seat = g % 2;
+      seats[seat] = &bigMoneyPlus[kingdom[x] - SWEEP_FIRST];
+      seats[1 - seat] = &bigMoney;
+      engine->simulatePrototype(seats, &prototype, seed + g / 2, SIMULATE_MAX_TURNS, &result);
+      done.halves[x] += result.winner == seat ? 2 : result.winner < 0 ? 1 : 0;
+    }
+  }
+  //halves[0] marks the record finished, so it goes in last
+  memcpy(&records[index].halves[1], &done.halves[1], sizeof(done.halves) - sizeof(done.halves[0]));
+  __sync_synchronize();
+  records[index].halves[0] = done.halves[0];
+}
+
+
+static void *worker(void *arg) {
+  int block, i, end;
+  while ((block = __sync_fetch_and_add(&nextBlock, 1)) * SWEEP_BLOCK < (int)header->kingdoms) {
+    end = (block + 1) * SWEEP_BLOCK;
+    if (end > (int)header->kingdoms) {
+      end = header->kingdoms;
+    }
+    for (i = block * SWEEP_BLOCK; i < end; i++) {
+      if (records[i].halves[0] == SWEEP_PENDING) {
+	playKingdom(i);
+	__sync_fetch_and_add(&finished, 1);
+      }
+    }
+  }
+  return NULL;
+}
+
+
+static void report(void) {
+  long long halves[SWEEP_CARDS], games[SWEEP_CARDS];
+  int kingdom[SWEEP_KINGDOM];
+  int order[SWEEP_CARDS];
+  double lift[SWEEP_CARDS], p, half;
+  int i, x, j, t, done = 0;
+
+  memset(halves, 0, sizeof(halves));
+  memset(games, 0, sizeof(games));
+  for (i = 0; i < (int)header->kingdoms; i++) {
+    if (records[i].halves[0] == SWEEP_PENDING) {
+      continue;
+    }
+    done++;
+    unrank(recordRank(i), kingdom);
+    for (x = 0; x < SWEEP_KINGDOM; x++) {
+      halves[kingdom[x] - SWEEP_FIRST] += records[i].halves[x];
+      games[kingdom[x] - SWEEP_FIRST] += header->games;
+    }
+  }
+
+  for (i = 0; i < SWEEP_CARDS; i++) {
+    order[i] = i;
+    lift[i] = games[i] ? halves[i] / (2.0 * games[i]) - 0.5 : 0.0;
+  }
+  for (i = 1; i < SWEEP_CARDS; i++) {
+    for (j = i; j > 0 && lift[order[j]] > lift[order[j - 1]]; j--) {
+      t = order[j];
+      order[j] = order[j - 1];
+      order[j - 1] = t;
+    }
+  }
+
+  printf("%d of %u kingdoms played, %u games per card per kingdom\n", done, header->kingdoms, header->games);
+  printf("%-14s %10s %8s %8s\n", "card", "games", "lift", "+-95%");
+  for (i = 0; i < SWEEP_CARDS; i++) {
+    x = order[i];
+    if (!measured(SWEEP_FIRST + x)) {
+      continue;
+    }
+    p = lift[x] + 0.5;
+    half = games[x] ? 1.96 * sqrt(p * (1 - p) / games[x]) : 0.0;
+    printf("%-14s %10lld %+8.4f %8.4f\n", strategyCardId(SWEEP_FIRST + x), games[x], lift[x], half);
+  }
+  printf("not measured (never played):");
+  for (x = 0; x < SWEEP_CARDS; x++) {
+    if (!measured(SWEEP_FIRST + x)) {
+      printf(" %s", strategyCardId(SWEEP_FIRST + x));
+    }
+  }
+  printf("\n");
+}
+
+
+//Map the result file, creating it with every record pending if it is new
+static int openResults(const char *path, int games, int sample) {
+  struct sweepHeader want;
+  struct stat st;
+  size_t size;
+  void *map;
+  int fd, fresh;
+
+  memset(&want, 0, sizeof(want));
+  want.magic = SWEEP_MAGIC;
+  want.games = games;
+  want.kingdoms = sample > 0 ? sample : SWEEP_TOTAL;
+  want.sample = sample;
+  size = sizeof(struct sweepHeader) + (size_t)want.kingdoms * sizeof(struct sweepRecord);
+
+  fd = open(path, O_RDWR | O_CREAT, 0644);
+  if (fd < 0 || fstat(fd, &st) < 0) {
+    return -1;
+  }
+  fresh = st.st_size == 0;
+  if (fresh && ftruncate(fd, size) < 0) {
+    close(fd);
+    return -1;
+  }
+  if (!fresh && (size_t)st.st_size < sizeof(struct sweepHeader)) {
+    close(fd);
+    return -1;
+  }
+  if (!fresh) {
+    //An existing file decides the layout; -games and -sample are ignored
+    if (pread(fd, &want, sizeof(want), 0) != sizeof(want) || want.magic != SWEEP_MAGIC
+	|| (size_t)st.st_size != sizeof(struct sweepHeader) + (size_t)want.kingdoms * sizeof(struct sweepRecord)) {
+      close(fd);
+      return -1;
+    }
+    size = st.st_size;
+  }
+
+  map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    return -1;
+  }
+  header = map;
+  records = (struct sweepRecord*)(header + 1);
+  if (fresh) {
+    *header = want;
+    memset(records, 0xFF, size - sizeof(struct sweepHeader));
+  }
+  return 0;
+}
+
+
+int main(int argc, char **argv) {
+  const char *path = "kingdomsweep.dat";
+  char text[256];
+  pthread_t threads[256];
+  int threadCount = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  int games = 20, sample = 0, reportOnly = 0;
+  int i, a, pending = 0, last = 0;
+  time_t start;
+
+  for (a = 1; a < argc; a++) {
+    if (strcmp(argv[a], "-report") == 0) {
+      reportOnly = 1;
+    }
+    else if (a + 1 < argc && strcmp(argv[a], "-j") == 0) {
+      threadCount = atoi(argv[++a]);
+    }
+    else if (a + 1 < argc && strcmp(argv[a], "-games") == 0) {
+      games = atoi(argv[++a]);
+    }
+    else if (a + 1 < argc && strcmp(argv[a], "-sample") == 0) {
+      sample = atoi(argv[++a]);
+    }
+    else if (a + 1 < argc && strcmp(argv[a], "-o") == 0) {
+      path = argv[++a];
+    }
+    else {
+      break;
+    }
+  }
+  if (a != argc || games < 2 || 2 * games >= SWEEP_PENDING || sample < 0 || sample > SWEEP_TOTAL) {
+    printf("Usage: kingdomsweep [-j threads] [-games n] [-sample n] [-o resultFile] [-report]\n");
+    return EXIT_SUCCESS;
+  }
+  if (threadCount < 1) {
+    threadCount = 1;
+  }
+  if (threadCount > 256) {
+    threadCount = 256;
+  }
+
+  makeBinomials();
+  if (openResults(path, games, sample) < 0) {
+    fprintf(stderr, "kingdomsweep: cannot use %s (does it hold a different sweep?)\n", path);
+    return EXIT_FAILURE;
+  }
+  if (reportOnly) {
+    report();
+    return EXIT_SUCCESS;
+  }
+
+  strategyParse(&bigMoney, "name bigmoney\nprovince\ngold\nsilver\n");
+  for (i = 0; i < SWEEP_CARDS; i++) {
+    snprintf(text, sizeof(text), "name bm_%s\nprovince\ngold\n%s if owned < 2\nsilver\n",
+	     strategyCardId(SWEEP_FIRST + i), strategyCardId(SWEEP_FIRST + i));
+    strategyParse(&bigMoneyPlus[i], text);
+  }
+
+  for (i = 0; i < (int)header->kingdoms; i++) {
+    pending += records[i].halves[0] == SWEEP_PENDING;
+  }
+  printf("%d of %u kingdoms to play on %d thread(s)\n", pending, header->kingdoms, threadCount);
+  fflush(stdout);
+
+  start = time(NULL);
+  for (i = 0; i < threadCount; i++) {
+    pthread_create(&threads[i], NULL, worker, NULL);
+  }
+  //Progress from the main thread while the workers play
+  while (finished < pending) {
+    sleep(1);
+    if (time(NULL) - start >= last + 60) {
+      last = time(NULL) - start;
+      fprintf(stderr, "%d/%d kingdoms, %lds elapsed, about %.0fs left\n", finished, pending, (long)last,
+	      finished ? (double)last * (pending - finished) / finished : 0.0);
+    }
+  }
+  for (i = 0; i < threadCount; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  msync(header, sizeof(struct sweepHeader) + (size_t)header->kingdoms * sizeof(struct sweepRecord), MS_SYNC);
+
+  report();
+  return EXIT_SUCCESS;
+}
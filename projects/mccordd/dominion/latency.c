@@ -0,0 +1,132 @@
+/* 	Command Latency Histograms
+*/
+
+#include <string.h>
+#include <time.h>
+#include "latency.h"
+
+#define LATENCY_HALF (1ULL << (LATENCY_SUB_BITS - 1))
+#define LATENCY_LIMIT ((1ULL << LATENCY_MAX_BITS) - 1)
+
+
+static int latencyIndex(unsigned long long ns) {
+  int top, shift;
+
+  if (ns < (1ULL << LATENCY_SUB_BITS)) {
+    return (int)ns;
+  }
+  top = 63 - __builtin_clzll(ns);
+  shift = top - LATENCY_SUB_BITS + 1;
+  return ((shift + 1) << (LATENCY_SUB_BITS - 1)) + (int)((ns >> shift) - LATENCY_HALF);
+}
+
+//Largest value that lands in bucket i
+static unsigned long long latencyUpper(int i) {
+  int shift;
+  unsigned long long sub;
+
+  if (i < (1 << LATENCY_SUB_BITS)) {
+    return i;
+  }
+  shift = (i >> (LATENCY_SUB_BITS - 1)) - 1;
+  sub = (i & (LATENCY_HALF - 1)) + LATENCY_HALF;
+  return ((sub + 1) << shift) - 1;
+}
+
+unsigned long long latencyNow(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void latencyReset(struct latencyHistogram *h) {
+  memset(h, 0, sizeof(struct latencyHistogram));
+}
+
+void latencyRecord(struct latencyHistogram *h, unsigned long long ns) {
+  if (ns > LATENCY_LIMIT) {
+    ns = LATENCY_LIMIT;
+  }
+  if (h->count == 0 || ns < h->min) {
+    h->min = ns;
+  }
+  if (ns > h->max) {
+    h->max = ns;
+  }
+  h->count++;
+  h->total += ns;
+  h->buckets[latencyIndex(ns)]++;
+}
+
+void latencyMerge(struct latencyHistogram *total, const struct latencyHistogram *h) {
+  int i;
+
+  if (h->count == 0) {
+    return;
+  }
+  if (total->count == 0 || h->min < total->min) {
+    total->min = h->min;
+  }
+  if (h->max > total->max) {
+    total->max = h->max;
+  }
+  total->count += h->count;
+  total->total += h->total;
+  for (i = 0; i < LATENCY_BUCKETS; i++) {
+    total->buckets[i] += h->buckets[i];
+  }
+}
+
+unsigned long long latencyPercentile(const struct latencyHistogram *h, double percent) {
+  unsigned long long rank, seen = 0;
+  int i;
+
+  if (h->count == 0) {
+    return 0;
+  }
+  //rank of the value wanted, counting from 1
+  rank = (unsigned long long)(percent / 100.0 * h->count + 0.5);
+  if (rank < 1) {
+    rank = 1;
+  }
+  if (rank > h->count) {
+    rank = h->count;
+  }
+  for (i = 0; i < LATENCY_BUCKETS; i++) {
+    seen += h->buckets[i];
+    if (seen >= rank) {
+      return latencyUpper(i) < h->max ? latencyUpper(i) : h->max;
+    }
+  }
+  return h->max;
+}
+
+void latencyDumpHeader(FILE *out) {
+  fprintf(out, "%-6s %10s %10s %10s %10s %10s %10s %10s\n",
+	  "#cmd", "count", "mean", "p50", "p90", "p99", "p99.9", "max");
+}
+
+int latencyDump(FILE *out, const char *name, const struct latencyHistogram *h) {
+  double mean = h->count ? (double)h->total / h->count : 0.0;
+  int n = fprintf(out, "%-6s %10llu %10.0f %10llu %10llu %10llu %10llu %10llu\n",
+		  name, h->count, mean,
+		  latencyPercentile(h, 50.0), latencyPercentile(h, 90.0),
+		  latencyPercentile(h, 99.0), latencyPercentile(h, 99.9), h->max);
+  return n < 0 ? -1 : 0;
+}
+
+int latencyReadP99(FILE *in, const char *name, unsigned long long *p99) {
+  char line[256];
+  char found[64];
+  unsigned long long count, p50, p90;
+  double mean;
+
+  rewind(in);
+  while (fgets(line, sizeof(line), in) != NULL) {
+    if (sscanf(line, "%63s %llu %lf %llu %llu %llu", found, &count, &mean, &p50, &p90, p99) == 6
+	&& strcmp(found, name) == 0) {
+      return 0;
+    }
+  }
+  return -1;
+}
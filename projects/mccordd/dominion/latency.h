@@ -0,0 +1,53 @@
+/* 	Command Latency Histograms
+
+	HDR-style log-linear histograms of nanosecond timings: values below
+	2^LATENCY_SUB_BITS get a bucket each, above that every power of two is
+	split into 2^(LATENCY_SUB_BITS-1) equal buckets, so any percentile is
+	reported to within about 3% however long the tail.  Recording is a
+	couple of shifts and an increment; nothing allocates.
+*/
+
+#ifndef _LATENCY_H
+#define _LATENCY_H
+
+#include <stdio.h>
+
+#define LATENCY_SUB_BITS 6
+#define LATENCY_MAX_BITS 40	//timings are clamped below 2^40ns (~18 minutes)
+#define LATENCY_BUCKETS ((LATENCY_MAX_BITS - LATENCY_SUB_BITS + 2) << (LATENCY_SUB_BITS - 1))
+
+struct latencyHistogram {
+  unsigned long long count;
+  unsigned long long total;	//sum of every recorded value, for the mean
+  unsigned long long min, max;	//exact, not bucketed
+  unsigned long long buckets[LATENCY_BUCKETS];
+};
+
+unsigned long long latencyNow(void);
+/* Monotonic clock in nanoseconds */
+
+void latencyReset(struct latencyHistogram *h);
+/* Empty the histogram */
+
+void latencyRecord(struct latencyHistogram *h, unsigned long long ns);
+/* Count one timing */
+
+void latencyMerge(struct latencyHistogram *total, const struct latencyHistogram *h);
+/* Add the counts of h into total */
+
+unsigned long long latencyPercentile(const struct latencyHistogram *h, double percent);
+/* Smallest bucket upper bound at or below which percent (0-100) of the
+   recorded values lie, capped at the exact maximum; 0 if h is empty */
+
+void latencyDumpHeader(FILE *out);
+/* Column titles for latencyDump() */
+
+int latencyDump(FILE *out, const char *name, const struct latencyHistogram *h);
+/* Write one line:  name count mean p50 p90 p99 p99.9 max  (nanoseconds).
+   Returns -1 if the write failed */
+
+int latencyReadP99(FILE *in, const char *name, unsigned long long *p99);
+/* Find name's line in an earlier latencyDump() listing and read its p99.
+   Returns -1 if the listing has no such line */
+
+#endif
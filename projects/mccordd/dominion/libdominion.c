@@ -0,0 +1,368 @@
+/* 	Dominion Library API
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "libdominion.h"
+#include "dominion.h"
+#include "featurevec.h"
+#include "rngs.h"
+#include "simulate.h"
+#include "strategy.h"
+
+#define DOM_ENGINE_STREAM 1	//the rngs.c stream initializeGame() and shuffle() use
+
+//The public constants are fixed by the ABI; the engine must agree with them
+typedef char playersCheck[DOM_MAX_PLAYERS == MAX_PLAYERS ? 1 : -1];
+typedef char cardsCheck[DOM_NUM_CARDS == treasure_map + 1 ? 1 : -1];
+typedef char strideCheck[DOM_FEATURE_STRIDE == FEATURE_STRIDE ? 1 : -1];
+
+struct domSlot {
+  struct gameState state;
+  const struct strategy *strategies[MAX_PLAYERS];
+  long rng;			//the game's stream, between calls
+  int turn;			//rounds completed, for strategies and features
+  int used;
+};
+
+struct domPool {
+  int capacity;
+  int next;			//where domGameNew() starts looking
+  struct domSlot *slots;
+};
+
+struct domStrategy {
+  struct strategy strategy;
+};
+
+static struct strategy defaultStrategy;
+static pthread_once_t defaultOnce = PTHREAD_ONCE_INIT;
+
+
+static void parseDefault(void) {
+  strategyParse(&defaultStrategy, STRATEGY_DEFAULT);
+}
+
+
+//The rngs.c state is per thread and only this library's, so a game's
+//stream is swapped in around each call that may shuffle
+static void enterGame(struct domSlot *slot) {
+  SelectStream(DOM_ENGINE_STREAM);
+  PutSeed(slot->rng);
+}
+
+
+static void leaveGame(struct domSlot *slot) {
+  GetSeed(&slot->rng);
+}
+
+
+static struct domSlot *slotOf(struct domPool *pool, int game) {
+  if (game < 0 || game >= pool->capacity || !pool->slots[game].used) {
+    return NULL;
+  }
+  return &pool->slots[game];
+}
+
+
+int domApiVersion(void) {
+  return DOM_API_VERSION;
+}
+
+
+struct domPool *domPoolCreate(int capacity) {
+  struct domPool *pool;
+  void *slots;
+
+  if (capacity < 1) {
+    return NULL;
+  }
+  pool = malloc(sizeof(struct domPool));
+  if (pool == NULL) {
+    return NULL;
+  }
+  if (posix_memalign(&slots, 64, sizeof(struct domSlot) * (size_t)capacity) != 0) {
+    free(pool);
+    return NULL;
+  }
+  pool->capacity = capacity;
+  pool->slots = slots;
+  domPoolReset(pool);
+  return pool;
+}
+
+
+void domPoolDestroy(struct domPool *pool) {
+  if (pool != NULL) {
+    free(pool->slots);
+    free(pool);
+  }
+}
+
+
+void domPoolReset(struct domPool *pool) {
+  int i;
+
+  for (i = 0; i < pool->capacity; i++) {
+    pool->slots[i].used = 0;
+  }
+  pool->next = 0;
+}
+
+
+int domGameNew(struct domPool *pool, int numPlayers, const int kingdom[10], int seed) {
+  struct domSlot *slot;
+  int k[10];
+  int i, game = 0;
+
+  if (seed < 1) {
+    return -1;
+  }
+  for (i = 0; i < pool->capacity; i++) {
+    game = (pool->next + i) % pool->capacity;
+    if (!pool->slots[game].used) {
+      break;
+    }
+  }
+  if (i == pool->capacity) {
+    return -1;
+  }
+  slot = &pool->slots[game];
+  memcpy(k, kingdom, sizeof(k));
+  memset(&slot->state, 0, sizeof(struct gameState));
+  if (initializeGame(numPlayers, k, seed, &slot->state) != 0) {
+    return -1;
+  }
+  GetSeed(&slot->rng);
+  pthread_once(&defaultOnce, parseDefault);
+  for (i = 0; i < MAX_PLAYERS; i++) {
+    slot->strategies[i] = &defaultStrategy;
+  }
+  slot->turn = 0;
+  slot->used = 1;
+  pool->next = (game + 1) % pool->capacity;
+  return game;
+}
+
+
+void domGameFree(struct domPool *pool, int game) {
+  struct domSlot *slot = slotOf(pool, game);
+
+  if (slot != NULL) {
+    slot->used = 0;
+  }
+}
+
+
+int domGameStrategy(struct domPool *pool, int game, int seat, const struct domStrategy *strategy) {
+  struct domSlot *slot = slotOf(pool, game);
+
+  if (slot == NULL || seat < 0 || seat >= slot->state.numPlayers || strategy == NULL) {
+    return -1;
+  }
+  slot->strategies[seat] = &strategy->strategy;
+  return 0;
+}
+
+
+static int endSlotTurn(struct domSlot *slot) {
+  if (whoseTurn(&slot->state) == slot->state.numPlayers - 1) {
+    slot->turn++;
+  }
+  return endTurn(&slot->state);
+}
+
+
+static int stepSlot(struct domSlot *slot, const struct domAction *action) {
+  struct gameState *state = &slot->state;
+
+  switch (action->type) {
+  case DOM_PLAY:
+    if (action->arg < 0 || action->arg >= numHandCards(state)) {
+      return -1;
+    }
+    return playCard(action->arg, action->choice1, action->choice2, action->choice3, state);
+  case DOM_BUY:
+    if (action->arg < curse || action->arg > treasure_map) {
+      return -1;
+    }
+    return buyCard(action->arg, state);
+  case DOM_END_TURN:
+    return endSlotTurn(slot);
+  case DOM_AUTO_TURN:
+    simulateTurn(slot->strategies[whoseTurn(state)], state, slot->turn);
+    return endSlotTurn(slot);
+  }
+  return -1;
+}
+
+
+int domStep(struct domPool *pool, const struct domAction actions[], int count, int results[]) {
+  struct domSlot *slot;
+  int i, result, done = 0;
+
+  for (i = 0; i < count; i++) {
+    slot = slotOf(pool, actions[i].game);
+    result = -1;
+    if (slot != NULL) {
+      enterGame(slot);
+      result = stepSlot(slot, &actions[i]) == 0 ? 0 : -1;
+      leaveGame(slot);
+    }
+    if (results != NULL) {
+      results[i] = result;
+    }
+    if (result == 0) {
+      done++;
+    }
+  }
+  return done;
+}
+
+
+static int fieldWidth(int field) {
+  switch (field) {
+  case DOM_SCORES:
+  case DOM_HAND_COUNTS:
+    return DOM_MAX_PLAYERS;
+  case DOM_SUPPLY:
+    return DOM_NUM_CARDS;
+  case DOM_HANDS:
+    return DOM_MAX_PLAYERS * DOM_NUM_CARDS;
+  }
+  return field >= DOM_WHOSE_TURN && field <= DOM_COINS ? 1 : -1;
+}
+
+
+static void fetchSlot(struct gameState *state, int field, int *out) {
+  int i, player, card;
+
+  switch (field) {
+  case DOM_WHOSE_TURN: *out = whoseTurn(state);
+    break;
+  case DOM_GAME_OVER: *out = isGameOver(state);
+    break;
+  case DOM_PHASE: *out = state->phase;
+    break;
+  case DOM_ACTIONS: *out = state->numActions;
+    break;
+  case DOM_BUYS: *out = state->numBuys;
+    break;
+  case DOM_COINS: *out = state->coins;
+    break;
+  case DOM_SCORES:
+  case DOM_HAND_COUNTS:
+    for (i = 0; i < DOM_MAX_PLAYERS; i++) {
+      if (i >= state->numPlayers) out[i] = 0;
+      else out[i] = field == DOM_SCORES ? scoreFor(i, state) : state->handCount[i];
+    }
+    break;
+  case DOM_SUPPLY:
+    memcpy(out, state->supplyCount, sizeof(int) * DOM_NUM_CARDS);
+    break;
+  case DOM_HANDS:
+    memset(out, 0, sizeof(int) * DOM_MAX_PLAYERS * DOM_NUM_CARDS);
+    for (player = 0; player < state->numPlayers; player++) {
+      for (i = 0; i < state->handCount[player]; i++) {
+	card = state->hand[player][i];
+	if (card >= 0 && card < DOM_NUM_CARDS) {
+	  out[player * DOM_NUM_CARDS + card]++;
+	}
+      }
+    }
+    break;
+  }
+}
+
+
+int domFetch(struct domPool *pool, const int games[], int count, int field, int out[]) {
+  int width = fieldWidth(field);
+  int i;
+
+  if (width == -1) {
+    return -1;
+  }
+  for (i = 0; i < count; i++) {
+    if (slotOf(pool, games[i]) == NULL) {
+      return -1;
+    }
+  }
+  for (i = 0; i < count; i++) {
+    fetchSlot(&pool->slots[games[i]].state, field, out + i * width);
+  }
+  return width;
+}
+
+
+int domFeatures(struct domPool *pool, const int games[], int count, signed char *out) {
+  struct domSlot *slot;
+  int i;
+
+  for (i = 0; i < count; i++) {
+    slot = slotOf(pool, games[i]);
+    if (slot == NULL || featuresInt8(&slot->state, 1, NULL, &slot->turn,
+				     out + (long)i * DOM_FEATURE_STRIDE) == -1) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+
+struct domStrategy *domStrategyParse(const char *text) {
+  struct domStrategy *strategy = malloc(sizeof(struct domStrategy));
+
+  if (strategy == NULL) {
+    return NULL;
+  }
+  if (strategyParse(&strategy->strategy, text != NULL ? text : STRATEGY_DEFAULT) != 0) {
+    free(strategy);
+    return NULL;
+  }
+  return strategy;
+}
+
+
+void domStrategyFree(struct domStrategy *strategy) {
+  free(strategy);
+}
+
+
+int domRunGames(const struct domStrategy *const strategies[], int numPlayers,
+		const int kingdom[10], int firstSeed, int games, int maxTurns,
+		int winners[], int turns[], int scores[]) {
+  const struct strategy *seats[MAX_PLAYERS];
+  struct gamePrototype prototype;
+  struct gameResult result;
+  int k[10];
+  int g, i;
+
+  if (numPlayers < 2 || numPlayers > MAX_PLAYERS || games < 0 || maxTurns < 1
+      || firstSeed < 1 || firstSeed > 0x7fffffff - games) {
+    return -1;
+  }
+  for (i = 0; i < numPlayers; i++) {
+    if (strategies[i] == NULL) {
+      return -1;
+    }
+    seats[i] = &strategies[i]->strategy;
+  }
+  memcpy(k, kingdom, sizeof(k));
+  if (initializePrototype(numPlayers, k, &prototype) != 0) {
+    return -1;
+  }
+  for (g = 0; g < games; g++) {
+    simulatePrototype(seats, &prototype, firstSeed + g, maxTurns, &result);
+    if (winners != NULL) {
+      winners[g] = result.winner;
+    }
+    if (turns != NULL) {
+      turns[g] = result.finished ? result.turns : -result.turns;
+    }
+    if (scores != NULL) {
+      memcpy(scores + (long)g * numPlayers, result.scores, sizeof(int) * numPlayers);
+    }
+  }
+  return games;
+}
@@ -0,0 +1,115 @@
+/* 	Dominion Library API
+
+	The engine as a shared library (make libdominion.so) for tools in
+	other languages, built so that one call does a lot of work: a list of
+	actions across many games, or many whole games, with the results
+	written into the caller's flat arrays.
+
+	  struct domPool	a fixed number of game slots, allocated once
+	  games			slot numbers in a pool, 0..capacity-1
+	  struct domStrategy	a compiled buy strategy (strategy.h text)
+
+	Reentrant: nothing is shared between pools, and strategies are only
+	read once parsed.  Each thread may use its own pools at the same time
+	as the others; one pool is used by one thread at a time.  Each game
+	keeps its own random stream, so its shuffles depend only on its seed
+	and its own actions, whatever else the thread does in between.
+
+	Only this header's functions are exported, under the symbol version
+	DOMINION_1 (libdominion.map); DOM_API_VERSION changes with any
+	incompatible change, and domApiVersion() reports the version of the
+	library actually loaded.  Seeds are positive.
+*/
+
+#ifndef _LIBDOMINION_H
+#define _LIBDOMINION_H
+
+#define DOM_API_VERSION 1
+
+#define DOM_MAX_PLAYERS 4
+#define DOM_NUM_CARDS 27		//enum CARD values 0..26
+#define DOM_FEATURE_STRIDE 256		//bytes per featurevec.h row
+
+enum DOM_ACTION {
+  DOM_PLAY = 0,		//arg = hand position, with choice1..3
+  DOM_BUY,		//arg = card
+  DOM_END_TURN,
+  DOM_AUTO_TURN		//the current seat plays its actions as simulations do and
+			//buys by the strategy given with domGameStrategy(), then ends its turn
+};
+
+struct domAction {
+  int game;
+  int type;		//enum DOM_ACTION
+  int arg;
+  int choice1, choice2, choice3;
+};
+
+//What domFetch() writes per game, and how many ints each takes
+enum DOM_FIELD {
+  DOM_WHOSE_TURN = 0,	//1
+  DOM_GAME_OVER,	//1
+  DOM_PHASE,		//1
+  DOM_ACTIONS,		//1
+  DOM_BUYS,		//1
+  DOM_COINS,		//1
+  DOM_SCORES,		//DOM_MAX_PLAYERS, 0 past numPlayers
+  DOM_HAND_COUNTS,	//DOM_MAX_PLAYERS
+  DOM_SUPPLY,		//DOM_NUM_CARDS, -1 for cards not in the game
+  DOM_HANDS		//DOM_MAX_PLAYERS * DOM_NUM_CARDS: copies of each card in each seat's hand
+};
+
+struct domPool;
+struct domStrategy;
+
+int domApiVersion(void);
+
+struct domPool *domPoolCreate(int capacity);
+/* A pool of capacity game slots, or NULL if out of memory */
+
+void domPoolDestroy(struct domPool *pool);
+
+void domPoolReset(struct domPool *pool);
+/* Free every game in the pool at once */
+
+int domGameNew(struct domPool *pool, int numPlayers, const int kingdom[10], int seed);
+/* Start a game in a free slot; returns its number, or -1 if the pool is
+   full or initializeGame() refuses the arguments */
+
+void domGameFree(struct domPool *pool, int game);
+
+int domGameStrategy(struct domPool *pool, int game, int seat, const struct domStrategy *strategy);
+/* The strategy DOM_AUTO_TURN buys by for seat (the default strategy
+   until set).  strategy must outlive the game.  -1 on a bad game or seat */
+
+int domStep(struct domPool *pool, const struct domAction actions[], int count, int results[]);
+/* Apply count actions in order, to any mix of games.  results[i], if
+   results is not NULL, is 0 if action i was done and -1 if the engine
+   refused it (or its game is not in use).  Returns how many were done */
+
+int domFetch(struct domPool *pool, const int games[], int count, int field, int out[]);
+/* Write field (enum DOM_FIELD) for games[0..count-1], one after another,
+   to out.  Returns the ints written per game, or -1 on a bad field or
+   game */
+
+int domFeatures(struct domPool *pool, const int games[], int count, signed char *out);
+/* One featuresInt8() row of DOM_FEATURE_STRIDE bytes per game, seen
+   from the seat whose turn it is.  -1 on a bad game */
+
+struct domStrategy *domStrategyParse(const char *text);
+/* Compile strategy text (strategy.h); NULL text is the default ladder.
+   Returns NULL on malformed text or out of memory */
+
+void domStrategyFree(struct domStrategy *strategy);
+
+int domRunGames(const struct domStrategy *const strategies[], int numPlayers,
+		const int kingdom[10], int firstSeed, int games, int maxTurns,
+		int winners[], int turns[], int scores[]);
+/* Play games whole games, seat i by strategies[i], game g on seed
+   firstSeed + g and capped at maxTurns rounds.  Any of the result
+   arrays may be NULL: winners[g] is the winning seat or -1 on a tie,
+   turns[g] the rounds played (negative if the cap was hit), and
+   scores[g * numPlayers + i] seat i's score.  Returns games, or -1 if
+   the arguments are bad */
+
+#endif
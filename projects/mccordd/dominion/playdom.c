@@ -1,8 +1,25 @@
 #include "dominion.h"
 #include <stdio.h>
 #include "rngs.h"
+#include "profile.h"
+#include "strategy.h"
 #include <stdlib.h>
 
+//Buy orders for the two seats; "playdom seed file0 file1" replaces them
+#define PLAYDOM_STRATEGY_0 \
+  "name smithy\n" \
+  "province if coins >= 8\n" \
+  "gold if coins >= 6\n" \
+  "smithy if coins >= 4 and owned < 2\n" \
+  "silver if coins >= 3\n"
+
+#define PLAYDOM_STRATEGY_1 \
+  "name council\n" \
+  "province if coins >= 8\n" \
+  "council_room if coins >= 6 and owned < 2\n" \
+  "gold if coins >= 6\n" \
+  "silver if coins >= 3\n"
+
 int main (int argc, char** argv) {
   struct gameState G;
   int k[10] = {adventurer, gardens, embargo, village, minion, mine, cutpurse,
@@ -11,6 +28,25 @@ int main (int argc, char** argv) {
            //mine, 
            council_room, tribute, smithy};
 
+  struct strategy strategies[2];
+  int turn = 0;
+  int card;
+
+  if (argc != 2 && argc != 4) {
+    printf("Usage: playdom seed [strategyFile0 strategyFile1]\n");
+    return 0;
+  }
+  if (argc == 4) {
+    if (strategyLoad(&strategies[0], argv[2]) < 0 || strategyLoad(&strategies[1], argv[3]) < 0) {
+      printf("Cannot load strategies %s %s\n", argv[2], argv[3]);
+      return 1;
+    }
+  }
+  else {
+    strategyParse(&strategies[0], PLAYDOM_STRATEGY_0);
+    strategyParse(&strategies[1], PLAYDOM_STRATEGY_1);
+  }
+
   printf ("Starting game.\n");
 
   initializeGame(2, k, atoi(argv[1]), &G);
@@ -26,9 +62,7 @@ int main (int argc, char** argv) {
 	int councilPos = -1;
 	//int numRemodels = 0;
 	//int numMines = 0;
-	int numCouncils = 0;
 
-  int numSmithies = 0;
   //int numAdventurers = 0;
 
   while (!isGameOver(&G)) {
@@ -86,22 +120,10 @@ int main (int argc, char** argv) {
         }
       }
 
-      if (money >= 8) {
-        printf("0: bought province\n");
-        buyCard(province, &G);
-      }
-      else if (money >= 6) {
-        printf("0: bought gold\n");
-        buyCard(gold, &G);
-      }
-      else if ((money >= 4) && (numSmithies < 2)) {
-        printf("0: bought smithy\n");
-        buyCard(smithy, &G);
-        numSmithies++;
-      }
-      else if (money >= 3) {
-        printf("0: bought silver\n");
-        buyCard(silver, &G);
+      card = strategyChoose(&strategies[0], 0, money, turn, &G);
+      if (card >= 0) {
+        printf("0: bought %s\n", strategyCardId(card));
+        buyCard(card, &G);
       }
 
       printf("0: end turn\n");
@@ -186,39 +208,16 @@ else {
         }
       }
 
-      if (money >= 8) {
-        printf("1: bought province\n");
-        buyCard(province, &G);
-      }
-/*
-      else if ((money >= 6) && (numRemodels< 2)) {
-        printf("1: bought remodel\n");
-        buyCard(remodel, &G);
-        numRemodels++;
-*/  
-/*   
-      else if ((money >= 6) && (numMines< 2)) {
-        printf("1: bought remodel\n");
-        buyCard(mine, &G);
-        numMines++;
-*/
-       else if ((money >= 6) && (numCouncils< 2)) {
-        printf("1: bought council room\n");
-        buyCard(council_room, &G);
-        numCouncils++;
-     
-      }
-      else if (money >= 6){
-        printf("1: bought gold\n");
-	    buyCard(gold, &G);
-        }
-      else if (money >= 3){
-        printf("1: bought silver\n");
-	    buyCard(silver, &G);
+      //remodel/mine variants: swap council_room in the seat 1 strategy
+      card = strategyChoose(&strategies[1], 1, money, turn, &G);
+      if (card >= 0) {
+        printf("1: bought %s\n", strategyCardId(card));
+        buyCard(card, &G);
       }
       printf("1: endTurn\n");
 
       endTurn(&G);
+      turn++;
     }
 
 
@@ -228,5 +227,13 @@ else {
   printf ("Finished game.\n");
   printf ("Player 0: %d\nPlayer 1: %d\n", scoreFor(0, &G), scoreFor(1, &G));
 
+#ifdef DOM_PROFILE
+  {
+    struct cardProfile totals;
+    profileMerge(&totals);
+    profileDump(stderr, &totals);
+  }
+#endif
+
   return 0;
 }
@@ -17,6 +17,8 @@
 #include <math.h>
 #include "dominion.h"
 #include "interface.h"
+#include "latency.h"
+#include "drawodds.h"
 #include "rngs.h"
 
 
@@ -29,21 +31,233 @@ int main2(int argc, char *argv[]) {
 	getchar();
 }
 
+//Engine time per dispatched command; printed on exit, on "stat" and by bench mode
+enum LATENCY_KIND
+  {LAT_PLAY = 0,
+   LAT_BUY,
+   LAT_END,
+   LAT_BOT,	//a whole bot turn, buy and endTurn together
+   NUM_LATENCY
+  };
+
+static const char *latencyNames[NUM_LATENCY] = { "play", "buy", "end", "bot" };
+static struct latencyHistogram latency[NUM_LATENCY];
+
+#define ODDS_BUDGET 0.1		//seconds of rollouts behind each "odds" answer
+#define BENCH_P99_SLACK 1.5	//bench fails when a p99 grows past baseline * slack + floor
+#define BENCH_P99_FLOOR 200	//nanoseconds, so timer noise on tiny p99s is not a regression
+
+static void printLatency(FILE *out) {
+	int kind;
+	latencyDumpHeader(out);
+	for(kind = 0; kind < NUM_LATENCY; kind++) {
+		latencyDump(out, latencyNames[kind], &latency[kind]);
+	}
+}
+
+//Batch mode: play scripted games without the per-action printing
+#define BATCH_MAX_TURNS 1000	//bot-only games stop here as unfinished
+
+struct scriptCommand {
+	int command;
+	int arg0, arg1, arg2, arg3;
+};
+
+//Parse the whole script once so replays only walk the array
+static int loadScript(FILE *in, struct scriptCommand **script) {
+	char line[MAX_STRING_LENGTH];
+	char command[MAX_STRING_LENGTH];
+	int count = 0, capacity = 64;
+	struct scriptCommand *s = malloc(capacity * sizeof(struct scriptCommand));
+
+	while(s != NULL && fgets(line, MAX_STRING_LENGTH, in) != NULL) {
+		struct scriptCommand c = { CMD_UNKNOWN, UNUSED, UNUSED, UNUSED, UNUSED };
+		strcpy(command, "");
+		sscanf(line, "%s %d %d %d %d", command, &c.arg0, &c.arg1, &c.arg2, &c.arg3);
+		c.command = commandLookup(command);
+		if(c.command == CMD_UNKNOWN) continue;
+		if(count == capacity) {
+			capacity *= 2;
+			s = realloc(s, capacity * sizeof(struct scriptCommand));
+			if(s == NULL) break;
+		}
+		s[count++] = c;
+	}
+	*script = s;
+	return s == NULL ? FAILURE : count;
+}
+
+static void printSummary(int gameNum, int seed, int turnNum, const char *result, struct gameState *game) {
+	int players[MAX_PLAYERS];
+	int playerNum;
+
+	printf("game=%d seed=%d turns=%d result=%s scores=", gameNum, seed, turnNum, result);
+	for(playerNum = 0; playerNum < game->numPlayers; playerNum++) {
+		printf("%s%d", playerNum ? "," : "", scoreFor(playerNum, game));
+	}
+	getWinners(players, game);
+	printf(" winners=");
+	for(playerNum = 0; playerNum < game->numPlayers; playerNum++) {
+		if(players[playerNum] == WINNER) printf("%d", playerNum);
+	}
+	printf("\n");
+}
+
+static void runScript(struct scriptCommand *script, int count, int gameNum, int randomSeed, int kCards[10], int report) {
+	int isBot[MAX_PLAYERS];
+	int gameStarted = FALSE;
+	int turnNum = 0;
+	int currentPlayer, playerNum, i;
+	unsigned long long start;
+	struct gameState g;
+	struct gameState * game = &g;
+
+	memset(game, 0, sizeof(struct gameState));
+	memset(isBot, 0, sizeof(isBot));
+	initializeGame(2, kCards, randomSeed, game);
+
+	for(i = 0; i <= count; i++) {
+		//Let the bots catch up before the next scripted command
+		while(gameStarted == TRUE) {
+			currentPlayer = whoseTurn(game);
+			if(isGameOver(game)) {
+				if(report) printSummary(gameNum, randomSeed, turnNum, "over", game);
+				gameStarted = FALSE;
+			} else if(turnNum >= BATCH_MAX_TURNS) {
+				if(report) printSummary(gameNum, randomSeed, turnNum, "unfinished", game);
+				gameStarted = FALSE;
+			} else if(isBot[currentPlayer] == TRUE) {
+				start = latencyNow();
+				botBuyCard(currentPlayer, turnNum, game);
+				if(currentPlayer == (game->numPlayers -1)) turnNum++;
+				endTurn(game);
+				latencyRecord(&latency[LAT_BOT], latencyNow() - start);
+			} else {
+				break;
+			}
+		}
+		if(i == count) break;
+
+		currentPlayer = whoseTurn(game);
+		switch(script[i].command) {
+		case CMD_ADD:
+			addCardToHand(currentPlayer, script[i].arg0, game);
+			break;
+		case CMD_BUY:
+			start = latencyNow();
+			buyCard(script[i].arg0, game);
+			latencyRecord(&latency[LAT_BUY], latencyNow() - start);
+			break;
+		case CMD_END:
+			if(gameStarted == TRUE) {
+				if(currentPlayer == (game->numPlayers -1)) turnNum++;
+				start = latencyNow();
+				endTurn(game);
+				latencyRecord(&latency[LAT_END], latencyNow() - start);
+			}
+			break;
+		case CMD_EXIT:
+			i = count;
+			break;
+		case CMD_INIT:
+			memset(isBot, 0, sizeof(isBot));
+			for(playerNum = script[i].arg0 - script[i].arg1; playerNum < script[i].arg0; playerNum++) {
+				if(playerNum >= 0 && playerNum < MAX_PLAYERS) isBot[playerNum] = TRUE;
+			}
+			turnNum = 0;
+			gameStarted = initializeGame(script[i].arg0, kCards, randomSeed, game) == SUCCESS;
+			break;
+		case CMD_PLAY:
+			start = latencyNow();
+			playCard(script[i].arg0, script[i].arg1, script[i].arg2, script[i].arg3, game);
+			latencyRecord(&latency[LAT_PLAY], latencyNow() - start);
+			break;
+		case CMD_RESIGN:
+			if(gameStarted == TRUE) {
+				endTurn(game);
+				if(report) printSummary(gameNum, randomSeed, turnNum, "resigned", game);
+				gameStarted = FALSE;
+			}
+			break;
+		default:
+			//help, num, show, stat, supp and whos only print
+			break;
+		}
+	}
+
+	if(gameStarted == TRUE && report) printSummary(gameNum, randomSeed, turnNum, "unfinished", game);
+}
+
+//Compare this run's p99s with a listing saved from an earlier bench run
+static int checkBaseline(FILE *baseline) {
+	unsigned long long p99, old;
+	int kind, regressions = 0;
+
+	for(kind = 0; kind < NUM_LATENCY; kind++) {
+		if(latency[kind].count == 0) continue;
+		if(latencyReadP99(baseline, latencyNames[kind], &old) == FAILURE) continue;
+		p99 = latencyPercentile(&latency[kind], 99.0);
+		if(p99 > old * BENCH_P99_SLACK + BENCH_P99_FLOOR) {
+			printf("p99 regression: %s %lluns, baseline %lluns\n", latencyNames[kind], p99, old);
+			regressions++;
+		}
+	}
+	return regressions;
+}
+
+//-b replays a script once per game and prints each game's result;
+//-t replays it silently and reports the per-command latency instead
+static int runBatch(int argc, char* argv[]) {
+	//Default cards, as defined in playDom
+	int kCards[10] = {adventurer, gardens, embargo, village, minion, mine, cutpurse, sea_hag, tribute, smithy};
+	struct scriptCommand *script;
+	FILE *in = stdin;
+	FILE *baseline = NULL;
+	int bench = strcmp(argv[1], "-t") == 0;
+	int randomSeed, games = 1, count, gameNum;
+	int argi = 3;
+	int status = EXIT_SUCCESS;
+
+	if(argc < 3 || (randomSeed = atoi(argv[2])) <= 0) {
+		printf("Usage: player -b [integer random number seed] [-n games] [script file]\n");
+		printf("       player -t [integer random number seed] [-n games] script file [baseline]\n");
+		return EXIT_SUCCESS;
+	}
+	if(argi + 1 < argc && strcmp(argv[argi], "-n") == 0) {
+		games = atoi(argv[argi + 1]);
+		argi += 2;
+	}
+	if(argi < argc && (in = fopen(argv[argi], "r")) == NULL) {
+		perror(argv[argi]);
+		return EXIT_FAILURE;
+	}
+
+	if(bench && argi + 1 < argc && (baseline = fopen(argv[argi + 1], "r")) == NULL) {
+		perror(argv[argi + 1]);
+		return EXIT_FAILURE;
+	}
+
+	count = loadScript(in, &script);
+	if(in != stdin) fclose(in);
+	if(count == FAILURE) return EXIT_FAILURE;
+
+	//Each replay of the script is one game on the next seed
+	for(gameNum = 0; gameNum < games; gameNum++) {
+		runScript(script, count, gameNum + 1, randomSeed + gameNum, kCards, !bench);
+	}
+	free(script);
+
+	if(bench) {
+		printLatency(stdout);
+		if(baseline != NULL) {
+			if(checkBaseline(baseline) > 0) status = EXIT_FAILURE;
+			fclose(baseline);
+		}
+	}
+	return status;
+}
+
 int main(int argc, char* argv[]) {
-		char *add  = "add";
-	char *buyC = "buy";
-	char *endT = "end";
-	char *exit = "exit";
-	char *help = "help";
-	char *init = "init";
-	char *numH = "num";
-	char *play = "play";
-	char *resign  = "resi";
-	char *show = "show";
-	char *stat = "stat";
-	char *supply = "supp";
-	char *whos = "whos";
-		
 	char command[MAX_STRING_LENGTH];
 	char line[MAX_STRING_LENGTH];
 	char cardName[MAX_STRING_LENGTH];
@@ -58,8 +272,13 @@ int main(int argc, char* argv[]) {
 	int gameOver = FALSE;
 	int gameStarted = FALSE;
 	int turnNum = 0;
+	int done = FALSE;
+	unsigned long long start;
+	int printMode = PRINT_HUMAN;
+	char printData[PRINT_BUFFER_SIZE];
+	struct printBuffer buffer;
 
-	int randomSeed = atoi(argv[1]);
+	int randomSeed;
 
 	//Default cards, as defined in playDom
 	int kCards[10] = {adventurer, gardens, embargo, village, minion, mine, cutpurse, sea_hag, tribute, smithy};
@@ -68,12 +287,54 @@ int main(int argc, char* argv[]) {
 	struct gameState * game = &g;
 
 	memset(game,0,sizeof(struct gameState));
+
+	//-s: bots buy by a strategy file instead of the built-in ladder
+	if(argc >= 3 && strcmp(argv[1], "-s") == 0){
+		if(loadBotStrategy(argv[2]) == FAILURE){
+			printf("Cannot load strategy %s\n", argv[2]);
+			return EXIT_FAILURE;
+		}
+		argv += 2;
+		argc -= 2;
+	}
+
+	//-w: bots score their buys with a value network instead
+	if(argc >= 3 && strcmp(argv[1], "-w") == 0){
+		if(loadBotNet(argv[2]) == FAILURE){
+			printf("Cannot load weights %s\n", argv[2]);
+			return EXIT_FAILURE;
+		}
+		argv += 2;
+		argc -= 2;
+	}
+
+	//-e: bots search this many endgame positions per buy near the end
+	if(argc >= 3 && strcmp(argv[1], "-e") == 0){
+		setBotEndgameNodes(atol(argv[2]));
+		argv += 2;
+		argc -= 2;
+	}
+
+	if(argc >= 2 && (strcmp(argv[1], "-b") == 0 || strcmp(argv[1], "-t") == 0)){
+		return runBatch(argc, argv);
+	}
+
+	//-c: compact one-line snapshots for log scrapers
+	if(argc >= 2 && strcmp(argv[1], "-c") == 0){
+		printMode = PRINT_COMPACT;
+		setPrintMode(printMode);
+		argv++;
+		argc--;
+	}
 		
 	if(argc != 2){
-		printf("Usage: player [integer random number seed]\n");
+		printf("Usage: player [-s strategy file] [-w weights file] [-e endgame nodes] [-c] [integer random number seed]\n");
+		printf("       player [-s strategy file] [-w weights file] [-e endgame nodes] -b [integer random number seed] [-n games] [script file]\n");
+		printf("       player [-s strategy file] [-w weights file] [-e endgame nodes] -t [integer random number seed] [-n games] script file [baseline]\n");
 		return EXIT_SUCCESS;
 	}
 
+	randomSeed = atoi(argv[1]);
 	if(randomSeed <= 0){
 		printf("Usage: player [integer random number seed]\n");
 		return EXIT_SUCCESS;
@@ -84,7 +345,7 @@ int main(int argc, char* argv[]) {
 	printf("Please enter a command or \"help\" for commands\n");
 	
 
-	while(TRUE) {
+	while(done == FALSE) {
 		int arg0 = UNUSED;
 		int arg1 = UNUSED;
 		int arg2 = UNUSED;
@@ -106,11 +367,17 @@ int main(int argc, char* argv[]) {
 			for(playerNum = 0; playerNum < game->numPlayers; playerNum++){
 				if(players[playerNum] == WINNER) printf("Player %d\n", playerNum);
 			}
-		for(playerNum = 0; playerNum < game->numPlayers; playerNum++){
-				printHand(playerNum, game);
-				printPlayed(playerNum, game);
-				printDiscard(playerNum, game);
-				printDeck(playerNum, game);
+			//Each player's cards as one snapshot; all of them together
+			//can outgrow the buffer
+			printBufferInit(&buffer, printData, PRINT_BUFFER_SIZE, printMode);
+			for(playerNum = 0; playerNum < game->numPlayers; playerNum++){
+				formatHand(&buffer, playerNum, game);
+				formatPlayed(&buffer, playerNum, game);
+				formatDiscard(&buffer, playerNum, game);
+				formatDeck(&buffer, playerNum, game);
+				if(printBufferFlush(&buffer, stdout) == FAILURE) {
+					fprintf(stderr, "player: listing for player %d was cut short\n", playerNum);
+				}
 			}
 			
 			break; //Exit out of the game/while loop
@@ -118,7 +385,9 @@ int main(int argc, char* argv[]) {
 		
 
 		if(isBot[currentPlayer] == TRUE) {
+				start = latencyNow();
 				executeBotTurn(currentPlayer, &turnNum, game);
+				latencyRecord(&latency[LAT_BOT], latencyNow() - start);
 				continue;
 		}
 		
@@ -127,36 +396,40 @@ int main(int argc, char* argv[]) {
 		sscanf(line, "%s %d %d %d %d", command, &arg0, &arg1, &arg2, &arg3);
 
 
-		if(COMPARE(command, add) == 0) {
+		switch(commandLookup(command)) {
+		case CMD_ADD:
 			outcome = addCardToHand(currentPlayer, arg0, game);
 			cardNumToName(arg0, cardName);
 			printf("Player %d adds %s to their hand\n\n", currentPlayer, cardName);
-		} else
-		if(COMPARE(command, buyC) == 0) {
+			break;
+		case CMD_BUY:
+			start = latencyNow();
 			outcome = buyCard(arg0, game);
+			latencyRecord(&latency[LAT_BUY], latencyNow() - start);
 			cardNumToName(arg0, cardName);
 			if(outcome == SUCCESS){
 				printf("Player %d buys card %d, %s\n\n", currentPlayer, arg0, cardName);
 			} else {
 				printf("Player %d cannot buy card %d, %s\n\n", currentPlayer, arg0, cardName);
 			}
-		} else
-		if(COMPARE(command, endT) == 0) {
+			break;
+		case CMD_END:
 			if(gameStarted == TRUE) {
 				if(currentPlayer == (game->numPlayers -1)) turnNum++;
+				start = latencyNow();
 				endTurn(game);
+				latencyRecord(&latency[LAT_END], latencyNow() - start);
 				currentPlayer = whoseTurn(game);
 				printf("Player %d's turn number %d\n\n", currentPlayer, turnNum);
 			}
-
-		} else			
-		if(COMPARE(command, exit) == 0) {
 			break;
-		} else
-		if(COMPARE(command, help) == 0) {
+		case CMD_EXIT:
+			done = TRUE;
+			break;
+		case CMD_HELP:
 			printHelp();
-		} else
-		if(COMPARE(command, init) == 0) {
+			break;
+		case CMD_INIT: {
 			int numHuman = arg0 - arg1;
 			for(playerNum = numHuman; playerNum < arg0; playerNum++) {
 				isBot[playerNum] = TRUE;
@@ -169,48 +442,81 @@ int main(int argc, char* argv[]) {
 				currentPlayer = whoseTurn(game);
 				printf("Player %d's turn number %d\n\n", currentPlayer, turnNum);
 			}
-
-		} else
-		if(COMPARE(command, numH) == 0) {
+			break;
+		}
+		case CMD_NUM: {
 			int numCards = numHandCards(game);
 			printf("There are %d cards in your hand.\n", numCards);
-		} else
-		if(COMPARE(command, play) == 0) {
+			break;
+		}
+		case CMD_ODDS: {
+			struct winEstimate odds;
+			struct coinDistribution draw;
+			if(gameStarted == FALSE) continue;
+			botWinProbability(currentPlayer, turnNum, game, ODDS_BUDGET, &odds);
+			printf("Player %d wins %.1f%% (95%% interval %.1f%% - %.1f%%), %d rollouts in %.0fms",
+			       currentPlayer, 100 * odds.p, 100 * odds.low, 100 * odds.high,
+			       odds.rollouts, 1000 * odds.seconds);
+			if(odds.capped > 0) printf(", %d cut off at the turn cap", odds.capped);
+			printf("\n\n");
+			nextHandCoins(currentPlayer, game, &draw);
+			printf("Next hand: $5+ %.1f%%, $6+ %.1f%%, $8+ %.1f%%\n\n",
+			       100 * coinsAtLeast(&draw, 5), 100 * coinsAtLeast(&draw, 6),
+			       100 * coinsAtLeast(&draw, 8));
+			if(endgameNear(game)) {
+				struct endgameChoice endgame;
+				endgameSolve(currentPlayer, game, countHandCoins(currentPlayer, game), ODDS_BUDGET, 0, &endgame);
+				cardNumToName(endgame.card, cardName);
+				printf("Endgame: buy %s, wins %.1f%% (%d turns searched%s, %ld positions)\n\n",
+				       endgame.card == UNUSED ? "no victory card" : cardName, 100 * endgame.value,
+				       endgame.depth, endgame.exact ? ", exact" : "", endgame.nodes);
+			}
+			break;
+		}
+		case CMD_PLAY: {
 			int card = handCard(arg0,game);
+			start = latencyNow();
 			outcome = playCard(arg0, arg1, arg2, arg3, game);
+			latencyRecord(&latency[LAT_PLAY], latencyNow() - start);
 			cardNumToName(card, cardName);
 			if(outcome == SUCCESS){
 				printf("Player %d plays %s\n\n", currentPlayer, cardName);
 			} else {
 				printf("Player %d cannot play card %d\n\n", currentPlayer, arg0);
 			}
-
-		} else
-		if(COMPARE(command, resign) == 0) {
+			break;
+		}
+		case CMD_RESIGN:
 			endTurn(game);
 			printScores(game);
+			done = TRUE;
 			break;
-		} else
-		if(COMPARE(command, show) == 0) {
+		case CMD_SHOW:
 			if(gameStarted == FALSE) continue;
-			printHand(currentPlayer, game);
-			printPlayed(currentPlayer, game);
+			printBufferInit(&buffer, printData, PRINT_BUFFER_SIZE, printMode);
+			formatHand(&buffer, currentPlayer, game);
+			formatPlayed(&buffer, currentPlayer, game);
+			printBufferFlush(&buffer, stdout);
 			//printDiscard(currentPlayer, game);
 			//printDeck(currentPlayer, game);
-		} else
-		if(COMPARE(command, stat) == 0) {
+			break;
+		case CMD_STAT:
 			if(gameStarted == FALSE) continue;
 			printState(game);
-		} else
-		if(COMPARE(command, supply) == 0) {
+			printLatency(stdout);
+			break;
+		case CMD_SUPPLY:
 			printSupply(game);
-		} else
-		if(COMPARE(command, whos) == 0) {
+			break;
+		case CMD_WHOS: {
 			int playerNum =	whoseTurn(game);
 			printf("Player %d's turn\n", playerNum);
+			break;
+		}
 		} 
     	}
-	
+
+	printLatency(stdout);
     	return EXIT_SUCCESS;
 
 }
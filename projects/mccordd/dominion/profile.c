@@ -0,0 +1,105 @@
+/* 	Card Effect Profiling
+
+	Each thread counts into its own cardProfile so the hot path never
+	takes a lock; the per-thread blocks are chained together on first use
+	and only walked by profileReset()/profileMerge().
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "profile.h"
+
+struct profileThread {
+  struct cardProfile counts;
+  struct profileThread *next;
+};
+
+static struct profileThread *profileThreads = NULL;
+static pthread_mutex_t profileLock = PTHREAD_MUTEX_INITIALIZER;
+
+static __thread struct profileThread *profileMine = NULL;
+__thread int profileCard = PROFILE_NO_CARD;
+
+
+static struct cardProfile *profileCounts(void) {
+  if (profileMine == NULL) {
+    profileMine = calloc(1, sizeof(struct profileThread));
+    if (profileMine == NULL) {
+      abort();
+    }
+    pthread_mutex_lock(&profileLock);
+    profileMine->next = profileThreads;
+    profileThreads = profileMine;
+    pthread_mutex_unlock(&profileLock);
+  }
+  return &profileMine->counts;
+}
+
+unsigned long long profileNow(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+void profileRecord(int card, unsigned long long start) {
+  struct cardProfile *p = profileCounts();
+  if (card < 0 || card > treasure_map) {
+    card = PROFILE_NO_CARD;
+  }
+  p->calls[card]++;
+  p->ticks[card] += profileNow() - start;
+}
+
+void profileCountDraw(void) {
+  profileCounts()->draws[profileCard]++;
+}
+
+void profileCountShuffle(void) {
+  profileCounts()->shuffles[profileCard]++;
+}
+
+void profileReset(void) {
+  struct profileThread *t;
+  pthread_mutex_lock(&profileLock);
+  for (t = profileThreads; t != NULL; t = t->next) {
+    memset(&t->counts, 0, sizeof(struct cardProfile));
+  }
+  pthread_mutex_unlock(&profileLock);
+}
+
+void profileMerge(struct cardProfile *total) {
+  struct profileThread *t;
+  int i;
+
+  memset(total, 0, sizeof(struct cardProfile));
+  pthread_mutex_lock(&profileLock);
+  for (t = profileThreads; t != NULL; t = t->next) {
+    for (i = 0; i < PROFILE_SLOTS; i++) {
+      total->calls[i] += t->counts.calls[i];
+      total->draws[i] += t->counts.draws[i];
+      total->shuffles[i] += t->counts.shuffles[i];
+      total->ticks[i] += t->counts.ticks[i];
+    }
+  }
+  pthread_mutex_unlock(&profileLock);
+}
+
+int profileDump(FILE *out, struct cardProfile *p) {
+  int i;
+
+  fprintf(out, "#card calls draws shuffles ticks\n");
+  for (i = 0; i < PROFILE_SLOTS; i++) {
+    fprintf(out, "%d %lu %lu %lu %llu\n", i < PROFILE_NO_CARD ? i : -1,
+	    p->calls[i], p->draws[i], p->shuffles[i], p->ticks[i]);
+  }
+  return ferror(out) ? -1 : 0;
+}
@@ -0,0 +1,62 @@
+/* 	Card Effect Profiling
+
+	Optional hot-path counters for playCard()/cardEffect().  Build the
+	engine with -DDOM_PROFILE (and link profile.o) to enable them; without
+	the flag every hook below expands to nothing.
+*/
+
+#ifndef _PROFILE_H
+#define _PROFILE_H
+
+#include <stdio.h>
+#include "dominion.h"
+
+//One slot per card type plus one for work done outside any card effect
+//(turn-start draws in endTurn, initializeGame shuffles, ...)
+#define PROFILE_NO_CARD (treasure_map + 1)
+#define PROFILE_SLOTS (treasure_map + 2)
+
+struct cardProfile {
+  unsigned long calls[PROFILE_SLOTS];	 //cardEffect invocations
+  unsigned long draws[PROFILE_SLOTS];	 //drawCard calls made while resolving
+  unsigned long shuffles[PROFILE_SLOTS]; //shuffle calls made while resolving
+  unsigned long long ticks[PROFILE_SLOTS]; //rdtsc cycles (or ns) spent
+};
+
+#ifdef DOM_PROFILE
+
+extern __thread int profileCard;
+
+unsigned long long profileNow(void);
+void profileRecord(int card, unsigned long long start);
+void profileCountDraw(void);
+void profileCountShuffle(void);
+
+#define PROFILE_CARD_BEGIN(card) \
+  unsigned long long profileStart = profileNow(); profileCard = (card)
+#define PROFILE_CARD_END(card) \
+  profileRecord((card), profileStart); profileCard = PROFILE_NO_CARD
+#define PROFILE_DRAW() profileCountDraw()
+#define PROFILE_SHUFFLE() profileCountShuffle()
+
+#else
+
+#define PROFILE_CARD_BEGIN(card)
+#define PROFILE_CARD_END(card)
+#define PROFILE_DRAW()
+#define PROFILE_SHUFFLE()
+
+#endif
+
+void profileReset(void);
+/* Zero the counters of every thread that has recorded anything */
+
+void profileMerge(struct cardProfile *total);
+/* Sum the counters of every thread into total (overwritten) */
+
+int profileDump(FILE *out, struct cardProfile *p);
+/* Write p as one line per slot:  card calls draws shuffles ticks
+   The layout is fixed so two dumps can be compared with diff.  Returns
+   -1 if the write failed */
+
+#endif
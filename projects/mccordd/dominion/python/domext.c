@@ -0,0 +1,633 @@
+/* 	Python Extension
+
+	domext.Batch is a block of games on the dominion.c engine, stepped
+	together in C.  Every gameState field is exposed as an attribute
+	holding a memoryview straight onto the states, with the games as the
+	first axis: batch.supplyCount has shape (games, 27), batch.hand
+	(games, MAX_PLAYERS, MAX_HAND), batch.coins (games,).  The views are
+	strided over the array of states rather than copied, so
+	numpy.asarray(batch.hand) is a live, writable view of every hand;
+	whatever the engine does to the games shows up in it.
+
+	The stepping methods drop the GIL while the engine runs, so Python
+	threads each driving their own batch run in parallel.  A batch is
+	stepped by one thread at a time (another gets RuntimeError), and its
+	views should not be read while it is being stepped.  Each game keeps
+	its own random stream, so a game's play depends only on its seed and
+	its own moves, whichever thread steps it.
+
+	Build with "make python" (setup.py build_ext --inplace).
+*/
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dominion.h"
+#include "rngs.h"
+#include "simulate.h"
+#include "strategy.h"
+
+#define DOMEXT_STREAM 1		//the rngs.c stream the engine uses
+#define DOMEXT_CARDS (treasure_map + 1)
+#define DOMEXT_ALIGN 64		//the states start on a cache line
+
+//One gameState field, viewed across the games
+struct field {
+  const char *name;
+  size_t offset;
+  int ndim;			//past the game axis
+  Py_ssize_t shape[2];
+};
+
+#define SCALAR(f) { #f, offsetof(struct gameState, f), 0, {0, 0} }
+#define ARRAY(f, n) { #f, offsetof(struct gameState, f), 1, {n, 0} }
+#define TABLE(f, n, m) { #f, offsetof(struct gameState, f), 2, {n, m} }
+
+static const struct field fields[] = {
+  SCALAR(numPlayers),
+  ARRAY(supplyCount, DOMEXT_CARDS),
+  ARRAY(embargoTokens, DOMEXT_CARDS),
+  SCALAR(outpostPlayed),
+  SCALAR(outpostTurn),
+  SCALAR(whoseTurn),
+  SCALAR(phase),
+  SCALAR(numActions),
+  SCALAR(coins),
+  SCALAR(numBuys),
+  TABLE(hand, MAX_PLAYERS, MAX_HAND),
+  ARRAY(handCount, MAX_PLAYERS),
+  TABLE(deck, MAX_PLAYERS, MAX_DECK),
+  ARRAY(deckCount, MAX_PLAYERS),
+  TABLE(discard, MAX_PLAYERS, MAX_DECK),
+  ARRAY(discardCount, MAX_PLAYERS),
+  ARRAY(playedCards, MAX_DECK),
+  SCALAR(playedCardCount)
+};
+
+#define NUM_FIELDS ((int)(sizeof(fields) / sizeof(fields[0])))
+
+typedef struct {
+  PyObject_HEAD
+  int count;
+  int numPlayers;
+  int kingdom[10];
+  struct gameState *states;	//one array from posix_memalign(), freed with free()
+  long *rngs;			//each game's stream, between calls
+  int *turns;			//rounds completed
+  struct strategy strategies[MAX_PLAYERS];
+  int busy;			//being stepped with the GIL released
+} BatchObject;
+
+typedef struct {
+  PyObject_HEAD
+  BatchObject *batch;
+  const struct field *field;
+  Py_ssize_t shape[3];
+  Py_ssize_t strides[3];
+} ViewObject;
+
+static PyTypeObject BatchType;
+static PyTypeObject ViewType;
+
+static const int defaultKingdom[10] = {
+  adventurer, council_room, feast, gardens, mine, remodel, smithy, village, baron, great_hall
+};
+
+
+/* ---- views ---- */
+
+static int viewGetBuffer(PyObject *self, Py_buffer *view, int flags) {
+  ViewObject *v = (ViewObject*)self;
+  int i;
+
+  if ((flags & PyBUF_STRIDES) != PyBUF_STRIDES) {
+    PyErr_SetString(PyExc_BufferError, "domext views are strided across the games");
+    return -1;
+  }
+  view->buf = (char*)v->batch->states + v->field->offset;
+  view->obj = self;
+  Py_INCREF(self);
+  view->readonly = 0;
+  view->itemsize = sizeof(int);
+  view->format = (flags & PyBUF_FORMAT) ? "i" : NULL;
+  view->ndim = 1 + v->field->ndim;
+  view->shape = v->shape;
+  view->strides = v->strides;
+  view->suboffsets = NULL;
+  view->internal = NULL;
+  view->len = sizeof(int);
+  for (i = 0; i < view->ndim; i++) {
+    view->len *= v->shape[i];
+  }
+  return 0;
+}
+
+
+static void viewDealloc(ViewObject *v) {
+  Py_XDECREF(v->batch);
+  Py_TYPE(v)->tp_free((PyObject*)v);
+}
+
+
+static PyBufferProcs viewBuffer = { viewGetBuffer, NULL };
+
+static PyTypeObject ViewType = {
+  PyVarObject_HEAD_INIT(NULL, 0)
+  .tp_name = "domext.StateView",
+  .tp_basicsize = sizeof(ViewObject),
+  .tp_dealloc = (destructor)viewDealloc,
+  .tp_as_buffer = &viewBuffer,
+  .tp_flags = Py_TPFLAGS_DEFAULT,
+  .tp_doc = "Buffer exporter for one gameState field across a Batch",
+};
+
+
+//A memoryview of field, through a StateView that keeps the batch alive
+static PyObject *batchField(PyObject *self, void *closure) {
+  BatchObject *batch = (BatchObject*)self;
+  const struct field *field = closure;
+  ViewObject *v;
+  PyObject *memory;
+  int i;
+
+  if (batch->states == NULL) {
+    PyErr_SetString(PyExc_RuntimeError, "Batch is not initialized");
+    return NULL;
+  }
+  v = PyObject_New(ViewObject, &ViewType);
+  if (v == NULL) {
+    return NULL;
+  }
+  Py_INCREF(batch);
+  v->batch = batch;
+  v->field = field;
+  v->shape[0] = batch->count;
+  v->strides[0] = sizeof(struct gameState);
+  for (i = 0; i < field->ndim; i++) {
+    v->shape[1 + i] = field->shape[i];
+  }
+  if (field->ndim == 2) {
+    v->strides[1] = field->shape[1] * sizeof(int);
+    v->strides[2] = sizeof(int);
+  } else if (field->ndim == 1) {
+    v->strides[1] = sizeof(int);
+  }
+  memory = PyMemoryView_FromObject((PyObject*)v);
+  Py_DECREF(v);
+  return memory;
+}
+
+
+/* ---- stepping, with the GIL released ---- */
+
+static void enterGame(BatchObject *batch, int game) {
+  SelectStream(DOMEXT_STREAM);
+  PutSeed(batch->rngs[game]);
+}
+
+
+static void leaveGame(BatchObject *batch, int game) {
+  GetSeed(&batch->rngs[game]);
+}
+
+
+static int resetGames(BatchObject *batch, int seed) {
+  struct gamePrototype prototype;
+  int i;
+
+  if (initializePrototype(batch->numPlayers, batch->kingdom, &prototype) != 0) {
+    return -1;
+  }
+  for (i = 0; i < batch->count; i++) {
+    memset(&batch->states[i], 0, sizeof(struct gameState));
+    initializeFromPrototype(&prototype, seed + i, &batch->states[i]);
+    GetSeed(&batch->rngs[i]);
+    batch->turns[i] = 0;
+  }
+  return 0;
+}
+
+
+static int endGameTurn(BatchObject *batch, int game) {
+  struct gameState *state = &batch->states[game];
+
+  if (whoseTurn(state) == state->numPlayers - 1) {
+    batch->turns[game]++;
+  }
+  return endTurn(state);
+}
+
+
+//Up to n automatic turns of every game not over or past maxTurns; returns games over
+static int autoTurns(BatchObject *batch, int n, int maxTurns) {
+  struct gameState *state;
+  int i, t, over = 0;
+
+  for (i = 0; i < batch->count; i++) {
+    state = &batch->states[i];
+    enterGame(batch, i);
+    for (t = 0; t < n && !isGameOver(state) && batch->turns[i] < maxTurns; t++) {
+      simulateTurn(&batch->strategies[whoseTurn(state)], state, batch->turns[i]);
+      endGameTurn(batch, i);
+    }
+    leaveGame(batch, i);
+    over += isGameOver(state) != 0;
+  }
+  return over;
+}
+
+
+//Claim the batch for a call that releases the GIL
+static int claim(BatchObject *batch) {
+  if (batch->states == NULL) {
+    PyErr_SetString(PyExc_RuntimeError, "Batch is not initialized");
+    return -1;
+  }
+  if (batch->busy) {
+    PyErr_SetString(PyExc_RuntimeError, "Batch is being stepped by another thread");
+    return -1;
+  }
+  batch->busy = 1;
+  return 0;
+}
+
+
+/* ---- Batch ---- */
+
+static int parseStrategies(BatchObject *batch, PyObject *strategy) {
+  PyObject *item;
+  const char *text;
+  int i;
+
+  for (i = 0; i < MAX_PLAYERS; i++) {
+    if (strategy == NULL || strategy == Py_None) {
+      text = STRATEGY_DEFAULT;
+    } else if (PyUnicode_Check(strategy)) {
+      text = PyUnicode_AsUTF8(strategy);
+    } else {
+      item = PySequence_GetItem(strategy, i < batch->numPlayers ? i : 0);
+      if (item == NULL) {
+	return -1;
+      }
+      text = PyUnicode_Check(item) ? PyUnicode_AsUTF8(item) : NULL;
+      Py_DECREF(item);
+      if (text == NULL) {
+	PyErr_SetString(PyExc_TypeError, "strategy must be a string or one string per seat");
+	return -1;
+      }
+    }
+    if (text == NULL) {
+      return -1;
+    }
+    if (strategyParse(&batch->strategies[i], text) != 0) {
+      PyErr_SetString(PyExc_ValueError, "malformed strategy text");
+      return -1;
+    }
+  }
+  return 0;
+}
+
+
+//Free a batch's games, whichever of them were allocated
+static void freeGames(BatchObject *self) {
+  free(self->states);
+  PyMem_RawFree(self->rngs);
+  PyMem_RawFree(self->turns);
+  self->states = NULL;
+  self->rngs = NULL;
+  self->turns = NULL;
+}
+
+
+static int batchInit(BatchObject *self, PyObject *args, PyObject *kwds) {
+  static char *keywords[] = { "games", "players", "kingdom", "seed", "strategy", NULL };
+  PyObject *kingdom = NULL, *strategy = NULL, *item;
+  int games, players = 2, seed = 1, i, status;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "i|iOiO", keywords,
+				   &games, &players, &kingdom, &seed, &strategy)) {
+    return -1;
+  }
+  if (self->states != NULL) {
+    PyErr_SetString(PyExc_RuntimeError, "Batch is already initialized");
+    return -1;
+  }
+  if (games < 1 || players < 2 || players > MAX_PLAYERS || seed < 1 || seed > 0x7fffffff - games) {
+    PyErr_SetString(PyExc_ValueError, "need games >= 1, 2..4 players and a positive seed");
+    return -1;
+  }
+  self->count = games;
+  self->numPlayers = players;
+  memcpy(self->kingdom, defaultKingdom, sizeof(self->kingdom));
+  if (kingdom != NULL && kingdom != Py_None) {
+    if (!PySequence_Check(kingdom) || PySequence_Size(kingdom) != 10) {
+      PyErr_SetString(PyExc_ValueError, "kingdom must be 10 card numbers");
+      return -1;
+    }
+    for (i = 0; i < 10; i++) {
+      item = PySequence_GetItem(kingdom, i);
+      self->kingdom[i] = item ? (int)PyLong_AsLong(item) : -1;
+      Py_XDECREF(item);
+      if (PyErr_Occurred()) {
+	return -1;
+      }
+    }
+  }
+  if (parseStrategies(self, strategy) == -1) {
+    return -1;
+  }
+  if (posix_memalign((void**)&self->states, DOMEXT_ALIGN, sizeof(struct gameState) * (size_t)games) != 0) {
+    self->states = NULL;
+  }
+  self->rngs = PyMem_RawMalloc(sizeof(long) * (size_t)games);
+  self->turns = PyMem_RawMalloc(sizeof(int) * (size_t)games);
+  if (self->states == NULL || self->rngs == NULL || self->turns == NULL) {
+    freeGames(self);
+    PyErr_NoMemory();
+    return -1;
+  }
+  self->busy = 1;
+  Py_BEGIN_ALLOW_THREADS
+  status = resetGames(self, seed);
+  Py_END_ALLOW_THREADS
+  self->busy = 0;
+  if (status == -1) {
+    freeGames(self);
+    PyErr_SetString(PyExc_ValueError, "initializeGame() refused the kingdom");
+    return -1;
+  }
+  return 0;
+}
+
+
+static void batchDealloc(BatchObject *self) {
+  freeGames(self);
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+
+static PyObject *batchReset(BatchObject *self, PyObject *args) {
+  int seed, status;
+
+  if (!PyArg_ParseTuple(args, "i", &seed)) {
+    return NULL;
+  }
+  if (seed < 1 || seed > 0x7fffffff - self->count) {
+    PyErr_SetString(PyExc_ValueError, "seed must be positive");
+    return NULL;
+  }
+  if (claim(self) == -1) {
+    return NULL;
+  }
+  Py_BEGIN_ALLOW_THREADS
+  status = resetGames(self, seed);
+  Py_END_ALLOW_THREADS
+  self->busy = 0;
+  if (status == -1) {
+    PyErr_SetString(PyExc_ValueError, "initializeGame() refused the kingdom");
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
+
+static PyObject *batchAutoTurns(BatchObject *self, PyObject *args) {
+  int n = 1, over;
+
+  if (!PyArg_ParseTuple(args, "|i", &n)) {
+    return NULL;
+  }
+  if (claim(self) == -1) {
+    return NULL;
+  }
+  Py_BEGIN_ALLOW_THREADS
+  over = autoTurns(self, n, 0x7fffffff);
+  Py_END_ALLOW_THREADS
+  self->busy = 0;
+  return PyLong_FromLong(over);
+}
+
+
+static PyObject *batchRun(BatchObject *self, PyObject *args) {
+  int maxTurns = SIMULATE_MAX_TURNS, over;
+
+  if (!PyArg_ParseTuple(args, "|i", &maxTurns)) {
+    return NULL;
+  }
+  if (claim(self) == -1) {
+    return NULL;
+  }
+  Py_BEGIN_ALLOW_THREADS
+  over = autoTurns(self, 0x7fffffff, maxTurns);
+  Py_END_ALLOW_THREADS
+  self->busy = 0;
+  return PyLong_FromLong(over);
+}
+
+
+static PyObject *batchBuy(BatchObject *self, PyObject *args) {
+  PyObject *cards, *fast;
+  int *choice;
+  int i, bought = 0;
+
+  if (!PyArg_ParseTuple(args, "O", &cards)) {
+    return NULL;
+  }
+  fast = PySequence_Fast(cards, "buy() takes one card number per game");
+  if (fast == NULL) {
+    return NULL;
+  }
+  if (PySequence_Fast_GET_SIZE(fast) != self->count) {
+    Py_DECREF(fast);
+    PyErr_SetString(PyExc_ValueError, "buy() takes one card number per game, -1 for none");
+    return NULL;
+  }
+  choice = PyMem_RawMalloc(sizeof(int) * (size_t)self->count);
+  if (choice == NULL) {
+    Py_DECREF(fast);
+    return PyErr_NoMemory();
+  }
+  for (i = 0; i < self->count; i++) {
+    choice[i] = (int)PyLong_AsLong(PySequence_Fast_GET_ITEM(fast, i));
+  }
+  Py_DECREF(fast);
+  if (PyErr_Occurred() || claim(self) == -1) {
+    PyMem_RawFree(choice);
+    return NULL;
+  }
+  Py_BEGIN_ALLOW_THREADS
+  for (i = 0; i < self->count; i++) {
+    if (choice[i] >= curse && choice[i] < DOMEXT_CARDS && buyCard(choice[i], &self->states[i]) == 0) {
+      bought++;
+    }
+  }
+  Py_END_ALLOW_THREADS
+  self->busy = 0;
+  PyMem_RawFree(choice);
+  return PyLong_FromLong(bought);
+}
+
+
+static PyObject *batchEndTurn(BatchObject *self, PyObject *unused) {
+  int i;
+
+  if (claim(self) == -1) {
+    return NULL;
+  }
+  Py_BEGIN_ALLOW_THREADS
+  for (i = 0; i < self->count; i++) {
+    enterGame(self, i);
+    endGameTurn(self, i);
+    leaveGame(self, i);
+  }
+  Py_END_ALLOW_THREADS
+  self->busy = 0;
+  Py_RETURN_NONE;
+}
+
+
+//A fresh (games, players) int memoryview
+static PyObject *newTable(int rows, int columns, int **data) {
+  PyObject *bytes, *memory, *shaped, *shape;
+
+  bytes = PyByteArray_FromStringAndSize(NULL, (Py_ssize_t)rows * columns * sizeof(int));
+  if (bytes == NULL) {
+    return NULL;
+  }
+  *data = (int*)PyByteArray_AS_STRING(bytes);
+  memory = PyMemoryView_FromObject(bytes);
+  Py_DECREF(bytes);
+  if (memory == NULL) {
+    return NULL;
+  }
+  shape = Py_BuildValue("(ii)", rows, columns);
+  shaped = shape ? PyObject_CallMethod(memory, "cast", "sO", "i", shape) : NULL;
+  Py_XDECREF(shape);
+  Py_DECREF(memory);
+  return shaped;
+}
+
+
+static PyObject *batchScores(BatchObject *self, PyObject *unused) {
+  PyObject *table;
+  int *scores;
+  int i, p;
+
+  table = newTable(self->count, self->numPlayers, &scores);
+  if (table == NULL || claim(self) == -1) {
+    Py_XDECREF(table);
+    return NULL;
+  }
+  Py_BEGIN_ALLOW_THREADS
+  for (i = 0; i < self->count; i++) {
+    for (p = 0; p < self->numPlayers; p++) {
+      scores[i * self->numPlayers + p] = scoreFor(p, &self->states[i]);
+    }
+  }
+  Py_END_ALLOW_THREADS
+  self->busy = 0;
+  return table;
+}
+
+
+static PyObject *batchTurns(BatchObject *self, PyObject *unused) {
+  PyObject *table;
+  int *turns;
+
+  table = newTable(self->count, 1, &turns);
+  if (table != NULL) {
+    memcpy(turns, self->turns, sizeof(int) * self->count);
+  }
+  return table;
+}
+
+
+static Py_ssize_t batchLength(PyObject *self) {
+  return ((BatchObject*)self)->count;
+}
+
+
+static PyMethodDef batchMethods[] = {
+  { "reset", (PyCFunction)batchReset, METH_VARARGS,
+    "reset(seed): start every game again, game i on seed + i" },
+  { "auto_turns", (PyCFunction)batchAutoTurns, METH_VARARGS,
+    "auto_turns(n=1): n turns of every unfinished game, actions as simulations play them\n"
+    "and buys by the strategy; returns how many games are over" },
+  { "run", (PyCFunction)batchRun, METH_VARARGS,
+    "run(max_turns=100): play every game to its end or max_turns rounds; returns how many ended" },
+  { "buy", (PyCFunction)batchBuy, METH_VARARGS,
+    "buy(cards): game i buys cards[i] (-1 for nothing); returns how many buys succeeded" },
+  { "end_turn", (PyCFunction)batchEndTurn, METH_NOARGS,
+    "end_turn(): every game ends its current turn" },
+  { "scores", (PyCFunction)batchScores, METH_NOARGS,
+    "scores(): a new (games, players) memoryview of scoreFor()" },
+  { "turns", (PyCFunction)batchTurns, METH_NOARGS,
+    "turns(): a new (games, 1) memoryview of rounds completed" },
+  { NULL, NULL, 0, NULL }
+};
+
+//Filled in from fields[] when the module loads
+static PyGetSetDef batchFields[NUM_FIELDS + 1];
+
+static PySequenceMethods batchSequence = { .sq_length = batchLength };
+
+static PyTypeObject BatchType = {
+  PyVarObject_HEAD_INIT(NULL, 0)
+  .tp_name = "domext.Batch",
+  .tp_basicsize = sizeof(BatchObject),
+  .tp_dealloc = (destructor)batchDealloc,
+  .tp_as_sequence = &batchSequence,
+  .tp_flags = Py_TPFLAGS_DEFAULT,
+  .tp_doc = "Batch(games, players=2, kingdom=None, seed=1, strategy=None)\n\n"
+	    "games games on one kingdom, game i on seed + i.  strategy is strategy text\n"
+	    "for every seat, or one text per seat.  Each gameState field is an attribute\n"
+	    "holding a live memoryview with the games as its first axis.",
+  .tp_methods = batchMethods,
+  .tp_getset = batchFields,
+  .tp_init = (initproc)batchInit,
+  .tp_new = PyType_GenericNew,
+};
+
+
+/* ---- module ---- */
+
+static struct PyModuleDef domextModule = {
+  PyModuleDef_HEAD_INIT, "domext",
+  "Batches of Dominion games with zero-copy views of their states", -1, NULL
+};
+
+
+PyMODINIT_FUNC PyInit_domext(void) {
+  PyObject *module, *cards;
+  int i;
+
+  for (i = 0; i < NUM_FIELDS; i++) {
+    batchFields[i].name = fields[i].name;
+    batchFields[i].get = batchField;
+    batchFields[i].doc = NULL;
+    batchFields[i].closure = (void*)&fields[i];
+  }
+  if (PyType_Ready(&ViewType) < 0 || PyType_Ready(&BatchType) < 0) {
+    return NULL;
+  }
+  module = PyModule_Create(&domextModule);
+  if (module == NULL) {
+    return NULL;
+  }
+  cards = PyList_New(DOMEXT_CARDS);
+  for (i = 0; cards != NULL && i < DOMEXT_CARDS; i++) {
+    PyList_SET_ITEM(cards, i, PyUnicode_FromString(strategyCardId(i)));
+  }
+  Py_INCREF(&BatchType);
+  if (cards == NULL || PyModule_AddObject(module, "CARDS", cards) < 0
+      || PyModule_AddObject(module, "Batch", (PyObject*)&BatchType) < 0
+      || PyModule_AddIntConstant(module, "MAX_PLAYERS", MAX_PLAYERS) < 0
+      || PyModule_AddIntConstant(module, "MAX_HAND", MAX_HAND) < 0
+      || PyModule_AddIntConstant(module, "MAX_DECK", MAX_DECK) < 0) {
+    Py_DECREF(module);
+    return NULL;
+  }
+  return module;
+}
@@ -0,0 +1,20 @@
+"""Build the domext extension over the engine sources one directory up:
+
+    python3 setup.py build_ext --inplace      (or "make python" from there)
+"""
+
+import os
+from setuptools import setup, Extension
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+ENGINE = os.path.dirname(HERE)
+SOURCES = ["dominion.c", "rngs.c", "statepool.c", "strategy.c", "simulate.c"]
+
+domext = Extension(
+    "domext",
+    sources=[os.path.join(HERE, "domext.c")] + [os.path.join(ENGINE, s) for s in SOURCES],
+    include_dirs=[ENGINE],
+    extra_compile_args=["-O2"],
+)
+
+setup(name="domext", version="1.0", ext_modules=[domext])
@@ -0,0 +1,93 @@
+"""Tests for domext: views are live and zero-copy, stepping repeats for a
+seed whichever thread does it, and batches step in parallel threads.
+Run with "make pythontest"."""
+
+import threading
+
+import domext
+
+passed = 0
+total = 0
+
+
+def check(name, ok):
+    global passed, total
+    total += 1
+    print("TEST %d: %s: " % (total, name))
+    if ok:
+        print("PASSED")
+        passed += 1
+    else:
+        print("TEST FAILED")
+
+
+print("****DOMEXT TESTS****")
+
+batch = domext.Batch(4, players=2, seed=7)
+supply = batch.supplyCount
+hand = batch.hand
+check("views have the games as their first axis",
+      len(batch) == 4 and supply.shape == (4, 27) and batch.coins.shape == (4,)
+      and hand.shape == (4, domext.MAX_PLAYERS, domext.MAX_HAND)
+      and supply[0, domext.CARDS.index("copper")] == 46 and batch.numPlayers.tolist() == [2] * 4)
+
+copper = domext.CARDS.index("copper")
+before = supply[2, copper]
+bought = batch.buy([copper, -1, copper, 99])
+supply[1, copper] = 13
+check("views see the engine's changes and the engine sees theirs",
+      bought == 2 and supply[2, copper] == before - 1 and supply[3, copper] == before
+      and batch.supplyCount[1, copper] == 13)
+
+del batch
+check("a view keeps its batch alive", supply[1, copper] == 13 and hand[0, 0, 0] >= 0)
+
+one = domext.Batch(3, seed=21)
+other = domext.Batch(3, seed=21)
+one.auto_turns(9)
+worker = threading.Thread(target=other.auto_turns, args=(9,))
+worker.start()
+worker.join()
+check("a seed plays the same on another thread",
+      one.hand.tolist() == other.hand.tolist() and one.deck.tolist() == other.deck.tolist()
+      and one.scores().tolist() == other.scores().tolist())
+
+batches = [domext.Batch(200, seed=1 + 1000 * i) for i in range(4)]
+ended = [0] * len(batches)
+
+
+def runBatch(i):
+    ended[i] = batches[i].run()
+
+
+threads = [threading.Thread(target=runBatch, args=(i,)) for i in range(len(batches))]
+for t in threads:
+    t.start()
+for t in threads:
+    t.join()
+alone = domext.Batch(200, seed=3001)
+check("batches play their games to the end on parallel threads",
+      ended == [200] * 4 and alone.run() == 200
+      and all(0 < row[0] < 100 for b in batches for row in b.turns().tolist())
+      and batches[3].scores().shape == (200, 2)
+      and batches[3].scores().tolist() == alone.scores().tolist()
+      and batches[3].turns().tolist() == alone.turns().tolist())
+
+try:
+    domext.Batch(2, strategy="bogus card\n")
+    refused = False
+except ValueError:
+    refused = True
+check("bad strategy text is refused", refused)
+
+retry = domext.Batch.__new__(domext.Batch)
+try:
+    retry.__init__(2, kingdom=[7] * 10)
+    refused = False
+except ValueError:
+    refused = True
+retry.__init__(2, seed=5)
+check("a refused kingdom frees its games and the batch can be set up again",
+      refused and len(retry) == 2 and retry.supplyCount[0, copper] == 46)
+
+print("\n****DOMEXT TESTS: PASSED %d of %d tests****" % (passed, total))
@@ -33,6 +33,7 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <time.h>
 #include "rngs.h"
 
@@ -42,10 +43,18 @@
 #define STREAMS    256        /* # of streams, DON'T CHANGE THIS VALUE    */
 #define A256       22925      /* jump multiplier, DON'T CHANGE THIS VALUE */
 #define DEFAULT    123456789  /* initial seed, use 0 < DEFAULT < MODULUS  */
+#define PERIOD     (MODULUS - 1)  /* MULTIPLIER is a primitive root        */
+#define BABY_STEPS 46341      /* ceil(sqrt(PERIOD)), for FindPosition     */
+#define BABY_TABLE 131072     /* hash slots for the baby steps, a power of 2 */
       
-static long seed[STREAMS] = {DEFAULT};  /* current state of each stream   */
-static int  stream        = 0;          /* stream index, 0 is the default */
-static int  initialized   = 0;          /* test for stream initialization */
+/* Generator state is per thread so games driven from different threads
+ * (domserver bot workers) never interleave one another's streams; a
+ * single-threaded program sees exactly the original behaviour.
+ */
+static __thread long seed[STREAMS] = {DEFAULT};  /* current state of each stream   */
+static __thread int  stream        = 0;          /* stream index, 0 is the default */
+static __thread int  initialized   = 0;          /* test for stream initialization */
+static __thread long origin[STREAMS] = {DEFAULT}; /* state at position 0 of each stream */
 
 
    double Random(void)
@@ -94,6 +103,7 @@ static int  initialized   = 0;          /* test for stream initialization */
       seed[j] = x;
     else
       seed[j] = x + MODULUS;
+    origin[j] = seed[j];
    }
 }
 
@@ -123,6 +133,7 @@ static int  initialized   = 0;          /* test for stream initialization */
         printf("\nInput out of range ... try again\n");
     }
   seed[stream] = x;
+  origin[stream] = x;
 }
 
 
@@ -150,6 +161,154 @@ static int  initialized   = 0;          /* test for stream initialization */
 }
 
 
+   static long MultiplyMod(long a, long b)
+/* ------------------------------------------------------------------
+ * a * b mod m, for 0 <= a, b < m.  The product fits in 64 bits.
+ * ------------------------------------------------------------------
+ */
+{
+  return (long) ((long long) a * b % MODULUS);
+}
+
+
+   static long PowerMod(long a, long n)
+/* ------------------------------------------------------------------
+ * a^n mod m by repeated squaring, for n >= 0.
+ * ------------------------------------------------------------------
+ */
+{
+  long r = 1;
+
+  while (n > 0) {
+    if (n & 1)
+      r = MultiplyMod(r, a);
+    a = MultiplyMod(a, a);
+    n >>= 1;
+  }
+  return r;
+}
+
+
+   static long ReducePosition(long n)
+/* ------------------------------------------------------------------
+ * n mod (m - 1) in 0 .. m - 2; a negative n counts backwards.
+ * ------------------------------------------------------------------
+ */
+{
+  n %= PERIOD;
+  return (n < 0) ? n + PERIOD : n;
+}
+
+
+   void SkipAhead(long n)
+/* ------------------------------------------------------------------
+ * Advance the current stream as if Random() had been called n times,
+ * in O(log n) steps: the state after n calls is state * a^n mod m.
+ * A negative n steps the stream back.
+ * ------------------------------------------------------------------
+ */
+{
+  seed[stream] = MultiplyMod(seed[stream], PowerMod(MULTIPLIER, ReducePosition(n)));
+}
+
+
+   void Seek(long n)
+/* ------------------------------------------------------------------
+ * Put the current stream at position n: the state it held after n
+ * calls to Random() following the last PutSeed() or PlantSeeds().
+ * ------------------------------------------------------------------
+ */
+{
+  seed[stream] = MultiplyMod(origin[stream], PowerMod(MULTIPLIER, ReducePosition(n)));
+}
+
+
+   long FindPosition(long x)
+/* ------------------------------------------------------------------
+ * The first position, 0 .. m - 2, at which the current stream holds
+ * state x; Seek() to it and the next Random() follows x.  Solves
+ * origin * a^n = x (mod m) by baby-step giant-step: sqrt(m) powers
+ * of a in a hash table, then at most sqrt(m) strides of a^-sqrt(m).
+ * Returns -1 if x is not a state (0 < x < m) or memory runs out.
+ * ------------------------------------------------------------------
+ */
+{
+  long *keys;
+  int  *steps;
+  long  target, stride, v;
+  long  i, j, n = -1;
+  unsigned long h;
+
+  if (x <= 0 || x >= MODULUS)
+    return -1;
+  keys  = calloc(BABY_TABLE, sizeof(long));
+  steps = malloc(BABY_TABLE * sizeof(int));
+  if (keys == NULL || steps == NULL) {
+    free(keys);
+    free(steps);
+    return -1;
+  }
+
+  v = 1;                                        /* baby steps: a^j -> j  */
+  for (j = 0; j < BABY_STEPS; j++) {
+    for (h = v & (BABY_TABLE - 1); keys[h] != 0 && keys[h] != v; h = (h + 1) & (BABY_TABLE - 1))
+      ;
+    if (keys[h] == 0) {
+      keys[h]  = v;
+      steps[h] = (int) j;
+    }
+    v = MultiplyMod(v, MULTIPLIER);
+  }
+
+  target = MultiplyMod(x, PowerMod(origin[stream], MODULUS - 2));   /* x / origin */
+  stride = PowerMod(MULTIPLIER, PERIOD - BABY_STEPS);              /* a^-sqrt(m) */
+  for (i = 0; i <= BABY_STEPS && n < 0; i++) {
+    for (h = target & (BABY_TABLE - 1); keys[h] != 0; h = (h + 1) & (BABY_TABLE - 1))
+      if (keys[h] == target) {
+        n = i * BABY_STEPS + steps[h];
+        break;
+      }
+    target = MultiplyMod(target, stride);
+  }
+
+  free(keys);
+  free(steps);
+  return (n >= 0 && n < PERIOD) ? n : -1;
+}
+
+
+   long GetPosition(void)
+/* ------------------------------------------------------------------
+ * The position of the current stream: calls to Random() since its
+ * last PutSeed() or PlantSeeds(), modulo the period m - 1.
+ * ------------------------------------------------------------------
+ */
+{
+  return FindPosition(seed[stream]);
+}
+
+
+   void PutSubstream(long x, long index, long count)
+/* ------------------------------------------------------------------
+ * Split the sequence that starts at state x into count substreams of
+ * (m - 1) / count calls each, and put the current stream at the start
+ * of substream index.  Unlike PlantSeeds() this takes any number of
+ * substreams, one stream slot each, so every worker of a threaded run
+ * can own a disjoint piece of one seed's sequence.
+ * ------------------------------------------------------------------
+ */
+{
+  if (count < 1)
+    count = 1;
+  index %= count;
+  if (index < 0)
+    index += count;
+  PutSeed(x);
+  Seek(index * (PERIOD / count));
+  origin[stream] = seed[stream];
+}
+
+
    void TestRandom(void)
 /* ------------------------------------------------------------------
  * Use this (optional) function to test for a correct implementation.
@@ -158,13 +317,12 @@ static int  initialized   = 0;          /* test for stream initialization */
 {
   long   i;
   long   x;
-  double u;
   char   ok = 0;  
 
   SelectStream(0);                  /* select the default stream */
   PutSeed(1);                       /* and set the state to 1    */
   for(i = 0; i < 10000; i++)
-    u = Random();
+    Random();
   GetSeed(&x);                      /* get the new state value   */
   ok = (x == CHECK);                /* and check for correctness */
 
@@ -16,4 +16,10 @@ void   PutSeed(long x);
 void   SelectStream(int index);
 void   TestRandom(void);
 
+void   SkipAhead(long n);
+void   Seek(long n);
+long   FindPosition(long x);
+long   GetPosition(void);
+void   PutSubstream(long x, long index, long count);
+
 #endif
@@ -1,27 +1,50 @@
 #include "rngs.h"
 #include <stdio.h>
-#include <stdlib.h> 
+#include <stdlib.h>
+#include <math.h>
 
+#define MODULUS 2147483647
+#define SCALE 1000000000
+
+//Where floor(Random() * SCALE) first equals target, found without
+//running the generator: each state giving target is looked up with
+//FindPosition(), so the answer takes milliseconds however far it is.
 int main(int argc, char** argv) {
   if (argc < 3) {
     printf ("Not enough inputs:  seed target\n");
+    return 1;
   }
 
   SelectStream(1);
   PutSeed((long)atoi(argv[1]));
-  
-  int done = 0;
-  int c = 1000000000;
-  
-  while (!done) {
-    c = floor(Random() * 1000000000);
-    //    if (c % 100000 == 0) {
-    //      printf ("c = %d\n", c);
-    //    }
-    if (c == atoi(argv[2])) {
-      printf ("Found the bug!\n");
-      done = 1;
+
+  long target = atol(argv[2]);
+  long best = -1;
+  long x, n;
+
+  //The few states x whose Random() value x / m scales down to target
+  for (x = (long)((double)target * MODULUS / SCALE) - 2; x <= (long)((double)target * MODULUS / SCALE) + 3; x++) {
+    if (x <= 0 || x >= MODULUS || floor((double)x / MODULUS * SCALE) != target) {
+      continue;
+    }
+    n = FindPosition(x);
+    if (n == 0) {
+      n = MODULUS - 1;		//the seed itself comes round again after a full period
+    }
+    if (n > 0 && (best < 0 || n < best)) {
+      best = n;
     }
   }
-}
 
+  if (best < 0) {
+    printf ("No seed reaches %ld\n", target);
+    return 0;
+  }
+  //Check against the generator itself: the call before best, then one Random()
+  Seek(best - 1);
+  if (floor(Random() * SCALE) == target) {
+    printf ("Found the bug!\n");
+    printf ("Random() call %ld gives %ld\n", best, target);
+  }
+  return 0;
+}
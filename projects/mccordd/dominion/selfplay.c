@@ -0,0 +1,541 @@
+/* 	Self-Play Record Generator
+
+	Plays bot against bot on every core and writes one training record
+	per buy decision: the decider's feature row (featurevec.h) just
+	before the buy, the card bought, and how the game came out for that
+	seat.  Turns are played as the interactive bots play them: the
+	automatic actions (pickAction()), then botBuyCard() with its strategy
+	and endgame solver, then endTurn().
+
+	A game's records are kept by its thread until the game ends and the
+	outcome is known, then copied into batches.  Batches come from a
+	fixed pool and go through a queue to one writer thread, which
+	gzip-compresses them into shard files of -shard records each:
+
+	    struct shardHeader			once, at the start of the stream
+	    struct selfplayRecord[n]		n = (uncompressed size - header) / recordSize
+
+	A shard is written as <name>.tmp and renamed when it is full, so a
+	shard with its final name is always complete.  Memory is the batch
+	pool and one game per thread, however long the run.  When the writer
+	falls behind, the pool runs dry and game threads wait for a batch to
+	come back; the time spent waiting is reported, so a run that is
+	limited by the disk says so.  SIGINT or SIGTERM finishes the games in
+	progress, drains the queue and closes the last shard.
+
+	A game cut off at SIMULATE_MAX_TURNS has no outcome to learn from, so
+	it writes no records.  Such games are counted, and a run or a -dump
+	in which more than SELFPLAY_MAX_UNFINISHED percent of the games (or
+	records) are unfinished exits with a failure, since that means the
+	engine or the bots stopped finishing games.
+
+	-e lets the endgame solver search up to that many positions per buy
+	near the end (default 0, every buy to the strategy); a node count
+	rather than a time, so a seed writes the same shards every run.  -w has the bots buy by a value
+	network (evalnet.h), so a trained net can generate the next round
+	of records.
+
+	Usage:	selfplay [-j threads] [-games n] [-players n] [-shard records]
+			 [-o prefix] [-s seed] [-z level] [-b strategyFile] [-e nodes]
+			 [-w weightsFile]
+		selfplay -dump shardFile
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <signal.h>
+#include <pthread.h>
+#include <zlib.h>
+#include "dominion.h"
+#include "dominion_helpers.h"
+#include "interface.h"
+#include "simulate.h"
+#include "featurevec.h"
+
+#define SELFPLAY_MAGIC 0x44524148534d4f44ULL	//"DOMSHARD"
+#define SELFPLAY_VERSION 1
+#define SELFPLAY_BATCH 256			//records per batch
+#define SELFPLAY_POOL 64			//batches in memory, all threads together
+#define SELFPLAY_MAX_THREADS 256
+#define SELFPLAY_GAME_RECORDS (SIMULATE_MAX_TURNS * MAX_PLAYERS)
+#define SELFPLAY_KINGDOM_CARDS 20		//adventurer .. treasure_map
+#define SELFPLAY_MAX_UNFINISHED 10		//percent of games before a run fails
+
+struct shardHeader {
+  uint64_t magic;
+  uint32_t version;
+  uint32_t recordSize;		//sizeof(struct selfplayRecord)
+  uint32_t featureStride;	//FEATURE_STRIDE
+  uint32_t featureUsed;		//FEATURE_USED
+  uint32_t maxPlayers;		//MAX_PLAYERS, which fixes the feature offsets
+  uint32_t reserved;
+};
+
+struct selfplayRecord {
+  int8_t features[FEATURE_STRIDE];	//featuresInt8(), from the deciding seat
+  uint32_t game;
+  int16_t turn;
+  int16_t margin;	//seat's final score minus the best other seat's
+  int8_t seat;
+  int8_t action;	//card bought, -1 for none
+  int8_t outcome;	//2 won, 1 tied for first, 0 lost
+  int8_t finished;	//always 1: games cut off at the turn cap write no records
+  int8_t pad[4];
+};
+
+//The schema is the file format: fail the build if it moves
+typedef char recordSizeCheck[sizeof(struct selfplayRecord) == FEATURE_STRIDE + 16 ? 1 : -1];
+
+struct batch {
+  int count;
+  struct selfplayRecord records[SELFPLAY_BATCH];
+};
+
+//A ring of batch pointers; the pool and the write queue are one each
+struct batchQueue {
+  struct batch *slot[SELFPLAY_POOL];
+  int head, count;
+};
+
+static struct batchQueue freeBatches, fullBatches;
+static pthread_mutex_t queueLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t batchFree = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t batchFull = PTHREAD_COND_INITIALIZER;
+static int producersLeft;
+
+static volatile sig_atomic_t stopping;
+static long long gameLimit;		//0 runs until signalled
+static long long nextGame;
+static long long gamesDone;
+static long long gamesUnfinished;	//hit the turn cap, so no records written
+static long long recordsWritten;
+static long long stallNanos;		//game threads waiting for a free batch
+static int shardsWritten;
+static int numPlayers = 2;
+static int shardRecords = 1000000;
+static int gzLevel = 1;
+static unsigned int seed = 1;
+static const char *prefix = "selfplay";
+
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+static void push(struct batchQueue *q, struct batch *b) {
+  q->slot[(q->head + q->count) % SELFPLAY_POOL] = b;
+  q->count++;
+}
+
+
+static struct batch *pop(struct batchQueue *q) {
+  struct batch *b = q->slot[q->head];
+  q->head = (q->head + 1) % SELFPLAY_POOL;
+  q->count--;
+  return b;
+}
+
+
+static struct batch *takeFree(void) {
+  struct batch *b;
+  double start;
+
+  pthread_mutex_lock(&queueLock);
+  if (freeBatches.count == 0) {
+    start = now();
+    while (freeBatches.count == 0) {
+      pthread_cond_wait(&batchFree, &queueLock);
+    }
+    stallNanos += (long long)((now() - start) * 1e9);
+  }
+  b = pop(&freeBatches);
+  pthread_mutex_unlock(&queueLock);
+  b->count = 0;
+  return b;
+}
+
+
+static void sendFull(struct batch *b) {
+  pthread_mutex_lock(&queueLock);
+  push(&fullBatches, b);
+  pthread_cond_signal(&batchFull);
+  pthread_mutex_unlock(&queueLock);
+}
+
+
+//Ten distinct kingdom cards for game g, the same on every run with this seed
+static void pickKingdom(long long g, int kingdom[10]) {
+  int cards[SELFPLAY_KINGDOM_CARDS];
+  unsigned int x = seed * 2654435761u ^ (unsigned int)(g * 40503u + 1);
+  int i, j, t;
+
+  for (i = 0; i < SELFPLAY_KINGDOM_CARDS; i++) {
+    cards[i] = adventurer + i;
+  }
+  for (i = 0; i < 10; i++) {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    j = i + (int)(x % (unsigned int)(SELFPLAY_KINGDOM_CARDS - i));
+    t = cards[i];
+    cards[i] = cards[j];
+    cards[j] = t;
+    kingdom[i] = cards[i];
+  }
+}
+
+
+//Play game g, leaving one record per buy decision in records; returns the count
+static int playGame(long long g, struct gameState *state, struct selfplayRecord *records) {
+  int kingdom[10], scores[MAX_PLAYERS];
+  int count = 0, turn = 0, player, pos, card, best, other, i, p;
+
+  pickKingdom(g, kingdom);
+  memset(state, 0, sizeof(struct gameState));
+  if (initializeGame(numPlayers, kingdom, 1 + (int)((seed * 1000003LL + g) % 2000000000), state) != 0) {
+    return 0;
+  }
+
+  while (!isGameOver(state) && turn < SIMULATE_MAX_TURNS) {
+    player = whoseTurn(state);
+    while (state->numActions > 0 && (pos = pickAction(state)) >= 0) {
+      if (playCard(pos, -1, -1, -1, state) != 0) {
+	break;
+      }
+    }
+
+    featuresInt8(state, 1, &player, &turn, records[count].features);
+    card = botBuyCard(player, turn, state);
+    records[count].seat = (int8_t)player;
+    records[count].turn = (int16_t)turn;
+    records[count].action = (int8_t)card;
+    count++;
+
+    if (player == numPlayers - 1) {
+      turn++;
+    }
+    endTurn(state);
+  }
+  if (!isGameOver(state)) {
+    __sync_fetch_and_add(&gamesUnfinished, 1);
+    return 0;
+  }
+
+  for (p = 0; p < numPlayers; p++) {
+    scores[p] = scoreFor(p, state);
+  }
+  for (i = 0; i < count; i++) {
+    p = records[i].seat;
+    best = -1000000;
+    for (other = 0; other < numPlayers; other++) {
+      if (other != p && scores[other] > best) {
+	best = scores[other];
+      }
+    }
+    records[i].game = (uint32_t)g;
+    records[i].margin = (int16_t)(scores[p] - best);
+    records[i].outcome = scores[p] > best ? 2 : scores[p] == best ? 1 : 0;
+    records[i].finished = 1;
+    memset(records[i].pad, 0, sizeof(records[i].pad));
+  }
+  return count;
+}
+
+
+static void *gameThread(void *arg) {
+  struct gameState *state = malloc(sizeof(struct gameState));
+  struct selfplayRecord *records = malloc(sizeof(struct selfplayRecord) * SELFPLAY_GAME_RECORDS);
+  struct batch *b = NULL;
+  long long g;
+  int count, i, n;
+
+  (void)arg;
+  while (state != NULL && records != NULL && !stopping
+	 && (g = __sync_fetch_and_add(&nextGame, 1), gameLimit == 0 || g < gameLimit)) {
+    count = playGame(g, state, records);
+    for (i = 0; i < count; i += n) {
+      if (b == NULL) {
+	b = takeFree();
+      }
+      n = count - i;
+      if (n > SELFPLAY_BATCH - b->count) {
+	n = SELFPLAY_BATCH - b->count;
+      }
+      memcpy(&b->records[b->count], &records[i], sizeof(struct selfplayRecord) * n);
+      b->count += n;
+      if (b->count == SELFPLAY_BATCH) {
+	sendFull(b);
+	b = NULL;
+      }
+    }
+    __sync_fetch_and_add(&gamesDone, 1);
+  }
+
+  if (b != NULL) {
+    sendFull(b);
+  }
+  pthread_mutex_lock(&queueLock);
+  producersLeft--;
+  pthread_cond_signal(&batchFull);
+  pthread_mutex_unlock(&queueLock);
+  free(records);
+  free(state);
+  return NULL;
+}
+
+
+//The shard is written as tmpName, which has room for name and ".tmp", and
+//renamed to name when closed; a prefix too long for name fails
+static gzFile openShard(char *tmpName, size_t tmpSize, char *name, size_t size) {
+  struct shardHeader header;
+  char mode[8];
+  gzFile out;
+  int length;
+
+  length = snprintf(name, size, "%s-%05d.rec.gz", prefix, shardsWritten);
+  snprintf(tmpName, tmpSize, "%s.tmp", name);
+  if (length >= (int)size) {
+    return NULL;
+  }
+  snprintf(mode, sizeof(mode), "wb%d", gzLevel);
+  out = gzopen(tmpName, mode);
+  if (out == NULL) {
+    return NULL;
+  }
+  memset(&header, 0, sizeof(header));
+  header.magic = SELFPLAY_MAGIC;
+  header.version = SELFPLAY_VERSION;
+  header.recordSize = sizeof(struct selfplayRecord);
+  header.featureStride = FEATURE_STRIDE;
+  header.featureUsed = FEATURE_USED;
+  header.maxPlayers = MAX_PLAYERS;
+  gzwrite(out, &header, sizeof(header));
+  return out;
+}
+
+
+static int closeShard(gzFile out, const char *tmpName, const char *name) {
+  if (gzclose(out) != Z_OK || rename(tmpName, name) != 0) {
+    fprintf(stderr, "selfplay: cannot finish %s\n", name);
+    return -1;
+  }
+  shardsWritten++;
+  return 0;
+}
+
+
+//Writes batches to rotating shards until every game thread has finished
+static void *writerThread(void *arg) {
+  char name[512], tmpName[520];
+  gzFile out = NULL;
+  struct batch *b;
+  int inShard = 0, n, i;
+
+  (void)arg;
+  for (;;) {
+    pthread_mutex_lock(&queueLock);
+    while (fullBatches.count == 0 && producersLeft > 0) {
+      pthread_cond_wait(&batchFull, &queueLock);
+    }
+    if (fullBatches.count == 0) {
+      pthread_mutex_unlock(&queueLock);
+      break;
+    }
+    b = pop(&fullBatches);
+    pthread_mutex_unlock(&queueLock);
+
+    //Compression happens here, outside the lock, while the games go on
+    for (i = 0; i < b->count; i += n) {
+      if (out == NULL) {
+	out = openShard(tmpName, sizeof(tmpName), name, sizeof(name));
+	if (out == NULL) {
+	  fprintf(stderr, "selfplay: cannot create %s\n", tmpName);
+	  exit(EXIT_FAILURE);
+	}
+	inShard = 0;
+      }
+      n = b->count - i;
+      if (n > shardRecords - inShard) {
+	n = shardRecords - inShard;
+      }
+      if (gzwrite(out, &b->records[i], sizeof(struct selfplayRecord) * n) <= 0) {
+	fprintf(stderr, "selfplay: write to %s failed\n", tmpName);
+	exit(EXIT_FAILURE);
+      }
+      inShard += n;
+      recordsWritten += n;
+      if (inShard == shardRecords) {
+	closeShard(out, tmpName, name);
+	out = NULL;
+      }
+    }
+
+    pthread_mutex_lock(&queueLock);
+    push(&freeBatches, b);
+    pthread_cond_signal(&batchFree);
+    pthread_mutex_unlock(&queueLock);
+  }
+
+  if (out != NULL) {
+    closeShard(out, tmpName, name);
+  }
+  return NULL;
+}
+
+
+static void stop(int sig) {
+  (void)sig;
+  stopping = 1;
+}
+
+
+//Print a shard's header and what its records say
+static int dump(const char *path) {
+  struct shardHeader header;
+  struct selfplayRecord r;
+  long long count = 0, outcomes[3] = {0, 0, 0}, buys = 0, finished = 0;
+  gzFile in = gzopen(path, "rb");
+
+  if (in == NULL || gzread(in, &header, sizeof(header)) != sizeof(header)
+      || header.magic != SELFPLAY_MAGIC || header.recordSize != sizeof(struct selfplayRecord)) {
+    fprintf(stderr, "selfplay: %s is not a version %d shard\n", path, SELFPLAY_VERSION);
+    return EXIT_FAILURE;
+  }
+  while (gzread(in, &r, sizeof(r)) == sizeof(r)) {
+    count++;
+    if (r.outcome >= 0 && r.outcome <= 2) {
+      outcomes[(int)r.outcome]++;
+    }
+    buys += r.action >= 0;
+    finished += r.finished;
+  }
+  gzclose(in);
+  printf("%s: version %u, %u-byte records, feature stride %u (%u used)\n", path, header.version,
+	 header.recordSize, header.featureStride, header.featureUsed);
+  printf("%lld records: %lld won, %lld tied, %lld lost; %lld with a buy; %lld from finished games\n",
+	 count, outcomes[2], outcomes[1], outcomes[0], buys, finished);
+  if ((count - finished) * 100 > count * SELFPLAY_MAX_UNFINISHED) {
+    fprintf(stderr, "selfplay: %lld of %lld records are from unfinished games\n", count - finished, count);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+
+int main(int argc, char **argv) {
+  pthread_t threads[SELFPLAY_MAX_THREADS], writer;
+  struct batch *pool;
+  const char *strategyFile = NULL, *weightsFile = NULL;
+  int threadCount = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  double start, last;
+  int a, i;
+
+  for (a = 1; a < argc; a++) {
+    if (a + 1 < argc && strcmp(argv[a], "-dump") == 0) {
+      return dump(argv[a + 1]);
+    }
+    else if (a + 1 < argc && strcmp(argv[a], "-j") == 0) {
+      threadCount = atoi(argv[++a]);
+    }
+    else if (a + 1 < argc && strcmp(argv[a], "-games") == 0) {
+      gameLimit = atoll(argv[++a]);
+    }
+    else if (a + 1 < argc && strcmp(argv[a], "-players") == 0) {
+      numPlayers = atoi(argv[++a]);
+    }
+    else if (a + 1 < argc && strcmp(argv[a], "-shard") == 0) {
+      shardRecords = atoi(argv[++a]);
+    }
+    else if (a + 1 < argc && strcmp(argv[a], "-o") == 0) {
+      prefix = argv[++a];
+    }
+    else if (a + 1 < argc && strcmp(argv[a], "-s") == 0) {
+      seed = (unsigned int)atoi(argv[++a]);
+    }
+    else if (a + 1 < argc && strcmp(argv[a], "-z") == 0) {
+      gzLevel = atoi(argv[++a]);
+    }
+    else if (a + 1 < argc && strcmp(argv[a], "-b") == 0) {
+      strategyFile = argv[++a];
+    }
+    else if (a + 1 < argc && strcmp(argv[a], "-e") == 0) {
+      setBotEndgameNodes(atol(argv[++a]));
+    }
+    else if (a + 1 < argc && strcmp(argv[a], "-w") == 0) {
+      weightsFile = argv[++a];
+    }
+    else {
+      break;
+    }
+  }
+  if (a != argc || numPlayers < 2 || numPlayers > MAX_PLAYERS || shardRecords < 1
+      || gzLevel < 0 || gzLevel > 9 || gameLimit < 0) {
+    printf("Usage: selfplay [-j threads] [-games n] [-players n] [-shard records]\n"
+	   "                [-o prefix] [-s seed] [-z level] [-b strategyFile] [-e nodes]\n"
+	   "                [-w weightsFile]\n"
+	   "       selfplay -dump shardFile\n");
+    return EXIT_SUCCESS;
+  }
+  if (threadCount < 1) {
+    threadCount = 1;
+  }
+  if (threadCount > SELFPLAY_MAX_THREADS) {
+    threadCount = SELFPLAY_MAX_THREADS;
+  }
+  //Loaded once here, so the game threads only ever read it
+  if (loadBotStrategy(strategyFile) != SUCCESS) {
+    fprintf(stderr, "selfplay: cannot load strategy %s\n", strategyFile);
+    return EXIT_FAILURE;
+  }
+  if (weightsFile != NULL && loadBotNet(weightsFile) != SUCCESS) {
+    fprintf(stderr, "selfplay: cannot load weights %s\n", weightsFile);
+    return EXIT_FAILURE;
+  }
+
+  pool = malloc(sizeof(struct batch) * SELFPLAY_POOL);
+  if (pool == NULL) {
+    return EXIT_FAILURE;
+  }
+  for (i = 0; i < SELFPLAY_POOL; i++) {
+    push(&freeBatches, &pool[i]);
+  }
+  signal(SIGINT, stop);
+  signal(SIGTERM, stop);
+
+  start = last = now();
+  producersLeft = threadCount;
+  pthread_create(&writer, NULL, writerThread, NULL);
+  for (i = 0; i < threadCount; i++) {
+    pthread_create(&threads[i], NULL, gameThread, NULL);
+  }
+  //Progress from the main thread while the others work
+  while (producersLeft > 0) {
+    usleep(100000);
+    if (now() - last >= 10) {
+      last = now();
+      fprintf(stderr, "%lld games, %lld records, %d shards, %.0f records/s, %.1fs waiting on the writer\n",
+	      gamesDone, recordsWritten, shardsWritten, recordsWritten / (last - start), stallNanos / 1e9);
+    }
+  }
+  for (i = 0; i < threadCount; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  pthread_join(writer, NULL);
+
+  printf("%lld games (%lld unfinished, skipped), %lld records in %d shard(s), %.1fs, %.1fs waiting on the writer\n",
+	 gamesDone, gamesUnfinished, recordsWritten, shardsWritten, now() - start, stallNanos / 1e9);
+  free(pool);
+  if (gamesUnfinished * 100 > gamesDone * SELFPLAY_MAX_UNFINISHED) {
+    fprintf(stderr, "selfplay: %lld of %lld games hit the %d-turn cap\n", gamesUnfinished, gamesDone,
+	    SIMULATE_MAX_TURNS);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,109 @@
+/* 	Simulation Throughput Benchmark
+
+	Plays -games 2-player games of big money against big money with
+	smithies on playdom's kingdom, one thread, and reports games per
+	second.  make playersbench runs it built twice, as the generic engine
+	(simbench) and with -DFIXED_PLAYERS=2 (simbench2); both play the same
+	games, so their checksums of the results must agree.  Each run is
+	timed -r times and the fastest is reported, since a shared machine
+	only ever makes a run slower.
+
+	A game that hits SIMULATE_MAX_TURNS is cheap and says nothing about
+	the engine's speed on real games, so the share of games that finished
+	is reported, and simbench exits nonzero (failing make playersbench)
+	when it is under SIMBENCH_MIN_FINISHED.
+
+	Usage:	simbench [-games n] [-r runs] [-s firstSeed]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "dominion.h"
+#include "simulate.h"
+#include "strategy.h"
+
+#define SIMBENCH_TEXT \
+  "name smithy\n" \
+  "province if coins >= 8\n" \
+  "gold if coins >= 6\n" \
+  "smithy if coins >= 4 and owned < 2\n" \
+  "silver if coins >= 3\n"
+
+#define SIMBENCH_MIN_FINISHED 0.99	//share of games that must end before the turn cap
+
+
+static double now(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+
+int main(int argc, char **argv) {
+  int kingdom[10] = {adventurer, gardens, embargo, village, minion, mine, cutpurse,
+		     council_room, tribute, smithy};
+  struct strategy bigMoney, smithyMoney;
+  const struct strategy *seats[2];
+  struct gamePrototype prototype;
+  struct gameResult result;
+  int games = 200000, runs = 3, firstSeed = 1, finished = 0;
+  int a, g, r;
+  unsigned long checksum = 0;
+  double start, best = 0;
+
+  for (a = 1; a < argc; a++) {
+    if (a + 1 < argc && strcmp(argv[a], "-games") == 0) {
+      games = atoi(argv[++a]);
+    }
+    else if (a + 1 < argc && strcmp(argv[a], "-r") == 0) {
+      runs = atoi(argv[++a]);
+    }
+    else if (a + 1 < argc && strcmp(argv[a], "-s") == 0) {
+      firstSeed = atoi(argv[++a]);
+    }
+    else {
+      break;
+    }
+  }
+  if (a != argc || games < 1 || runs < 1 || firstSeed < 1 || firstSeed > 0x7fffffff - games) {
+    printf("Usage: simbench [-games n] [-r runs] [-s firstSeed]\n");
+    return 1;
+  }
+
+  strategyParse(&bigMoney, STRATEGY_DEFAULT);
+  strategyParse(&smithyMoney, SIMBENCH_TEXT);
+  initializePrototype(2, kingdom, &prototype);
+  for (r = 0; r < runs; r++) {
+    checksum = 0;
+    finished = 0;
+    start = now();
+    for (g = 0; g < games; g++) {
+      //Seats swap every game, as in evolve and kingdomsweep
+      seats[g % 2] = &smithyMoney;
+      seats[1 - g % 2] = &bigMoney;
+      simulatePrototype(seats, &prototype, firstSeed + g, SIMULATE_MAX_TURNS, &result);
+      checksum = checksum * 31 + (unsigned long)(result.turns * 1000 + result.scores[0] * 10 + result.winner + 1);
+      finished += result.finished;
+    }
+    if (r == 0 || now() - start < best) {
+      best = now() - start;
+    }
+  }
+
+#ifdef FIXED_PLAYERS
+  printf("engine: %d players fixed, ", FIXED_PLAYERS);
+#else
+  printf("engine: generic, ");
+#endif
+  printf("state %lu bytes\n", (unsigned long)sizeof(struct gameState));
+  printf("%d games: %.0f games/s, %.2f us/game (best of %d)\n", games, games / best, best / games * 1e6, runs);
+  printf("checksum %016lx, %.1f%% of games finished\n", checksum, 100.0 * finished / games);
+  if (finished < SIMBENCH_MIN_FINISHED * games) {
+    fprintf(stderr, "simbench: only %d of %d games finished before the %d-turn cap\n", finished, games,
+	    SIMULATE_MAX_TURNS);
+    return 1;
+  }
+  return 0;
+}
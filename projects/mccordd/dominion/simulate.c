@@ -0,0 +1,117 @@
+/* 	Headless Game Simulation
+*/
+
+#include <string.h>
+#include "dominion_helpers.h"
+#include "simulate.h"
+
+//Actions played automatically, best first: villages before terminals.
+//Cards that need choices (feast, mine, remodel, ...) and adventurer, which
+//can search forever for treasure, are never played
+static const int autoPlay[] = { village, great_hall, smithy, council_room };
+#define NUM_AUTO_PLAY ((int)(sizeof(autoPlay) / sizeof(autoPlay[0])))
+
+
+int simulatePlays(int card) {
+  int a;
+  for (a = 0; a < NUM_AUTO_PLAY; a++) {
+    if (autoPlay[a] == card) {
+      return CARD_ENABLED(card);
+    }
+  }
+  return 0;
+}
+
+
+int pickAction(struct gameState *state) {
+  int a, i;
+  for (a = 0; a < NUM_AUTO_PLAY; a++) {
+    if (!CARD_ENABLED(autoPlay[a])) {
+      continue;
+    }
+    for (i = 0; i < numHandCards(state); i++) {
+      if (handCard(i, state) == autoPlay[a]) {
+	return i;
+      }
+    }
+  }
+  return -1;
+}
+
+
+int simulateGame(const struct strategy *strategies[], int numPlayers, int kingdom[10],
+		 int seed, int maxTurns, struct gameResult *result) {
+  struct gamePrototype prototype;
+
+  if (initializePrototype(numPlayers, kingdom, &prototype) != 0) {
+    memset(result, 0, sizeof(struct gameResult));
+    return -1;
+  }
+  return simulatePrototype(strategies, &prototype, seed, maxTurns, result);
+}
+
+
+int simulatePrototype(const struct strategy *strategies[], const struct gamePrototype *prototype,
+		      int seed, int maxTurns, struct gameResult *result) {
+  struct gameState state;
+
+  memset(&state, 0, sizeof(struct gameState));
+  initializeFromPrototype(prototype, seed, &state);
+  simulateFrom(strategies, &state, 0, maxTurns, result);
+  return 0;
+}
+
+
+void simulateTurn(const struct strategy *strategy, struct gameState *state, int turn) {
+  int player = whoseTurn(state);
+  int pos, card;
+
+  while (state->numActions > 0 && (pos = pickAction(state)) >= 0) {
+    if (playCard(pos, -1, -1, -1, state) != 0) {
+      break;
+    }
+  }
+
+  while (state->numBuys > 0) {
+    card = strategyChoose(strategy, player, state->coins, turn, state);
+    if (card < 0 || buyCard(card, state) != 0) {
+      break;
+    }
+  }
+}
+
+
+void simulateFrom(const struct strategy *strategies[], struct gameState *state,
+		  int turn, int maxTurns, struct gameResult *result) {
+  int numPlayers = NUM_PLAYERS(state);
+  int player, best, i;
+
+  memset(result, 0, sizeof(struct gameResult));
+  result->turns = turn;
+
+  while (!isGameOver(state) && result->turns < maxTurns) {
+    player = whoseTurn(state);
+    simulateTurn(strategies[player], state, result->turns);
+
+    if (player == numPlayers - 1) {
+      result->turns++;
+    }
+    endTurn(state);
+  }
+
+  result->finished = isGameOver(state);
+  result->winner = 0;
+  for (i = 0; i < numPlayers; i++) {
+    result->scores[i] = scoreFor(i, state);
+  }
+  best = result->scores[0];
+  for (i = 1; i < numPlayers; i++) {
+    if (result->scores[i] > best) {
+      best = result->scores[i];
+      result->winner = i;
+    }
+    else if (result->scores[i] == best) {
+      result->winner = -1;
+    }
+  }
+}
@@ -0,0 +1,53 @@
+/* 	Headless Game Simulation
+
+	Plays whole games between strategies (strategy.h) on the dominion.c
+	engine in-process: no printing, no child processes, and nothing
+	shared between threads, so any number of threads can simulate at once.
+*/
+
+#ifndef _SIMULATE_H
+#define _SIMULATE_H
+
+#include "dominion.h"
+#include "strategy.h"
+
+#define SIMULATE_MAX_TURNS 100	//rounds before a game is scored unfinished
+
+struct gameResult {
+  int turns;			//complete rounds played
+  int finished;			//isGameOver() was reached before the cap
+  int scores[MAX_PLAYERS];
+  int winner;			//seat with the highest score, -1 on a tie
+};
+
+int simulateGame(const struct strategy *strategies[], int numPlayers, int kingdom[10],
+		 int seed, int maxTurns, struct gameResult *result);
+/* Play one game, seat i following strategies[i].  Each turn the seat
+   plays the draw/village actions in its hand, then buys by its strategy
+   until it runs out of buys or the strategy declines.  Returns -1 if the
+   game could not be initialized */
+
+int simulatePrototype(const struct strategy *strategies[], const struct gamePrototype *prototype,
+		      int seed, int maxTurns, struct gameResult *result);
+/* simulateGame() on a kingdom built once by initializePrototype(), for
+   playing many seeds on one kingdom */
+
+int simulatePlays(int card);
+/* 1 if simulations play card when it is in hand, 0 for cards they only
+   ever buy */
+
+int pickAction(struct gameState *state);
+/* Hand position of the best action simulations play automatically (the
+   villages, then smithy and council_room), or -1 */
+
+void simulateTurn(const struct strategy *strategy, struct gameState *state, int turn);
+/* The current seat's actions and buys, as simulateGame() plays them, on
+   round turn; the turn is not ended */
+
+void simulateFrom(const struct strategy *strategies[], struct gameState *state,
+		  int turn, int maxTurns, struct gameResult *result);
+/* Play state out from wherever it stands, the current seat finishing its
+   turn first; turn is the round number it is on.  The game is played in
+   place and uses the calling thread's rngs.c stream */
+
+#endif
@@ -0,0 +1,167 @@
+/* 	Game State Pool
+
+	Two fixed-size slot pools per thread, one sized for struct gameState
+	and one for a 10 card kingdom, each grown a slab at a time.  A thread
+	that has allocated a slab registers poolKey, whose destructor gives
+	the slabs back when the thread exits.
+*/
+
+#include <stdlib.h>
+#include <pthread.h>
+#include "statepool.h"
+
+//Round a slot up to a whole number of cache lines
+#define POOL_ROUND(n) (((n) + POOL_CACHE_LINE - 1) & ~(size_t)(POOL_CACHE_LINE - 1))
+
+struct poolSlab {
+  struct poolSlab *next;
+  char *slots;
+};
+
+struct poolSlot {
+  struct poolSlot *next;
+};
+
+struct slotPool {
+  size_t slotSize;
+  struct poolSlab *slabs;
+  struct poolSlot *freeList;
+  int inUse;
+};
+
+static __thread struct slotPool statePool = { POOL_ROUND(sizeof(struct gameState)), NULL, NULL, 0 };
+static __thread struct slotPool kingdomPool = { POOL_ROUND(10 * sizeof(int)), NULL, NULL, 0 };
+
+static pthread_key_t poolKey;
+static pthread_once_t poolKeyOnce = PTHREAD_ONCE_INIT;
+
+
+static void poolThreadExit(void *unused) {
+  poolDestroy();
+}
+
+static void poolKeyCreate(void) {
+  pthread_key_create(&poolKey, poolThreadExit);
+}
+
+
+static void pushSlab(struct slotPool *pool, struct poolSlab *slab) {
+  int i;
+  struct poolSlot *slot;
+
+  for (i = POOL_SLAB_SLOTS - 1; i >= 0; i--) {
+    slot = (struct poolSlot*)(slab->slots + i * pool->slotSize);
+    slot->next = pool->freeList;
+    pool->freeList = slot;
+  }
+}
+
+static void* poolAlloc(struct slotPool *pool) {
+  struct poolSlot *slot;
+  struct poolSlab *slab;
+
+  if (pool->freeList == NULL) {
+    slab = malloc(sizeof(struct poolSlab));
+    if (slab == NULL) {
+      return NULL;
+    }
+    slab->slots = aligned_alloc(POOL_CACHE_LINE, pool->slotSize * POOL_SLAB_SLOTS);
+    if (slab->slots == NULL) {
+      free(slab);
+      return NULL;
+    }
+    //Any non-NULL value arms poolThreadExit() for this thread
+    pthread_once(&poolKeyOnce, poolKeyCreate);
+    pthread_setspecific(poolKey, pool);
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    pushSlab(pool, slab);
+  }
+
+  slot = pool->freeList;
+  pool->freeList = slot->next;
+  pool->inUse++;
+  return slot;
+}
+
+static void poolRelease(struct slotPool *pool, void *p) {
+  struct poolSlot *slot = p;
+
+  if (p == NULL) {
+    return;
+  }
+  slot->next = pool->freeList;
+  pool->freeList = slot;
+  pool->inUse--;
+}
+
+static void poolReset(struct slotPool *pool) {
+  struct poolSlab *slab;
+
+  pool->freeList = NULL;
+  for (slab = pool->slabs; slab != NULL; slab = slab->next) {
+    pushSlab(pool, slab);
+  }
+  pool->inUse = 0;
+}
+
+static void poolFree(struct slotPool *pool) {
+  struct poolSlab *slab;
+
+  while (pool->slabs != NULL) {
+    slab = pool->slabs;
+    pool->slabs = slab->next;
+    free(slab->slots);
+    free(slab);
+  }
+  pool->freeList = NULL;
+  pool->inUse = 0;
+}
+
+
+struct gameState* poolNewGame(void) {
+  return poolAlloc(&statePool);
+}
+
+void poolFreeGame(struct gameState *state) {
+  poolRelease(&statePool, state);
+}
+
+int* poolKingdomCards(void) {
+  return poolAlloc(&kingdomPool);
+}
+
+void poolFreeKingdom(int *k) {
+  poolRelease(&kingdomPool, k);
+}
+
+void poolResetAll(void) {
+  poolReset(&statePool);
+  poolReset(&kingdomPool);
+}
+
+void poolDestroy(void) {
+  poolFree(&statePool);
+  poolFree(&kingdomPool);
+  pthread_once(&poolKeyOnce, poolKeyCreate);
+  pthread_setspecific(poolKey, NULL);
+}
+
+int poolInUse(void) {
+  return statePool.inUse;
+}
+
+int* setKingdomCards(int k[10], int k1, int k2, int k3, int k4, int k5,
+		     int k6, int k7, int k8, int k9, int k10) {
+  k[0] = k1;
+  k[1] = k2;
+  k[2] = k3;
+  k[3] = k4;
+  k[4] = k5;
+  k[5] = k6;
+  k[6] = k7;
+  k[7] = k8;
+  k[8] = k9;
+  k[9] = k10;
+  return k;
+}
@@ -0,0 +1,49 @@
+/* 	Game State Pool
+
+	Thread-local slab allocator behind newGame() and kingdomCards().
+	Slots are cache-line aligned and are never handed back to malloc
+	until poolDestroy() or the thread exits; batch runs recycle
+	everything at once with poolResetAll().
+
+	A slot does not record which pool it came from: free a state or
+	kingdom on the thread that allocated it (another thread's free would
+	put it on that thread's pool), and do not use it after that thread
+	exits.
+*/
+
+#ifndef _STATEPOOL_H
+#define _STATEPOOL_H
+
+#include "dominion.h"
+
+#define POOL_CACHE_LINE 64
+#define POOL_SLAB_SLOTS 64   //slots carved from each slab allocation
+
+struct gameState* poolNewGame(void);
+/* Returns an uninitialized, cache-line aligned state, or NULL if out of
+   memory.  The state belongs to the calling thread's pool */
+
+void poolFreeGame(struct gameState *state);
+/* Return a single state to the calling thread's pool */
+
+int* poolKingdomCards(void);
+/* Returns room for 10 kingdom cards from the calling thread's pool */
+
+void poolFreeKingdom(int *k);
+
+void poolResetAll(void);
+/* Release every state and kingdom array handed out on this thread in one
+   step; previous pointers become invalid.  Memory is kept for reuse */
+
+void poolDestroy(void);
+/* Give this thread's slabs back to the system; a thread exiting does
+   this itself */
+
+int poolInUse(void);
+/* Number of states currently handed out on this thread */
+
+int* setKingdomCards(int k[10], int k1, int k2, int k3, int k4, int k5,
+		     int k6, int k7, int k8, int k9, int k10);
+/* Stack-friendly kingdomCards(): fills the caller's array and returns it */
+
+#endif
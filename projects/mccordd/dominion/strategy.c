@@ -0,0 +1,347 @@
+/* 	Bot Buy Strategies
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <ctype.h>
+#include "dominion_helpers.h"
+#include "strategy.h"
+
+#define STRATEGY_LINE_LENGTH 256
+#define STRATEGY_TOKEN_LENGTH 64
+
+//Indexed by card number, as the identifiers are spelled in enum CARD
+static const char *cardIds[STRATEGY_NUM_CARDS] = {
+  "curse", "estate", "duchy", "province", "copper", "silver", "gold",
+  "adventurer", "council_room", "feast", "gardens", "mine", "remodel",
+  "smithy", "village", "baron", "great_hall", "minion", "steward",
+  "tribute", "ambassador", "cutpurse", "embargo", "outpost", "salvager",
+  "sea_hag", "treasure_map"
+};
+
+
+const char *strategyCardId(int card) {
+  if ((unsigned int)card >= STRATEGY_NUM_CARDS) {
+    return "?";
+  }
+  return cardIds[card];
+}
+
+
+int strategyCardNumber(const char *name) {
+  int card;
+  for (card = 0; card < STRATEGY_NUM_CARDS; card++) {
+    if (strcmp(name, cardIds[card]) == 0) {
+      return card;
+    }
+  }
+  return -1;
+}
+
+
+//Next token of a line: a word (letters, digits, '_' and ':'), a number or
+//a run of comparison characters.  Returns the position after it
+static const char *nextToken(const char *p, char *token) {
+  int n = 0;
+  while (isspace((unsigned char)*p)) {
+    p++;
+  }
+  if (*p == '<' || *p == '>' || *p == '=' || *p == '!') {
+    while ((*p == '<' || *p == '>' || *p == '=' || *p == '!') && n < STRATEGY_TOKEN_LENGTH - 1) {
+      token[n++] = *p++;
+    }
+  }
+  else {
+    while ((isalnum((unsigned char)*p) || *p == '_' || *p == ':' || *p == '-') && n < STRATEGY_TOKEN_LENGTH - 1) {
+      token[n++] = *p++;
+    }
+  }
+  token[n] = '\0';
+  return p;
+}
+
+
+//Narrow [*low, *high] to the values satisfying "x op value"; -1 if that
+//leaves none, since strategyChoose()'s unsigned range test would wrap
+static int narrow(const char *op, int value, int *low, int *high) {
+  int newLow = INT_MIN, newHigh = INT_MAX;
+
+  if ((value == INT_MIN && strcmp(op, "<") == 0) || (value == INT_MAX && strcmp(op, ">") == 0)) {
+    return -1;
+  }
+  if (strcmp(op, "<") == 0) {
+    newHigh = value - 1;
+  }
+  else if (strcmp(op, "<=") == 0) {
+    newHigh = value;
+  }
+  else if (strcmp(op, ">") == 0) {
+    newLow = value + 1;
+  }
+  else if (strcmp(op, ">=") == 0) {
+    newLow = value;
+  }
+  else if (strcmp(op, "==") == 0) {
+    newLow = value;
+    newHigh = value;
+  }
+  else {
+    return -1;
+  }
+  if (newLow > *low) {
+    *low = newLow;
+  }
+  if (newHigh < *high) {
+    *high = newHigh;
+  }
+  return *low <= *high ? 0 : -1;
+}
+
+
+//Counter index for a condition word, resolved against the rule's own card
+static int conditionVar(const char *word, int card) {
+  const char *colon = strchr(word, ':');
+  int other;
+
+  if (colon != NULL) {
+    other = strategyCardNumber(colon + 1);
+    if (other < 0) {
+      return -1;
+    }
+    if (strncmp(word, "supply:", 7) == 0) {
+      return STRATEGY_VAR_SUPPLY(other);
+    }
+    if (strncmp(word, "owned:", 6) == 0) {
+      return STRATEGY_VAR_OWNED(other);
+    }
+    return -1;
+  }
+  if (strcmp(word, "turn") == 0) {
+    return STRATEGY_VAR_TURN;
+  }
+  if (strcmp(word, "supply") == 0) {
+    return STRATEGY_VAR_SUPPLY(card);
+  }
+  if (strcmp(word, "owned") == 0) {
+    return STRATEGY_VAR_OWNED(card);
+  }
+  return -1;
+}
+
+
+static int parseRule(struct strategy *s, const char *line) {
+  struct strategyRule *r;
+  char word[STRATEGY_TOKEN_LENGTH];
+  char op[STRATEGY_TOKEN_LENGTH];
+  char number[STRATEGY_TOKEN_LENGTH];
+  char *end;
+  int i, var, value, numTests = 0;
+
+  line = nextToken(line, word);
+  if (word[0] == '\0') {
+    return 0;
+  }
+  if (strcmp(word, "name") == 0) {
+    nextToken(line, word);
+    strncpy(s->name, word, STRATEGY_NAME_LENGTH - 1);
+    s->name[STRATEGY_NAME_LENGTH - 1] = '\0';
+    return 0;
+  }
+  if (s->numRules == STRATEGY_MAX_RULES) {
+    return -1;
+  }
+
+  r = &s->rules[s->numRules];
+  r->card = strategyCardNumber(word);
+  if (r->card < 0) {
+    return -1;
+  }
+  r->coinLow = getCost(r->card);
+  r->coinHigh = INT_MAX;
+  for (i = 0; i < STRATEGY_MAX_TESTS; i++) {
+    r->tests[i].var = STRATEGY_VAR_TURN;
+    r->tests[i].low = INT_MIN;
+    r->tests[i].high = INT_MAX;
+  }
+
+  line = nextToken(line, word);
+  if (word[0] != '\0' && strcmp(word, "if") != 0) {
+    return -1;
+  }
+  while (word[0] != '\0') {
+    line = nextToken(line, word);
+    line = nextToken(line, op);
+    line = nextToken(line, number);
+    value = (int)strtol(number, &end, 10);
+    if (number[0] == '\0' || *end != '\0') {
+      return -1;
+    }
+
+    if (strcmp(word, "coins") == 0) {
+      if (value < 0 || value >= STRATEGY_COIN_LEVELS || narrow(op, value, &r->coinLow, &r->coinHigh) < 0) {
+	return -1;
+      }
+    }
+    else {
+      var = conditionVar(word, r->card);
+      if (var < 0) {
+	return -1;
+      }
+      //Conditions on the same counter share one test
+      for (i = 0; i < numTests && r->tests[i].var != var; i++)
+	;
+      if (i == numTests) {
+	if (numTests == STRATEGY_MAX_TESTS) {
+	  return -1;
+	}
+	r->tests[i].var = var;
+	numTests++;
+      }
+      if (narrow(op, value, &r->tests[i].low, &r->tests[i].high) < 0) {
+	return -1;
+      }
+      if (var >= STRATEGY_VAR_OWNED(0)) {
+	s->needOwned = 1;
+      }
+    }
+
+    line = nextToken(line, word);
+    if (word[0] != '\0' && strcmp(word, "and") != 0) {
+      return -1;
+    }
+  }
+
+  //1: a rule no test can fail, which ends the candidate list at its coin values
+  s->numRules++;
+  return numTests == 0 ? 1 : 2;
+}
+
+
+int strategyParse(struct strategy *s, const char *text) {
+  char line[STRATEGY_LINE_LENGTH];
+  int closed[STRATEGY_COIN_LEVELS];
+  int lineNum = 0, level, kind, length;
+  const char *end;
+  struct strategyRule *r;
+
+  memset(s, 0, sizeof(struct strategy));
+  strcpy(s->name, "unnamed");
+  memset(closed, 0, sizeof(closed));
+
+  while (*text != '\0') {
+    end = strchr(text, '\n');
+    length = end ? (int)(end - text) : (int)strlen(text);
+    if (length >= STRATEGY_LINE_LENGTH) {
+      length = STRATEGY_LINE_LENGTH - 1;
+    }
+    memcpy(line, text, length);
+    line[length] = '\0';
+    if (strchr(line, '#') != NULL) {
+      *strchr(line, '#') = '\0';
+    }
+    text = end ? end + 1 : text + strlen(text);
+    lineNum++;
+
+    kind = parseRule(s, line);
+    if (kind < 0) {
+      fprintf(stderr, "strategy %s:%d: cannot parse \"%s\"\n", s->name, lineNum, line);
+      return -1;
+    }
+    if (kind == 0) {
+      continue;
+    }
+
+    r = &s->rules[s->numRules - 1];
+    for (level = 0; level < STRATEGY_COIN_LEVELS; level++) {
+      if (closed[level] || level < r->coinLow || level > r->coinHigh) {
+	continue;
+      }
+      s->candidates[level][s->numCandidates[level]++] = s->numRules - 1;
+      if (kind == 1) {
+	closed[level] = 1;
+      }
+    }
+  }
+  return 0;
+}
+
+
+int strategyLoad(struct strategy *s, const char *path) {
+  char *text;
+  long size;
+  int result;
+  FILE *in = fopen(path, "r");
+
+  if (in == NULL) {
+    return -1;
+  }
+  fseek(in, 0, SEEK_END);
+  size = ftell(in);
+  rewind(in);
+  text = malloc(size + 1);
+  if (text == NULL || (long)fread(text, 1, size, in) != size) {
+    free(text);
+    fclose(in);
+    return -1;
+  }
+  text[size] = '\0';
+  fclose(in);
+
+  result = strategyParse(s, text);
+  free(text);
+  return result;
+}
+
+
+static void countOwned(int *counters, int card) {
+  if ((unsigned int)card < STRATEGY_NUM_CARDS) {
+    counters[STRATEGY_VAR_OWNED(card)]++;
+  }
+}
+
+
+int strategyChoose(const struct strategy *s, int player, int coins, int turn, struct gameState *state) {
+  int counters[STRATEGY_NUM_VARS];
+  const struct strategyRule *r;
+  unsigned int pass;
+  int choice = -1;
+  int level, i, t;
+
+  counters[STRATEGY_VAR_TURN] = turn;
+  memcpy(&counters[STRATEGY_VAR_SUPPLY(0)], state->supplyCount, sizeof(int) * STRATEGY_NUM_CARDS);
+  if (s->needOwned) {
+    //fullDeckCount()'s piles, in one pass each, and the cards in play
+    memset(&counters[STRATEGY_VAR_OWNED(0)], 0, sizeof(int) * STRATEGY_NUM_CARDS);
+    for (i = 0; i < state->deckCount[player]; i++) {
+      countOwned(counters, state->deck[player][i]);
+    }
+    for (i = 0; i < state->handCount[player]; i++) {
+      countOwned(counters, state->hand[player][i]);
+    }
+    for (i = 0; i < state->discardCount[player]; i++) {
+      countOwned(counters, state->discard[player][i]);
+    }
+    //Cards played this turn are still the current player's
+    if (player == whoseTurn(state)) {
+      for (i = 0; i < state->playedCardCount; i++) {
+	countOwned(counters, state->playedCards[i]);
+      }
+    }
+  }
+
+  level = coins < 0 ? 0 : coins >= STRATEGY_COIN_LEVELS ? STRATEGY_COIN_LEVELS - 1 : coins;
+
+  //Walk the candidates worst first so the best passing rule is left in
+  //choice; the range tests are unsigned compares, no early exits
+  for (i = s->numCandidates[level] - 1; i >= 0; i--) {
+    r = &s->rules[s->candidates[level][i]];
+    pass = 1;
+    for (t = 0; t < STRATEGY_MAX_TESTS; t++) {
+      pass &= (unsigned int)counters[r->tests[t].var] - (unsigned int)r->tests[t].low
+	<= (unsigned int)r->tests[t].high - (unsigned int)r->tests[t].low;
+    }
+    choice = pass ? r->card : choice;
+  }
+  return choice;
+}
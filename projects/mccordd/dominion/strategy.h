@@ -0,0 +1,95 @@
+/* 	Bot Buy Strategies
+
+	A strategy is a priority list of buys, one rule per line, best first:
+
+	    # comment
+	    name bigmoney
+	    province if coins >= 8
+	    duchy    if supply:province == 0 and coins >= 5
+	    smithy   if owned < 2 and turn <= 10
+	    silver
+
+	A rule is a card name (the enum CARD identifier) optionally followed
+	by "if" and conditions joined with "and".  A condition compares one of
+	  coins			coins in hand this turn
+	  turn			the caller's turn counter
+	  supply, owned		supply pile / copies owned of the rule's card
+				(deck, hand, discard and cards in play)
+	  supply:<card>, owned:<card>	the same for another card
+	with <, <=, >, >= or == against an integer (coins against 0..15).
+	Every rule also needs coins >= the card's cost.  A rule whose
+	conditions on one counter (or on coins, cost included) leave no
+	value at all is an error.  The first rule whose
+	conditions all hold is bought; if none do the bot buys nothing.
+
+	strategyParse() compiles the rules into one candidate list per coin
+	value, cut short after the first rule that cannot fail at that value,
+	and every remaining condition into a range test on one counter, so a
+	decision costs the same whatever the ladder looks like.
+*/
+
+#ifndef _STRATEGY_H
+#define _STRATEGY_H
+
+#include <stdio.h>
+#include "dominion.h"
+
+#define STRATEGY_MAX_RULES 32
+#define STRATEGY_MAX_TESTS 4		//conditions per rule besides coins
+#define STRATEGY_COIN_LEVELS 16		//coin values 0..15; more counts as 15
+#define STRATEGY_NAME_LENGTH 32
+#define STRATEGY_NUM_CARDS (treasure_map + 1)
+
+//Counters a condition can test, see strategyChoose()
+#define STRATEGY_VAR_TURN 0
+#define STRATEGY_VAR_SUPPLY(card) (1 + (card))
+#define STRATEGY_VAR_OWNED(card) (1 + STRATEGY_NUM_CARDS + (card))
+#define STRATEGY_NUM_VARS (1 + 2 * STRATEGY_NUM_CARDS)
+
+//low <= counter <= high
+struct strategyTest {
+  int var;
+  int low, high;
+};
+
+struct strategyRule {
+  int card;
+  int coinLow, coinHigh;
+  struct strategyTest tests[STRATEGY_MAX_TESTS];	//unused slots always pass
+};
+
+struct strategy {
+  char name[STRATEGY_NAME_LENGTH];
+  int numRules;
+  struct strategyRule rules[STRATEGY_MAX_RULES];
+  int needOwned;	//some condition tests an owned count
+  int numCandidates[STRATEGY_COIN_LEVELS];
+  unsigned char candidates[STRATEGY_COIN_LEVELS][STRATEGY_MAX_RULES];
+};
+
+//The ladder executeBotTurn() has always used
+#define STRATEGY_DEFAULT \
+  "name default\n" \
+  "province if coins >= 8 and supply > 0\n" \
+  "duchy if supply:province == 0 and coins >= 5\n" \
+  "gold if coins >= 6 and supply > 0\n" \
+  "silver if coins >= 3 and supply > 0\n"
+
+int strategyParse(struct strategy *s, const char *text);
+/* Compile strategy text into s.  Returns -1, with the offending line
+   reported on stderr, if the text is malformed */
+
+int strategyLoad(struct strategy *s, const char *path);
+/* strategyParse() the contents of a file; -1 if it cannot be read */
+
+int strategyChoose(const struct strategy *s, int player, int coins, int turn, struct gameState *state);
+/* The card s buys for player holding coins on turn, or -1 for no buy.
+   Does not buy it */
+
+int strategyCardNumber(const char *name);
+/* enum CARD value of a card identifier such as "council_room", or -1 */
+
+const char *strategyCardId(int card);
+/* The identifier strategy text uses for card, "?" if out of range */
+
+#endif
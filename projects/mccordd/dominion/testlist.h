@@ -0,0 +1,33 @@
+/* 	Test Registry
+
+	Every test program built into testrunner, in report order.  Each file
+	is compiled with -Dmain=<name>_main (see TESTS in the Makefile, which
+	must list the same names).
+*/
+
+TEST(unittest1)
+TEST(unittest2)
+TEST(unittest3)
+TEST(unittest4)
+TEST(unittest5)
+TEST(unittest6)
+TEST(unittest7)
+TEST(unittest8)
+TEST(unittest9)
+TEST(unittest10)
+TEST(unittest11)
+TEST(unittest12)
+TEST(unittest13)
+TEST(unittest14)
+TEST(unittest16)
+TEST(unittest18)
+TEST(unittest19)
+TEST(unittest20)
+TEST(unittest21)
+TEST(cardtest1)
+TEST(cardtest2)
+TEST(cardtest3)
+TEST(cardtest4)
+TEST(randomtestadventurer)
+TEST(randomtestcard1)
+TEST(randomtestcard2)
@@ -0,0 +1,169 @@
+/* 	Unified Test Runner
+
+	All unit, card and random tests linked into one binary (testlist.h).
+	Each test runs in its own forked worker so a crash, an exit() or the
+	global rngs.c state in one test cannot leak into another; up to -j
+	workers run at once.  Output is captured per test and printed in
+	registration order, followed by a one line status per test.
+
+	Workers leave through exit(), so a -coverage build merges every test's
+	counters into the same .gcda files; run gcov once afterwards.
+
+	Usage:	testrunner [-j workers] [-l] [test...]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/wait.h>
+
+#define TEST(name) int name##_main();
+#include "testlist.h"
+#undef TEST
+
+struct testCase {
+  const char *name;
+  int (*run)();
+  int selected;
+  pid_t pid;
+  FILE *output;
+  int status;
+  double seconds;
+};
+
+#define TEST(name) { #name, name##_main, 0, 0, NULL, 0, 0.0 },
+static struct testCase tests[] = {
+#include "testlist.h"
+};
+#undef TEST
+#define NUM_TESTS ((int)(sizeof(tests) / sizeof(tests[0])))
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int startTest(struct testCase *t) {
+  t->output = tmpfile();
+  if (t->output == NULL)
+    return -1;
+
+  fflush(stdout);
+  t->seconds = now();
+  t->pid = fork();
+  if (t->pid < 0)
+    return -1;
+  if (t->pid == 0) {
+    dup2(fileno(t->output), STDOUT_FILENO);
+    dup2(fileno(t->output), STDERR_FILENO);
+    exit(t->run());
+  }
+  return 0;
+}
+
+static void printOutput(struct testCase *t) {
+  char buf[4096];
+  size_t n;
+
+  printf("%s.c:\n", t->name);
+  rewind(t->output);
+  while ((n = fread(buf, 1, sizeof(buf), t->output)) > 0)
+    fwrite(buf, 1, n, stdout);
+  fclose(t->output);
+}
+
+int main(int argc, char **argv) {
+  int workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  int argi = 1;
+  int i, next, running, status, failed = 0;
+  pid_t pid;
+  double start;
+
+  while (argi < argc && argv[argi][0] == '-') {
+    if (strcmp(argv[argi], "-j") == 0 && argi + 1 < argc) {
+      workers = atoi(argv[++argi]);
+    }
+    else if (strcmp(argv[argi], "-l") == 0) {
+      for (i = 0; i < NUM_TESTS; i++)
+	printf("%s\n", tests[i].name);
+      return EXIT_SUCCESS;
+    }
+    else {
+      printf("Usage: testrunner [-j workers] [-l] [test...]\n");
+      return EXIT_SUCCESS;
+    }
+    argi++;
+  }
+  if (workers < 1)
+    workers = 1;
+
+  //No names means every registered test
+  for (i = 0; i < NUM_TESTS; i++) {
+    int a;
+    tests[i].selected = argi == argc;
+    for (a = argi; a < argc; a++) {
+      if (strcmp(argv[a], tests[i].name) == 0)
+	tests[i].selected = 1;
+    }
+  }
+
+  start = now();
+  next = 0;
+  running = 0;
+  while (next < NUM_TESTS || running > 0) {
+    //Keep every worker slot busy
+    while (running < workers && next < NUM_TESTS) {
+      if (tests[next].selected) {
+	if (startTest(&tests[next]) < 0) {
+	  perror(tests[next].name);
+	  return EXIT_FAILURE;
+	}
+	running++;
+      }
+      next++;
+    }
+    if (running == 0)
+      break;
+
+    pid = wait(&status);
+    if (pid < 0)
+      break;
+    for (i = 0; i < NUM_TESTS; i++) {
+      if (tests[i].selected && tests[i].pid == pid) {
+	tests[i].status = status;
+	tests[i].seconds = now() - tests[i].seconds;
+	running--;
+      }
+    }
+  }
+
+  for (i = 0; i < NUM_TESTS; i++) {
+    if (tests[i].selected)
+      printOutput(&tests[i]);
+  }
+
+  printf("\n********************TEST RUNNER SUMMARY********************\n");
+  for (i = 0; i < NUM_TESTS; i++) {
+    if (!tests[i].selected)
+      continue;
+    status = tests[i].status;
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+      printf("%-22s ok       %6.2fs\n", tests[i].name, tests[i].seconds);
+    }
+    else if (WIFEXITED(status)) {
+      printf("%-22s exit %-3d %6.2fs\n", tests[i].name, WEXITSTATUS(status), tests[i].seconds);
+      failed++;
+    }
+    else {
+      printf("%-22s signal %-2d %5.2fs\n", tests[i].name, WTERMSIG(status), tests[i].seconds);
+      failed++;
+    }
+  }
+  printf("%d worker(s), %.2fs wall time, %d test program(s) did not exit cleanly\n",
+	 workers, now() - start, failed);
+
+  return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,102 @@
+/**************************************************************************************
+    Name: Doug McCord
+    Project: CS 362 -- feature vectors
+    Description:
+    Unit tests for featurevec.c: a fresh game's rows hold the starting
+    decks, supply and scalars at their documented offsets, seats rotate
+    with the perspective, the int8 and float rows agree, and bad states
+    are refused.
+
+***************************************************************************************/
+
+
+
+#include "dominion.h"
+#include "dominion_helpers.h"
+#include "featurevec.h"
+#include "rngs.h"
+
+#include <stdio.h>
+#include <string.h>
+
+
+int main() {
+
+    int k[10] = {adventurer, council_room, feast, gardens, mine,
+                 remodel, smithy, village, baron, great_hall};
+    int perspective[2] = {0, 1};
+    int turns[2] = {3, 300};
+    int i, same, padding, result;
+    //Test pass count
+    int passCount = 0;
+    int testTotal = 0;
+
+    struct gameState G[2];
+    static signed char rows[2 * FEATURE_STRIDE];
+    static float floats[2 * FEATURE_STRIDE];
+
+    printf("****FUNCTION UNIT TEST 10: featuresInt8()****\n");
+
+    memset(G, 0, sizeof(G));
+    initializeGame(2, k, 5, &G[0]);
+    memcpy(&G[1], &G[0], sizeof(struct gameState));
+    G[1].embargoTokens[smithy] = 2;
+
+    printf("TEST 1: starting decks, supply and scalars: \n");
+    memset(rows, 0x55, sizeof(rows));
+    result = featuresInt8(G, 2, perspective, turns, rows);
+    padding = 1;
+    for (i = FEATURE_USED; i < FEATURE_STRIDE; i++) if (rows[i] != 0) padding = 0;
+    testTotal++;
+    if (result == 0
+        && rows[FEATURE_HISTOGRAM + copper] == 7 && rows[FEATURE_HISTOGRAM + estate] == 3
+        && rows[FEATURE_HISTOGRAM + FEATURE_CARDS + copper] == 7
+        && rows[FEATURE_HAND + copper] + rows[FEATURE_HAND + estate] == 5
+        && rows[FEATURE_SUPPLY + copper] == 46 && rows[FEATURE_SUPPLY + salvager] == -1
+        && rows[FEATURE_SCALARS + FEATURE_PLAYERS] == 2 && rows[FEATURE_SCALARS + FEATURE_TURN] == 3
+        && rows[FEATURE_SCALARS + FEATURE_BUYS] == 1 && padding)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 2: second row is seen from player 1 and saturates: \n");
+    testTotal++;
+    if (rows[FEATURE_STRIDE + FEATURE_SCALARS + FEATURE_TO_MOVE] == 1
+        && rows[FEATURE_STRIDE + FEATURE_HAND + copper] == 0
+        && rows[FEATURE_STRIDE + FEATURE_EMBARGO + smithy] == 2
+        && rows[FEATURE_STRIDE + FEATURE_SCALARS + FEATURE_TURN] == 127)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 3: float rows hold the same values unsaturated: \n");
+    testTotal++;
+    same = featuresFloat(G, 2, perspective, turns, floats) == 0;
+    for (i = 0; i < 2 * FEATURE_STRIDE; i++)
+        if (i != FEATURE_STRIDE + FEATURE_SCALARS + FEATURE_TURN && floats[i] != rows[i]) same = 0;
+    if (same && floats[FEATURE_STRIDE + FEATURE_SCALARS + FEATURE_TURN] == 300.0f)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 4: a bad perspective is refused: \n");
+    perspective[1] = 2;
+    testTotal++;
+    if (featuresInt8(G, 2, perspective, NULL, rows) == -1 && featuresFloat(G, 1, NULL, NULL, floats) == 0)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    //TEST SUMMARY:
+    printf("\n****FUNCTION UNIT TEST 10: PASSED %d of %d tests****\n", passCount, testTotal);
+
+    return passCount == testTotal ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+/**************************************************************************************
+    Name: Doug McCord
+    Project: CS 362 -- evaluation network
+    Description:
+    Unit tests for evalnet.c: a written weight file maps back, bad files
+    are refused, batch scores match a plain loop, featuresAfterBuy()
+    matches featurizing a real buy, and a loaded net decides bot buys.
+
+***************************************************************************************/
+
+
+
+#include "dominion.h"
+#include "dominion_helpers.h"
+#include "evalnet.h"
+#include "interface.h"
+#include "rngs.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define HIDDEN EVALNET_LANES
+#define ROWS 3
+
+
+//The score the net should give, one product at a time
+static float plainScore(const signed char weight[][HIDDEN], const float scale[],
+                        const float bias[], const float output[], float outputBias,
+                        int relu, const signed char *row) {
+    float score = outputBias, unit;
+    int h, i, sum;
+    for (h = 0; h < HIDDEN; h++) {
+        sum = 0;
+        for (i = 0; i < FEATURE_STRIDE; i++) sum += weight[i][h] * row[i];
+        unit = sum * scale[h] + bias[h];
+        if (relu && unit < 0) unit = 0;
+        score += output[h] * unit;
+    }
+    return score;
+}
+
+
+int main() {
+
+    int k[10] = {adventurer, council_room, feast, gardens, mine,
+                 remodel, smithy, village, baron, great_hall};
+    static signed char weight[FEATURE_STRIDE][HIDDEN];
+    static signed char rows[ROWS * FEATURE_STRIDE];
+    static signed char after[2][FEATURE_STRIDE];
+    float scale[HIDDEN], bias[HIDDEN], output[HIDDEN], scores[ROWS];
+    char path[64];
+    int h, i, ok, player = 0, turn = 4, card;
+    FILE *file;
+    //Test pass count
+    int passCount = 0;
+    int testTotal = 0;
+
+    struct evalNet net;
+    struct gameState G, bought;
+
+    printf("****FUNCTION UNIT TEST 11: evalnetScore()****\n");
+
+    snprintf(path, sizeof(path), "/tmp/unittest11-%d.net", (int)getpid());
+    for (h = 0; h < HIDDEN; h++) {
+        for (i = 0; i < FEATURE_STRIDE; i++) weight[i][h] = (signed char)((h * 37 + i * 11) % 255 - 127);
+        scale[h] = 0.001f * (h + 1);
+        bias[h] = h - 2.0f;
+        output[h] = h % 2 ? -0.5f : 1.5f;
+    }
+
+    printf("TEST 1: a written weight file maps back: \n");
+    testTotal++;
+    if (evalnetWrite(path, HIDDEN, EVALNET_RELU, scale, bias, output, 0.25f, weight[0]) == 0
+        && evalnetOpen(path, &net) == 0 && net.hidden == HIDDEN && net.outputBias == 0.25f
+        && net.bias[HIDDEN - 1] == bias[HIDDEN - 1] && net.output[1] == output[1]
+        && memcmp(net.weight, weight, sizeof(weight)) == 0
+        && ((unsigned long)net.weight & 63) == 0 && net.size == evalnetFileSize(HIDDEN))
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 2: batch scores match a plain loop: \n");
+    memset(&G, 0, sizeof(G));
+    initializeGame(2, k, 5, &G);
+    featuresInt8(&G, 1, &player, &turn, rows);
+    //A successor of the first row, scored from its sums, and an unrelated row
+    featuresAfterBuy(rows, estate, getCost(estate), rows + FEATURE_STRIDE);
+    for (i = 0; i < FEATURE_STRIDE; i++) rows[2 * FEATURE_STRIDE + i] = (signed char)(127 - i % 200);
+    testTotal++;
+    ok = evalnetScore(&net, rows, ROWS, scores) == 0 && evalnetScore(&net, rows, EVALNET_MAX_BATCH + 1, scores) == -1;
+    for (i = 0; i < ROWS; i++) {
+        float expect = plainScore(weight, scale, bias, output, 0.25f, 1, rows + i * FEATURE_STRIDE);
+        if (scores[i] - expect > 0.001f || expect - scores[i] > 0.001f) ok = 0;
+    }
+    if (ok)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+    evalnetClose(&net);
+
+    printf("TEST 3: bad files are refused: \n");
+    testTotal++;
+    ok = evalnetOpen("/nonexistent/unittest11.net", &net) == -1
+        && evalnetWrite(path, HIDDEN + 1, EVALNET_RELU, scale, bias, output, 0.0f, weight[0]) == -1;
+    file = fopen(path, "r+b");
+    if (file != NULL) {
+        fseek(file, 0, SEEK_SET);
+        fputc('X', file);
+        fclose(file);
+    }
+    ok = ok && evalnetOpen(path, &net) == -1;
+    evalnetWrite(path, HIDDEN, EVALNET_LINEAR, scale, bias, output, 0.0f, weight[0]);
+    ok = ok && truncate(path, evalnetFileSize(HIDDEN) - 1) == 0 && evalnetOpen(path, &net) == -1
+        && net.map == NULL;
+    if (ok)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 4: featuresAfterBuy() matches a real buy: \n");
+    updateCoins(player, &G, 0);
+    memcpy(&bought, &G, sizeof(G));
+    card = G.coins >= getCost(silver) ? silver : copper;
+    buyCard(card, &bought);
+    featuresInt8(&bought, 1, &player, &turn, after[0]);
+    featuresAfterBuy(rows, card, getCost(card), after[1]);
+    testTotal++;
+    if (memcmp(after[0], after[1], FEATURE_STRIDE) == 0)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 5: a loaded net decides bot buys: \n");
+    //One unit counting the player's silvers: silver beats everything, even gold
+    memset(weight, 0, sizeof(weight));
+    memset(output, 0, sizeof(output));
+    weight[FEATURE_HISTOGRAM + silver][0] = 1;
+    scale[0] = 1;
+    bias[0] = 0;
+    output[0] = 1;
+    evalnetWrite(path, HIDDEN, EVALNET_LINEAR, scale, bias, output, 0.0f, weight[0]);
+    for (i = 0; i < 5; i++) G.hand[player][i] = gold;
+    G.handCount[player] = 5;
+    updateCoins(player, &G, 0);
+    memcpy(&bought, &G, sizeof(G));
+    testTotal++;
+    if (loadBotNet("/nonexistent/unittest11.net") == FAILURE && loadBotNet(path) == SUCCESS
+        && botBuyCard(player, turn, &bought) == silver && bought.supplyCount[silver] == G.supplyCount[silver] - 1
+        && loadBotNet(NULL) == SUCCESS && botBuyCard(player, turn, &G) != silver)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+    unlink(path);
+
+    //TEST SUMMARY:
+    printf("\n****FUNCTION UNIT TEST 11: PASSED %d of %d tests****\n", passCount, testTotal);
+
+    return passCount == testTotal ? 0 : 1;
+}
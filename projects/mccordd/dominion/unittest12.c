@@ -0,0 +1,143 @@
+/**************************************************************************************
+    Name: Doug McCord
+    Project: CS 362 -- library API
+    Description:
+    Unit tests for libdominion.c, through libdominion.h alone (make libtest
+    runs them against libdominion.so): games start in a pool and refuse
+    bad arguments, actions and fetches work in batches, a game's shuffles
+    do not depend on what other games do in between, and domRunGames()
+    repeats for a seed.
+
+***************************************************************************************/
+
+
+
+#include "libdominion.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define GAMES 3
+
+
+int main() {
+
+    //adventurer, council_room, feast, gardens, mine, remodel, smithy, village, baron, great_hall
+    int k[10] = {7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+    int games[GAMES], results[8], out[GAMES * DOM_MAX_PLAYERS * DOM_NUM_CARDS];
+    int other[DOM_MAX_PLAYERS * DOM_NUM_CARDS];
+    int winners[2][4], turns[2][4], scores[2][8];
+    static signed char rows[GAMES * DOM_FEATURE_STRIDE];
+    struct domAction actions[8];
+    const struct domStrategy *seats[2];
+    struct domStrategy *strategy;
+    struct domPool *pool, *alone;
+    int i, round, same;
+    //Test pass count
+    int passCount = 0;
+    int testTotal = 0;
+
+    printf("****FUNCTION UNIT TEST 12: libdominion API****\n");
+
+    printf("TEST 1: games fill a pool and bad arguments are refused: \n");
+    pool = domPoolCreate(GAMES);
+    for (i = 0; i < GAMES; i++) games[i] = domGameNew(pool, 2, k, 10 + i);
+    testTotal++;
+    if (domApiVersion() == DOM_API_VERSION && pool != NULL
+        && games[0] == 0 && games[1] == 1 && games[2] == 2
+        && domGameNew(pool, 2, k, 99) == -1 && domPoolCreate(0) == NULL)
+    {
+        domGameFree(pool, games[1]);
+        if (domGameNew(pool, 5, k, 1) == -1 && domGameNew(pool, 2, k, 0) == -1
+            && domGameNew(pool, 2, k, 11) == 1)
+        {
+            printf("PASSED\n");
+            passCount++;
+        }
+        else printf("TEST FAILED\n");
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 2: a batch of actions across games, fetched into arrays: \n");
+    memset(actions, 0, sizeof(actions));
+    actions[0].game = 0; actions[0].type = DOM_BUY; actions[0].arg = 4;     //copper
+    actions[1].game = 1; actions[1].type = DOM_BUY; actions[1].arg = 99;
+    actions[2].game = 2; actions[2].type = DOM_END_TURN;
+    actions[3].game = 7; actions[3].type = DOM_END_TURN;
+    testTotal++;
+    if (domStep(pool, actions, 4, results) == 2
+        && results[0] == 0 && results[1] == -1 && results[2] == 0 && results[3] == -1
+        && domFetch(pool, games, GAMES, DOM_SUPPLY, out) == DOM_NUM_CARDS
+        && out[4] == 45 && out[DOM_NUM_CARDS + 4] == 46 && out[25] == -1
+        && domFetch(pool, games, GAMES, DOM_WHOSE_TURN, out) == 1
+        && out[0] == 0 && out[1] == 0 && out[2] == 1
+        && domFetch(pool, games, GAMES, 99, out) == -1
+        && domFeatures(pool, games, GAMES, rows) == 0 && rows[2 * DOM_FEATURE_STRIDE + 4] == 7)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 3: a game's shuffles ignore the games played in between: \n");
+    //Each turn buys a free card, curse or copper, so the discard pile outgrows
+    //a hand and what is drawn depends on the order of the shuffles
+    domPoolDestroy(pool);
+    pool = domPoolCreate(2);
+    alone = domPoolCreate(1);
+    domGameNew(pool, 2, k, 12);
+    domGameNew(pool, 2, k, 30);
+    domGameNew(alone, 2, k, 12);
+    memset(actions, 0, sizeof(actions));
+    for (i = 0; i < 4; i++) {
+        actions[i].game = i % 2;
+        actions[i].type = i < 2 ? DOM_BUY : DOM_END_TURN;
+    }
+    same = 1;
+    games[0] = 0;
+    for (round = 0; round < 8; round++) {
+        actions[0].arg = actions[1].arg = round % 3 ? 4 : 0;
+        domStep(pool, actions, 4, NULL);
+        actions[1].game = 0;
+        actions[1].type = DOM_END_TURN;
+        domStep(alone, actions, 2, NULL);
+        actions[1].game = 1;
+        actions[1].type = DOM_BUY;
+        domFetch(pool, games, 1, DOM_HANDS, out);
+        domFetch(alone, games, 1, DOM_HANDS, other);
+        if (memcmp(out, other, sizeof(other)) != 0) same = 0;
+    }
+    testTotal++;
+    if (same)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+    domPoolDestroy(alone);
+    domPoolDestroy(pool);
+
+    printf("TEST 4: domRunGames() repeats for a seed: \n");
+    strategy = domStrategyParse("gold if coins >= 6\nsilver\n");
+    seats[0] = strategy;
+    seats[1] = strategy;
+    same = domRunGames(seats, 2, k, 5, 4, 20, winners[0], turns[0], scores[0]) == 4
+        && domRunGames(seats, 2, k, 5, 4, 20, winners[1], turns[1], scores[1]) == 4
+        && memcmp(scores[0], scores[1], sizeof(scores[0])) == 0
+        && memcmp(winners[0], winners[1], sizeof(winners[0])) == 0
+        && domRunGames(seats, 2, k, 5, 4, 20, NULL, NULL, NULL) == 4;
+    testTotal++;
+    if (same && strategy != NULL && domStrategyParse("bogus card\n") == NULL
+        && domRunGames(seats, 1, k, 5, 4, 20, NULL, NULL, NULL) == -1)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+    domStrategyFree(strategy);
+
+    //TEST SUMMARY:
+    printf("\n****FUNCTION UNIT TEST 12: PASSED %d of %d tests****\n", passCount, testTotal);
+
+    return passCount == testTotal ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+/**************************************************************************************
+    Name: Doug McCord
+    Project: CS 362 -- game prototypes
+    Description:
+    Unit tests for initializePrototype() and initializeFromPrototype():
+    they refuse what initializeGame() refuses, and a game stamped from a
+    prototype is initializeGame()'s game byte for byte, random stream
+    included, whatever the state held before.
+
+***************************************************************************************/
+
+
+
+#include "dominion.h"
+#include "dominion_helpers.h"
+#include "rngs.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define SEEDS 200
+
+
+//Compare initializeGame() and a prototype on every seed, each into a
+//state that starts out holding fill
+static int sameGames(int numPlayers, int k[10], int fill) {
+    static struct gameState expected, stamped;
+    struct gamePrototype prototype, copy;
+    long expectedSeed, stampedSeed;
+    int seed;
+
+    if (initializePrototype(numPlayers, k, &prototype) != 0) return 0;
+    copy = prototype;
+    for (seed = 1; seed <= SEEDS; seed++) {
+        memset(&expected, fill, sizeof(struct gameState));
+        memset(&stamped, fill, sizeof(struct gameState));
+        if (initializeGame(numPlayers, k, seed * 7919, &expected) != 0) return 0;
+        GetSeed(&expectedSeed);
+        if (initializeFromPrototype(&prototype, seed * 7919, &stamped) != 0) return 0;
+        GetSeed(&stampedSeed);
+        if (memcmp(&expected, &stamped, sizeof(struct gameState)) != 0
+            || expectedSeed != stampedSeed) return 0;
+    }
+    return memcmp(&prototype, &copy, sizeof(prototype)) == 0;
+}
+
+
+int main() {
+
+    //adventurer, council_room, feast, gardens, mine, remodel, smithy, village, baron, great_hall
+    int k[10] = {7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+    //embargo, outpost, salvager, sea_hag, treasure_map, minion, steward, tribute, ambassador, cutpurse
+    int other[10] = {22, 23, 24, 25, 26, 17, 18, 19, 20, 21};
+    int twice[10] = {7, 8, 9, 10, 11, 12, 13, 14, 15, 7};
+    //copper is not a kingdom card, and initializeGame() passes over it
+    int copperK[10] = {4, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+    struct gamePrototype prototype;
+    int numPlayers, same;
+    //Test pass count
+    int passCount = 0;
+    int testTotal = 0;
+
+    printf("****FUNCTION UNIT TEST 13: initializePrototype() and initializeFromPrototype()****\n");
+
+    printf("TEST 1: the arguments initializeGame() refuses are refused: \n");
+    testTotal++;
+    if (initializePrototype(1, k, &prototype) == -1 && initializePrototype(MAX_PLAYERS + 1, k, &prototype) == -1
+        && initializePrototype(2, twice, &prototype) == -1 && initializePrototype(2, k, &prototype) == 0
+        && prototype.numPlayers == 2 && prototype.supplyCount[gardens] == 8
+        && prototype.supplyCount[smithy] == 10 && prototype.supplyCount[minion] == -1)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 2: every player count and kingdom matches initializeGame(): \n");
+    same = 1;
+    for (numPlayers = 2; numPlayers <= MAX_PLAYERS; numPlayers++) {
+        if (!sameGames(numPlayers, k, 0) || !sameGames(numPlayers, other, 0)
+            || !sameGames(numPlayers, copperK, 0)) same = 0;
+    }
+    testTotal++;
+    if (same)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 3: a used state is initialized as initializeGame() leaves it: \n");
+    testTotal++;
+    if (sameGames(2, k, 0x55) && sameGames(MAX_PLAYERS, other, 0xff))
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    //TEST SUMMARY:
+    printf("\n****FUNCTION UNIT TEST 13: PASSED %d of %d tests****\n", passCount, testTotal);
+
+    return passCount == testTotal ? 0 : 1;
+}
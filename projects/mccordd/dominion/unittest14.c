@@ -0,0 +1,150 @@
+/**************************************************************************************
+    Name: Doug McCord
+    Project: CS 362 -- kingdom-specialized engines
+    Description:
+    Unit tests for kingdomengine.c and the engines kingdomgen builds from
+    kingdoms.list: a kingdom finds its engine in any order and anything
+    else gets the generic one, each specialized engine plays the same
+    games as the generic engine on its kingdom, and it refuses the cards
+    its kingdom lacks.
+
+***************************************************************************************/
+
+
+
+#include "dominion.h"
+#include "dominion_helpers.h"
+#include "kingdomengine.h"
+#include "strategy.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define SEEDS 20
+#define TURNS 25
+
+//Buys action cards and both victory kingdom cards where it can, so card
+//effects and scoreFor() are exercised
+#define TEST_STRATEGY \
+  "province if coins >= 8\n" \
+  "gold if coins >= 6 and owned >= 2\n" \
+  "council_room if coins >= 5 and owned < 1\n" \
+  "gardens if coins >= 4 and owned < 2\n" \
+  "smithy if coins >= 4 and owned < 2\n" \
+  "village if coins >= 3 and owned < 2\n" \
+  "great_hall if coins >= 3 and owned < 2\n" \
+  "silver if coins >= 3\n"
+
+
+//The ten kingdom cards of an engine's card set, in card order
+static void kingdomOf(unsigned int cards, int kingdom[10]) {
+    int card, n = 0;
+
+    for (card = adventurer; card <= treasure_map; card++) {
+        if ((cards >> card) & 1) kingdom[n++] = card;
+    }
+}
+
+
+int main() {
+
+    //evolve's kingdom, listed in another order
+    int evolveK[10] = {smithy, tribute, council_room, cutpurse, mine, minion, village, embargo, gardens, adventurer};
+    int unlisted[10] = {7, 8, 9, 10, 11, 12, 13, 14, 15, 17};
+    int twice[10] = {7, 8, 9, 10, 11, 12, 13, 14, 15, 7};
+    int k[10];
+    const struct kingdomEngine *engine;
+    const struct strategy *seats[2];
+    struct strategy buyer, big;
+    struct gamePrototype prototype;
+    struct gameResult expected, result;
+    static struct gameState generic, special;
+    int e, i, seed, same, refused;
+    //Test pass count
+    int passCount = 0;
+    int testTotal = 0;
+
+    printf("****FUNCTION UNIT TEST 14: kingdom-specialized engines****\n");
+
+    printf("TEST 1: a kingdom finds its engine in any order, others the generic one: \n");
+    engine = kingdomEngineFor(evolveK);
+    testTotal++;
+    if (numKingdomEngines >= 1 && strcmp(engine->name, "evolve") == 0
+        && engine->cards == kingdomCardSet(evolveK) && engine->cards != genericEngine.cards
+        && kingdomEngineFor(unlisted) == &genericEngine && kingdomEngineFor(twice) == &genericEngine
+        && kingdomCardSet(twice) == 0 && genericEngine.playCard == playCard)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 2: each specialized engine plays its cards as the generic engine does: \n");
+    //Every kingdom card played from the same states by both engines, then
+    //scored with a copy of it in the discard pile
+    same = 1;
+    for (e = 0; e < numKingdomEngines; e++) {
+        kingdomOf(kingdomEngines[e].cards, k);
+        if (kingdomEngineFor(k) != &kingdomEngines[e] || initializePrototype(2, k, &prototype) != 0) same = 0;
+        for (i = 0; same && i < 10; i++) {
+            for (seed = 1; same && seed <= SEEDS; seed++) {
+                memset(&generic, 0, sizeof(generic));
+                initializeFromPrototype(&prototype, seed, &generic);
+                generic.hand[0][0] = k[i];
+                special = generic;
+                if (playCard(0, 1, estate, 0, &generic) != kingdomEngines[e].playCard(0, 1, estate, 0, &special)) same = 0;
+                generic.discard[0][generic.discardCount[0]++] = k[i];
+                special.discard[0][special.discardCount[0]++] = k[i];
+                if (memcmp(&generic, &special, sizeof(generic)) != 0
+                    || scoreFor(0, &generic) != kingdomEngines[e].scoreFor(0, &special)
+                    || isGameOver(&generic) != kingdomEngines[e].isGameOver(&special)) same = 0;
+            }
+        }
+    }
+    //and whole games, which go through the engine's own simulate.c
+    strategyParse(&buyer, TEST_STRATEGY);
+    strategyParse(&big, STRATEGY_DEFAULT);
+    seats[0] = &buyer;
+    seats[1] = &big;
+    for (e = 0; same && e < numKingdomEngines; e++) {
+        kingdomOf(kingdomEngines[e].cards, k);
+        initializePrototype(2, k, &prototype);
+        for (seed = 1; same && seed <= SEEDS; seed++) {
+            simulatePrototype(seats, &prototype, seed, TURNS, &expected);
+            kingdomEngines[e].simulatePrototype(seats, &prototype, seed, TURNS, &result);
+            if (memcmp(&expected, &result, sizeof(result)) != 0) same = 0;
+        }
+    }
+    testTotal++;
+    if (same && numKingdomEngines >= 1)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 3: a specialized engine refuses a card its kingdom lacks: \n");
+    //baron is not in evolve's kingdom; the generic engine plays it
+    engine = kingdomEngineFor(evolveK);
+    initializePrototype(2, evolveK, &prototype);
+    memset(&generic, 0, sizeof(generic));
+    initializeFromPrototype(&prototype, 3, &generic);
+    generic.hand[0][0] = baron;
+    special = generic;
+    refused = engine->playCard(0, 0, 0, 0, &special) == -1
+        && memcmp(&special, &generic, sizeof(special)) == 0;
+    testTotal++;
+    if (refused && playCard(0, 0, 0, 0, &generic) == 0 && generic.numBuys == 2
+        && engine->isGameOver(&special) == isGameOver(&special)
+        && engine->scoreFor(0, &special) == scoreFor(0, &special))
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    //TEST SUMMARY:
+    printf("\n****FUNCTION UNIT TEST 14: PASSED %d of %d tests****\n", passCount, testTotal);
+
+    return passCount == testTotal ? 0 : 1;
+}
@@ -0,0 +1,87 @@
+/**************************************************************************************
+    Name: Doug McCord
+    Project: CS 362 -- 2-player engine build
+    Description:
+    Unit tests for the engine built with -DFIXED_PLAYERS=2 (the Makefile
+    builds this file that way): only 2-player games start, a prototype
+    still stamps out initializeGame()'s games, and the loops over the
+    other players reach the second seat.
+
+***************************************************************************************/
+
+
+
+#include "dominion.h"
+#include "dominion_helpers.h"
+#include "rngs.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define SEEDS 50
+
+
+int main() {
+
+    //adventurer, council_room, feast, gardens, mine, remodel, smithy, village, baron, sea_hag
+    int k[10] = {7, 8, 9, 10, 11, 12, 13, 14, 15, 25};
+    static struct gameState expected, stamped;
+    struct gamePrototype prototype;
+    int seed, same;
+    //Test pass count
+    int passCount = 0;
+    int testTotal = 0;
+
+    printf("****FUNCTION UNIT TEST 15: 2-player engine build****\n");
+
+    printf("TEST 1: only 2-player games start: \n");
+    testTotal++;
+#ifdef FIXED_PLAYERS
+    if (MAX_PLAYERS == 2 && NUM_PLAYERS(&expected) == 2
+        && initializeGame(3, k, 1, &expected) == -1 && initializeGame(1, k, 1, &expected) == -1
+        && initializePrototype(3, k, &prototype) == -1 && initializeGame(2, k, 1, &expected) == 0)
+#else
+    if (0)
+#endif
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 2: a prototype stamps out initializeGame()'s games: \n");
+    same = initializePrototype(2, k, &prototype) == 0;
+    for (seed = 1; same && seed <= SEEDS; seed++) {
+        memset(&expected, 0, sizeof(expected));
+        memset(&stamped, 0, sizeof(stamped));
+        initializeGame(2, k, seed, &expected);
+        initializeFromPrototype(&prototype, seed, &stamped);
+        if (memcmp(&expected, &stamped, sizeof(expected)) != 0) same = 0;
+    }
+    testTotal++;
+    if (same)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 3: sea_hag reaches the other seat: \n");
+    //Seat 1 has not drawn, so its whole deck is there to lose cards
+    memset(&expected, 0, sizeof(expected));
+    initializeFromPrototype(&prototype, 7, &expected);
+    expected.hand[0][0] = sea_hag;
+    testTotal++;
+    if (playCard(0, 0, 0, 0, &expected) == 0 && expected.discardCount[1] == 1
+        && expected.deckCount[1] == 7 && expected.deck[1][8] == curse)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    //TEST SUMMARY:
+    printf("\n****FUNCTION UNIT TEST 15: PASSED %d of %d tests****\n", passCount, testTotal);
+
+    return passCount == testTotal ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+/**************************************************************************************
+    Name: Doug McCord
+    Project: CS 362 -- headless simulation
+    Description:
+    Unit tests for simulateGame(): games on playdom's kingdom are played
+    to the end, not to the turn cap, so every player gets a real hand
+    each turn and buys victory cards.
+
+***************************************************************************************/
+
+
+
+#include "dominion.h"
+#include "dominion_helpers.h"
+#include "simulate.h"
+#include "strategy.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define SEEDS 50
+
+#define UNITTEST16_SMITHY \
+  "name smithy\n" \
+  "province if coins >= 8\n" \
+  "gold if coins >= 6\n" \
+  "smithy if coins >= 4 and owned < 2\n" \
+  "silver if coins >= 3\n"
+
+
+int main() {
+
+    //playdom's kingdom
+    int k[10] = {adventurer, gardens, embargo, village, minion, mine, cutpurse,
+                 council_room, tribute, smithy};
+    struct strategy bigMoney, smithyMoney;
+    const struct strategy *seats[MAX_PLAYERS];
+    struct gameResult result;
+    struct gameState state;
+    int seed, finished, scored, bounded;
+    //Test pass count
+    int passCount = 0;
+    int testTotal = 0;
+
+    printf("****FUNCTION UNIT TEST 16: simulateGame()****\n");
+
+    strategyParse(&bigMoney, STRATEGY_DEFAULT);
+    strategyParse(&smithyMoney, UNITTEST16_SMITHY);
+
+    printf("TEST 1: the next player starts a turn with five cards: \n");
+    testTotal++;
+    memset(&state, 0, sizeof(struct gameState));
+    initializeGame(2, k, 1, &state);
+    endTurn(&state);
+    if (whoseTurn(&state) == 1 && numHandCards(&state) == 5 && state.deckCount[1] == 5
+        && state.handCount[0] == 0 && state.discardCount[0] == 5)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 2: 2-player games end before the turn cap with points scored: \n");
+    finished = scored = bounded = 0;
+    seats[0] = &smithyMoney;
+    seats[1] = &bigMoney;
+    for (seed = 1; seed <= SEEDS; seed++) {
+        if (simulateGame(seats, 2, k, seed, SIMULATE_MAX_TURNS, &result) != 0) continue;
+        finished += result.finished;
+        bounded += result.turns < SIMULATE_MAX_TURNS;
+        scored += result.scores[0] > 0 || result.scores[1] > 0;
+    }
+    testTotal++;
+    if (finished == SEEDS && bounded == SEEDS && scored == SEEDS)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED: %d of %d finished, %d scored\n", finished, SEEDS, scored);
+
+    printf("TEST 3: 4-player games end before the turn cap too: \n");
+    finished = 0;
+    seats[2] = &smithyMoney;
+    seats[3] = &bigMoney;
+    for (seed = 1; seed <= SEEDS; seed++) {
+        if (simulateGame(seats, 4, k, seed, SIMULATE_MAX_TURNS, &result) == 0
+            && result.finished && result.turns < SIMULATE_MAX_TURNS) finished++;
+    }
+    testTotal++;
+    if (finished == SEEDS)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED: %d of %d finished\n", finished, SEEDS);
+
+    //TEST SUMMARY:
+    printf("\n****FUNCTION UNIT TEST 16: PASSED %d of %d tests****\n", passCount, testTotal);
+
+    return passCount == testTotal ? 0 : 1;
+}
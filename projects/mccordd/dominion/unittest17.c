@@ -0,0 +1,128 @@
+/**************************************************************************************
+    Name: Doug McCord
+    Project: CS 362 -- card profiling
+    Description:
+    Unit tests for the -DDOM_PROFILE counters (profile.h): play whole
+    games, tallying every card put through playCard(), and check that
+    profileMerge() reports the same calls per card and the draws each
+    card made.
+
+***************************************************************************************/
+
+
+
+#include "dominion.h"
+#include "dominion_helpers.h"
+#include "profile.h"
+#include "simulate.h"
+#include "strategy.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define SEEDS 20
+
+#define UNITTEST17_ENGINE \
+  "name engine\n" \
+  "province if coins >= 8\n" \
+  "gold if coins >= 6\n" \
+  "council_room if coins >= 5 and owned < 1\n" \
+  "smithy if coins >= 4 and owned < 2\n" \
+  "village if coins >= 3 and owned < 2\n" \
+  "silver if coins >= 3\n"
+
+
+//Play one game to the end as simulateGame() would, adding each card
+//played to played[] and each turn ended to *turns
+static void playGame(int k[10], int seed, const struct strategy *strategy,
+                     unsigned long played[], unsigned long *turns) {
+    static struct gameState state;
+    int round = 0, pos, card;
+
+    memset(&state, 0, sizeof(struct gameState));
+    initializeGame(2, k, seed, &state);
+    while (!isGameOver(&state) && round < SIMULATE_MAX_TURNS) {
+        while (state.numActions > 0 && (pos = pickAction(&state)) >= 0) {
+            card = handCard(pos, &state);
+            played[card]++;
+            if (playCard(pos, -1, -1, -1, &state) != 0) break;
+        }
+        while (state.numBuys > 0) {
+            card = strategyChoose(strategy, whoseTurn(&state), state.coins, round, &state);
+            if (card < 0 || buyCard(card, &state) != 0) break;
+        }
+        if (whoseTurn(&state) == 1) round++;
+        endTurn(&state);
+        (*turns)++;
+    }
+}
+
+
+int main() {
+
+    //playdom's kingdom
+    int k[10] = {adventurer, gardens, embargo, village, minion, mine, cutpurse,
+                 council_room, tribute, smithy};
+    struct strategy strategy;
+    struct cardProfile total;
+    unsigned long played[PROFILE_SLOTS];
+    unsigned long turns = 0, actions = 0;
+    int seed, card, same;
+    //Test pass count
+    int passCount = 0;
+    int testTotal = 0;
+
+    printf("****FUNCTION UNIT TEST 17: profile counters****\n");
+
+    strategyParse(&strategy, UNITTEST17_ENGINE);
+    memset(played, 0, sizeof(played));
+    profileReset();
+    for (seed = 1; seed <= SEEDS; seed++) {
+        playGame(k, seed, &strategy, played, &turns);
+    }
+    profileMerge(&total);
+
+    printf("TEST 1: calls per card match the cards played: \n");
+    same = total.calls[PROFILE_NO_CARD] == 0;
+    for (card = 0; card <= treasure_map; card++) {
+        if (total.calls[card] != played[card]) same = 0;
+        actions += played[card];
+    }
+    testTotal++;
+    if (same && played[smithy] > 0 && played[village] > 0 && played[council_room] > 0)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED: %lu cards played\n", actions);
+
+    printf("TEST 2: smithy made 3 draws a play, turn starts 5 a turn: \n");
+    testTotal++;
+    if (total.draws[smithy] == 3 * played[smithy]
+        && total.draws[PROFILE_NO_CARD] == 5 * (SEEDS + turns))
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 3: profileReset() zeroes every counter: \n");
+    profileReset();
+    profileMerge(&total);
+    same = 1;
+    for (card = 0; card < PROFILE_SLOTS; card++) {
+        if (total.calls[card] || total.draws[card] || total.shuffles[card] || total.ticks[card]) same = 0;
+    }
+    testTotal++;
+    if (same)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    //TEST SUMMARY:
+    printf("\n****FUNCTION UNIT TEST 17: PASSED %d of %d tests****\n", passCount, testTotal);
+
+    return passCount == testTotal ? 0 : 1;
+}
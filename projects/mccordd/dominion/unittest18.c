@@ -0,0 +1,122 @@
+/**************************************************************************************
+    Name: Doug McCord
+    Project: CS 362 -- win probability
+    Description:
+    Unit tests for winProbability(): a seed repeats exactly on one
+    thread, a decided game is called for its leader, the caller's random
+    stream is left alone, and rollouts that reach the turn cap are
+    counted apart instead of as wins or losses.
+
+***************************************************************************************/
+
+
+
+#include "dominion.h"
+#include "rngs.h"
+#include "simulate.h"
+#include "strategy.h"
+#include "winprob.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define ROLLOUTS 200
+#define BUDGET 60.0		//seconds; the rollout count is what stops these runs
+
+//Never buys, so nobody ever ends the game
+#define UNITTEST18_IDLE \
+  "name idle\n"
+
+
+int main() {
+
+    //playdom's kingdom
+    int k[10] = {adventurer, gardens, embargo, village, minion, mine, cutpurse,
+                 council_room, tribute, smithy};
+    struct strategy bigMoney, idle;
+    const struct strategy *seats[MAX_PLAYERS];
+    struct winEstimate first, second;
+    struct gameState state, before;
+    long seedBefore, seedAfter;
+    double drawBefore, drawAfter;
+    int i;
+    //Test pass count
+    int passCount = 0;
+    int testTotal = 0;
+
+    printf("****FUNCTION UNIT TEST 18: winProbability()****\n");
+
+    strategyParse(&bigMoney, STRATEGY_DEFAULT);
+    strategyParse(&idle, UNITTEST18_IDLE);
+    for (i = 0; i < MAX_PLAYERS; i++) {
+        seats[i] = &bigMoney;
+    }
+
+    printf("TEST 1: one thread and one seed repeat exactly: \n");
+    testTotal++;
+    memset(&state, 0, sizeof(struct gameState));
+    initializeGame(2, k, 4, &state);
+    if (winProbability(0, &state, seats, 0, BUDGET, ROLLOUTS, 1, 9, &first) == 0
+        && winProbability(0, &state, seats, 0, BUDGET, ROLLOUTS, 1, 9, &second) == 0
+        && first.rollouts + first.capped == ROLLOUTS && first.rollouts > 0
+        && first.p == second.p && first.rollouts == second.rollouts && first.capped == second.capped
+        && first.p > 0 && first.p < 1 && first.low <= first.p && first.p <= first.high)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 2: a game already won is called for the winner: \n");
+    testTotal++;
+    for (i = 0; i < 6; i++) {
+        state.discard[0][state.discardCount[0]++] = province;
+    }
+    state.supplyCount[province] = 0;
+    if (winProbability(0, &state, seats, 0, BUDGET, ROLLOUTS, 1, 9, &first) == 0
+        && winProbability(1, &state, seats, 0, BUDGET, ROLLOUTS, 1, 9, &second) == 0
+        && first.rollouts == ROLLOUTS && first.p == 1.0 && second.p == 0.0 && first.high <= 1.0)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 3: the caller's game and random stream are left as they were: \n");
+    testTotal++;
+    memset(&state, 0, sizeof(struct gameState));
+    initializeGame(3, k, 5, &state);
+    memcpy(&before, &state, sizeof(struct gameState));
+    SelectStream(1);
+    PutSeed(777);
+    GetSeed(&seedBefore);
+    drawBefore = Random();
+    PutSeed(777);
+    winProbability(2, &state, seats, 0, BUDGET, ROLLOUTS, 2, 9, &first);
+    GetSeed(&seedAfter);
+    drawAfter = Random();
+    if (seedBefore == seedAfter && drawBefore == drawAfter
+        && memcmp(&before, &state, sizeof(struct gameState)) == 0)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 4: rollouts cut off at the turn cap are not counted: \n");
+    testTotal++;
+    for (i = 0; i < MAX_PLAYERS; i++) {
+        seats[i] = &idle;
+    }
+    if (winProbability(0, &state, seats, 0, BUDGET, 20, 1, 9, &first) == 0
+        && first.capped == 20 && first.rollouts == 0 && first.p == 0)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    //TEST SUMMARY:
+    printf("\n****FUNCTION UNIT TEST 18: PASSED %d of %d tests****\n", passCount, testTotal);
+    return passCount == testTotal ? 0 : 1;
+}
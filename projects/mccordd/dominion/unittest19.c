@@ -0,0 +1,135 @@
+/**************************************************************************************
+    Name: Doug McCord
+    Project: CS 362 -- command latency
+    Description:
+    Unit tests for the latency.c histograms: bucket edges below 64, at
+    every power of two and at the 2^40-1 clamp, percentile ranks on a
+    known distribution, and latencyReadP99() reading back a
+    latencyDump() listing.
+
+***************************************************************************************/
+
+
+
+#include "latency.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define LIMIT ((1ULL << LATENCY_MAX_BITS) - 1)
+
+
+//Largest value sharing ns's bucket: ns and the clamp recorded, the lower one's bucket reported
+static unsigned long long bucketTop(unsigned long long ns) {
+    struct latencyHistogram h;
+    latencyReset(&h);
+    latencyRecord(&h, ns);
+    latencyRecord(&h, LIMIT);
+    return latencyPercentile(&h, 50.0);
+}
+
+
+int main() {
+
+    struct latencyHistogram h, other;
+    unsigned long long v, p99, width;
+    int k, ok;
+    FILE *listing;
+    //Test pass count
+    int passCount = 0;
+    int testTotal = 0;
+
+    printf("****FUNCTION UNIT TEST 19: latencyRecord(), latencyPercentile(), latencyReadP99()****\n");
+
+    printf("TEST 1: values below 64 get a bucket each, and 64 starts the split buckets: \n");
+    testTotal++;
+    ok = 1;
+    for (v = 0; v < 64; v++) {
+        ok = ok && bucketTop(v) == v;
+    }
+    if (ok && bucketTop(64) == 65 && bucketTop(65) == 65 && bucketTop(66) == 67
+        && bucketTop(127) == 127 && bucketTop(128) == 131)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 2: every power of two starts a bucket 1/32 of it wide: \n");
+    testTotal++;
+    ok = 1;
+    for (k = LATENCY_SUB_BITS; k < LATENCY_MAX_BITS; k++) {
+        v = 1ULL << k;
+        width = v >> (LATENCY_SUB_BITS - 1);
+        ok = ok && bucketTop(v - 1) == v - 1 && bucketTop(v) == v + width - 1
+            && bucketTop(v + width - 1) == v + width - 1 && bucketTop(v + width) == v + 2 * width - 1;
+    }
+    if (ok)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 3: 2^40-1 is the last bucket, and larger values are clamped to it: \n");
+    testTotal++;
+    latencyReset(&h);
+    latencyRecord(&h, 1ULL << 45);
+    latencyRecord(&h, ~0ULL);
+    if (bucketTop(LIMIT) == LIMIT && bucketTop(LIMIT - 1) == LIMIT
+        && bucketTop((1ULL << 39) + (1ULL << 38)) == (1ULL << 39) + (1ULL << 38) + (1ULL << 34) - 1
+        && h.max == LIMIT && h.min == LIMIT && latencyPercentile(&h, 50.0) == LIMIT)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 4: percentiles of 1..50 and 1..10000 land on their ranks: \n");
+    testTotal++;
+    latencyReset(&h);
+    for (v = 1; v <= 50; v++) {
+        latencyRecord(&h, v);
+    }
+    latencyReset(&other);
+    for (v = 1; v <= 10000; v++) {
+        latencyRecord(&other, v);
+    }
+    p99 = latencyPercentile(&other, 99.0);
+    if (latencyPercentile(&h, 0.0) == 1 && latencyPercentile(&h, 50.0) == 25
+        && latencyPercentile(&h, 90.0) == 45 && latencyPercentile(&h, 100.0) == 50
+        && p99 >= 9900 && p99 <= 9900 + 9900 / 32 && p99 == bucketTop(9900)
+        && latencyPercentile(&other, 100.0) == 10000 && other.total == 50005000ULL
+        && latencyPercentile(&h, 99.0) == 50)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 5: latencyReadP99() reads back what latencyDump() wrote: \n");
+    testTotal++;
+    listing = tmpfile();
+    latencyMerge(&other, &h);
+    ok = listing != NULL;
+    if (ok) {
+        latencyDumpHeader(listing);
+        latencyDump(listing, "play", &h);
+        latencyDump(listing, "bot", &other);
+        ok = latencyReadP99(listing, "bot", &p99) == 0 && p99 == latencyPercentile(&other, 99.0)
+            && latencyReadP99(listing, "play", &p99) == 0 && p99 == 50
+            && latencyReadP99(listing, "buy", &p99) == -1
+            && latencyReadP99(listing, "#cmd", &p99) == -1;
+        fclose(listing);
+    }
+    if (ok)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    //TEST SUMMARY:
+    printf("\n****FUNCTION UNIT TEST 19: PASSED %d of %d tests****\n", passCount, testTotal);
+    return passCount == testTotal ? 0 : 1;
+}
@@ -0,0 +1,255 @@
+/**************************************************************************************
+    Name: Doug McCord
+    Project: CS 362 -- buffered output
+    Description:
+    Unit tests for the format functions behind show, supp, stat and the
+    other print commands: in PRINT_HUMAN each snapshot of a fixed-seed
+    game must match, byte for byte, what the old printf versions of
+    printHand() and the rest wrote, and in PRINT_COMPACT each line must
+    parse back to the same cards, counts and scores.  A buffer too small
+    for a snapshot must drop the tail and count it, never overrun.
+
+***************************************************************************************/
+
+
+
+#include "dominion.h"
+#include "interface.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SEED 1
+#define REFERENCE_SIZE PRINT_BUFFER_SIZE
+
+
+//The printf versions the format functions replaced, writing to out instead of stdout
+
+static void referenceCards(FILE *out, int player, const char *title, const char *rowEnd,
+                           const int *cards, int count) {
+    int index;
+    char name[MAX_STRING_LENGTH];
+    fprintf(out, "Player %d's %s", player, title);
+    if (count > 0) fprintf(out, "#  Card\n");
+    for (index = 0; index < count; index++) {
+        cardNumToName(cards[index], name);
+        fprintf(out, "%-2d %-13s%s", index, name, rowEnd);
+    }
+    fprintf(out, "\n");
+}
+
+static void referenceSupply(FILE *out, struct gameState *game) {
+    int cardNum, cardCount;
+    char name[MAX_STRING_LENGTH];
+    fprintf(out, "#   Card          Cost   Copies\n");
+    for (cardNum = 0; cardNum < NUM_TOTAL_K_CARDS; cardNum++) {
+        cardCount = game->supplyCount[cardNum];
+        if (cardCount == -1) continue;
+        cardNumToName(cardNum, name);
+        fprintf(out, "%-2d  %-13s %-5d  %-5d", cardNum, name, getCardCost(cardNum), cardCount);
+        fprintf(out, "\n");
+    }
+    fprintf(out, "\n");
+}
+
+static void referenceState(FILE *out, struct gameState *game) {
+    char phaseName[MAX_STRING_LENGTH];
+    phaseNumToName(game->phase, phaseName);
+    fprintf(out, "Player %d:\n%s phase\n%d actions\n%d coins\n%d buys\n\n",
+            game->whoseTurn, phaseName, game->numActions, game->coins, game->numBuys);
+}
+
+static void referenceScores(FILE *out, struct gameState *game) {
+    int playerNum;
+    for (playerNum = 0; playerNum < game->numPlayers; playerNum++) {
+        fprintf(out, "Player %d has a score of %d\n", playerNum, scoreFor(playerNum, game));
+    }
+}
+
+
+//Every human snapshot of the game from the format functions and from the printf versions
+static int humanMatches(struct gameState *game) {
+    static char expected[REFERENCE_SIZE], data[PRINT_BUFFER_SIZE];
+    struct printBuffer buffer;
+    FILE *out = tmpfile();
+    size_t length;
+    int p;
+
+    if (out == NULL) return 0;
+    printBufferInit(&buffer, data, PRINT_BUFFER_SIZE, PRINT_HUMAN);
+    for (p = 0; p < game->numPlayers; p++) {
+        referenceCards(out, p, "hand:\n", "\n", game->hand[p], game->handCount[p]);
+        referenceCards(out, p, "deck: \n", "\n", game->deck[p], game->deckCount[p]);
+        referenceCards(out, p, "discard: \n", " \n", game->discard[p], game->discardCount[p]);
+        formatHand(&buffer, p, game);
+        formatDeck(&buffer, p, game);
+        formatDiscard(&buffer, p, game);
+    }
+    referenceCards(out, game->whoseTurn, "played cards: \n", " \n", game->playedCards, game->playedCardCount);
+    referenceSupply(out, game);
+    referenceState(out, game);
+    referenceScores(out, game);
+    formatPlayed(&buffer, game->whoseTurn, game);
+    formatSupply(&buffer, game);
+    formatState(&buffer, game);
+    formatScores(&buffer, game);
+
+    rewind(out);
+    length = fread(expected, 1, sizeof(expected), out);
+    fclose(out);
+    return buffer.overflow == 0 && length == (size_t)buffer.length
+        && memcmp(expected, buffer.data, length) == 0;
+}
+
+
+//Parse "tag p=N cards=a,b,c" and check it lists count cards
+static int compactCardsMatch(const char *line, const char *tag, int player, const int *cards, int count) {
+    char word[16];
+    int p, card, index, used;
+    if (sscanf(line, "%15s p=%d cards=%n", word, &p, &used) != 2 || strcmp(word, tag) != 0 || p != player)
+        return 0;
+    line += used;
+    for (index = 0; index < count; index++) {
+        if (index > 0 && *line++ != ',') return 0;
+        if (sscanf(line, "%d%n", &card, &used) != 1 || card != cards[index]) return 0;
+        line += used;
+    }
+    return *line == '\n';
+}
+
+
+int main() {
+
+    //playdom's kingdom
+    int k[10] = {adventurer, gardens, embargo, village, minion, mine, cutpurse,
+                 council_room, tribute, smithy};
+    struct gameState G;
+    struct printBuffer buffer;
+    char data[PRINT_BUFFER_SIZE], small[64];	//compact lines leave room for a terminator
+    const char *line;
+    int card, count, used, listed, ok, p, i;
+    int phase, actions, coins, buys, score0, score1;
+    //Test pass count
+    int passCount = 0;
+    int testTotal = 0;
+
+    printf("****FUNCTION UNIT TEST 20: formatHand(), formatSupply(), formatState(), formatScores()****\n");
+
+    initializeGame(2, k, SEED, &G);
+
+    printf("TEST 1: a new game prints as the printf versions did: \n");
+    testTotal++;
+    if (humanMatches(&G))
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    //Mid game: cards in every pile, a played card, buy phase, an emptied supply pile
+    G.playedCards[G.playedCardCount++] = village;
+    G.playedCards[G.playedCardCount++] = smithy;
+    G.discard[0][G.discardCount[0]++] = province;
+    G.discard[0][G.discardCount[0]++] = council_room;
+    G.discard[1][G.discardCount[1]++] = curse;
+    G.hand[0][G.handCount[0]++] = gardens;
+    G.supplyCount[village] = 0;
+    G.supplyCount[province] -= 1;
+    G.phase = BUY_PHASE;
+    G.coins = 11;
+    G.numBuys = 2;
+    G.numActions = 0;
+
+    printf("TEST 2: a game in its buy phase prints as the printf versions did: \n");
+    testTotal++;
+    if (humanMatches(&G))
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 3: compact hand, deck, discard and played lines list the same cards: \n");
+    testTotal++;
+    ok = 1;
+    for (p = 0; p < G.numPlayers; p++) {
+        printBufferInit(&buffer, data, PRINT_BUFFER_SIZE - 1, PRINT_COMPACT);
+        formatHand(&buffer, p, &G);
+        data[buffer.length] = '\0';
+        ok = ok && compactCardsMatch(data, "hand", p, G.hand[p], G.handCount[p]);
+        printBufferInit(&buffer, data, PRINT_BUFFER_SIZE - 1, PRINT_COMPACT);
+        formatDeck(&buffer, p, &G);
+        data[buffer.length] = '\0';
+        ok = ok && compactCardsMatch(data, "deck", p, G.deck[p], G.deckCount[p]);
+        printBufferInit(&buffer, data, PRINT_BUFFER_SIZE - 1, PRINT_COMPACT);
+        formatDiscard(&buffer, p, &G);
+        data[buffer.length] = '\0';
+        ok = ok && compactCardsMatch(data, "discard", p, G.discard[p], G.discardCount[p]);
+    }
+    printBufferInit(&buffer, data, PRINT_BUFFER_SIZE - 1, PRINT_COMPACT);
+    formatPlayed(&buffer, 0, &G);
+    data[buffer.length] = '\0';
+    ok = ok && compactCardsMatch(data, "played", 0, G.playedCards, G.playedCardCount);
+    if (ok)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 4: the compact supply line lists every pile in play with its count: \n");
+    testTotal++;
+    printBufferInit(&buffer, data, PRINT_BUFFER_SIZE - 1, PRINT_COMPACT);
+    formatSupply(&buffer, &G);
+    data[buffer.length] = '\0';
+    ok = strncmp(data, "supply ", 7) == 0;
+    line = data + 7;
+    listed = 0;
+    for (i = 0; ok && i < NUM_TOTAL_K_CARDS; i++) {
+        if (G.supplyCount[i] == -1) continue;
+        if (listed++ > 0 && *line++ != ',') ok = 0;
+        else if (sscanf(line, "%d:%d%n", &card, &count, &used) != 2 || card != i || count != G.supplyCount[i]) ok = 0;
+        else line += used;
+    }
+    if (ok && strcmp(line, "\n") == 0 && listed == 17)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 5: the compact state and scores lines parse back to the game's values: \n");
+    testTotal++;
+    printBufferInit(&buffer, data, PRINT_BUFFER_SIZE - 1, PRINT_COMPACT);
+    formatState(&buffer, &G);
+    formatScores(&buffer, &G);
+    data[buffer.length] = '\0';
+    if (sscanf(data, "state p=%d phase=%d actions=%d coins=%d buys=%d\nscores %d,%d\n%n",
+               &p, &phase, &actions, &coins, &buys, &score0, &score1, &used) == 7
+        && used == buffer.length
+        && p == G.whoseTurn && phase == BUY_PHASE && actions == 0 && coins == 11 && buys == 2
+        && score0 == scoreFor(0, &G) && score1 == scoreFor(1, &G))
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 6: a buffer too small for the supply keeps what fits and counts the rest: \n");
+    testTotal++;
+    memset(small, 'x', sizeof(small));
+    printBufferInit(&buffer, small, 32, PRINT_HUMAN);
+    formatSupply(&buffer, &G);
+    if (buffer.length <= 32 && buffer.overflow > 0 && small[32] == 'x' && small[63] == 'x'
+        && memcmp(small, "#   Card          Cost   Copies\n", buffer.length) == 0)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("****FUNCTION UNIT TEST 20: PASSED %d of %d tests****\n", passCount, testTotal);
+
+    return passCount == testTotal ? 0 : 1;
+}
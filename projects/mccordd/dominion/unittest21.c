@@ -0,0 +1,199 @@
+/**************************************************************************************
+    Name: Doug McCord
+    Project: CS 362 -- command dispatch and batch mode
+    Description:
+    Unit tests for commandLookup(): every command name, the longer words
+    that share a command's first four characters, and every word of up
+    to five letters against a plain COMPARE() scan of the command names,
+    which covers the words that land in a command's hash slot without
+    matching it.  Then player -b on fixed seeds, whose one-line game
+    summaries must come out exactly as recorded, for played out,
+    resigned and unfinished games.  The Makefile builds player before
+    running this.
+
+***************************************************************************************/
+
+
+
+#include "dominion.h"
+#include "interface.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define OUTPUT_SIZE 1024
+
+//The names commandLookup() knows, in enum COMMAND order
+static const char *names[NUM_COMMANDS] = {
+    "add", "buy", "end", "exit", "help", "init", "num", "odds", "play",
+    "resign", "show", "stat", "supply", "whos"
+};
+
+
+//What the old chain of COMPARE() calls made of a word
+static int scanLookup(const char *word) {
+    int i;
+    for (i = 0; i < NUM_COMMANDS; i++) {
+        if (COMPARE(word, names[i]) == 0) return i;
+    }
+    return CMD_UNKNOWN;
+}
+
+
+//Every lowercase word of length letters, starting from word[at]
+static int allWordsMatch(char *word, int at, int length) {
+    char letter;
+    if (at == length) {
+        word[at] = '\0';
+        return commandLookup(word) == scanLookup(word);
+    }
+    for (letter = 'a'; letter <= 'z'; letter++) {
+        word[at] = letter;
+        if (!allWordsMatch(word, at + 1, length)) return 0;
+    }
+    return 1;
+}
+
+
+//Run player -b with args on script, or on bench.script when script is NULL,
+//and compare everything it prints with expected
+static int batchPrints(const char *args, const char *script, const char *expected) {
+    char path[] = "/tmp/unittest21XXXXXX";
+    char command[256], output[OUTPUT_SIZE];
+    size_t length;
+    FILE *file;
+    int fd, status;
+
+    if (script != NULL) {
+        fd = mkstemp(path);
+        if (fd < 0) return 0;
+        status = write(fd, script, strlen(script)) == (ssize_t)strlen(script);
+        close(fd);
+        if (!status) {
+            unlink(path);
+            return 0;
+        }
+    }
+
+    snprintf(command, sizeof(command), "./player -b %s %s", args, script != NULL ? path : "bench.script");
+    fflush(stdout);
+    file = popen(command, "r");
+    length = file != NULL ? fread(output, 1, sizeof(output) - 1, file) : 0;
+    output[length] = '\0';
+    status = file != NULL ? pclose(file) : -1;
+    if (script != NULL) unlink(path);
+    if (strcmp(output, expected) != 0) {
+        printf("player -b %s printed:\n%s", args, output);
+        return 0;
+    }
+    return status == 0;
+}
+
+
+int main() {
+
+    char word[8];
+    int i, ok;
+    //Test pass count
+    int passCount = 0;
+    int testTotal = 0;
+
+    printf("****FUNCTION UNIT TEST 21: commandLookup(), player -b****\n");
+
+    printf("TEST 1: every command name finds its command: \n");
+    testTotal++;
+    ok = 1;
+    for (i = 0; i < NUM_COMMANDS; i++) {
+        ok = ok && commandLookup(names[i]) == i;
+    }
+    if (ok)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 2: only the first four characters count: \n");
+    testTotal++;
+    if (commandLookup("resi") == CMD_RESIGN && commandLookup("supp") == CMD_SUPPLY
+        && commandLookup("exits") == CMD_EXIT && commandLookup("player") == CMD_PLAY
+        && commandLookup("initialize") == CMD_INIT && commandLookup("statistics") == CMD_STAT
+        && commandLookup("ending") == CMD_UNKNOWN && commandLookup("adds") == CMD_UNKNOWN
+        && commandLookup("nums") == CMD_UNKNOWN && commandLookup("sup") == CMD_UNKNOWN)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 3: words that share a command's hash slot but not its name are unknown: \n");
+    testTotal++;
+    if (commandLookup("") == CMD_UNKNOWN && commandLookup("s") == CMD_UNKNOWN
+        && commandLookup("shoe") == CMD_UNKNOWN && commandLookup("stay") == CMD_UNKNOWN
+        && commandLookup("sxxx") == CMD_UNKNOWN && commandLookup("ends") == CMD_UNKNOWN
+        && commandLookup("exi") == CMD_UNKNOWN && commandLookup("EXIT") == CMD_UNKNOWN
+        && commandLookup("Show") == CMD_UNKNOWN && commandLookup("3") == CMD_UNKNOWN)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 4: every lowercase word of one to five letters matches a COMPARE() scan: \n");
+    testTotal++;
+    ok = 1;
+    for (i = 1; ok && i <= 5; i++) {
+        ok = allWordsMatch(word, 0, i);
+    }
+    if (ok)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 5: player -b on bench.script and seeds 1 to 6 prints the recorded summaries: \n");
+    testTotal++;
+    if (batchPrints("1 -n 6", NULL,
+                    "game=1 seed=1 turns=16 result=over scores=1,29 winners=1\n"
+                    "game=2 seed=2 turns=17 result=over scores=27,21 winners=0\n"
+                    "game=3 seed=3 turns=18 result=over scores=40,22 winners=0\n"
+                    "game=4 seed=4 turns=17 result=over scores=32,15 winners=0\n"
+                    "game=5 seed=5 turns=18 result=over scores=27,20 winners=0\n"
+                    "game=6 seed=6 turns=17 result=over scores=25,14 winners=0\n"))
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 6: a later first seed replays the same game under game=1: \n");
+    testTotal++;
+    if (batchPrints("3", NULL,
+                    "game=1 seed=3 turns=18 result=over scores=40,22 winners=0\n"))
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 7: resigned and unfinished games are summarized as such: \n");
+    testTotal++;
+    if (batchPrints("2 -n 2", "init 2 0\nbuy 4\nend\nresign\n",
+                    "game=1 seed=2 turns=0 result=resigned scores=5,3 winners=0\n"
+                    "game=2 seed=3 turns=0 result=resigned scores=4,3 winners=0\n")
+        && batchPrints("2", "init 2 0\nend\nend\nend\n",
+                       "game=1 seed=2 turns=1 result=unfinished scores=6,5 winners=0\n")
+        && batchPrints("2", "", ""))
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("****FUNCTION UNIT TEST 21: PASSED %d of %d tests****\n", passCount, testTotal);
+
+    return passCount == testTotal ? 0 : 1;
+}
@@ -0,0 +1,152 @@
+/**************************************************************************************
+    Name: Doug McCord
+    Project: CS 362 -- state pool
+    Description:
+    Unit tests for the thread-local game state pool behind newGame() and
+    kingdomCards(): slot alignment, reuse after poolFreeGame(), bulk
+    recycling through poolResetAll(), that a pooled state plays a game
+    exactly like a stack-allocated one, and that a thread's slabs go back
+    to the system when it exits.
+
+***************************************************************************************/
+
+
+
+#include "dominion.h"
+#include "dominion_helpers.h"
+#include "statepool.h"
+#include "rngs.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#define EXIT_THREADS 20
+#define EXIT_STATES 256		//four slabs a thread
+
+
+//Resident set size in pages, or -1
+static long residentPages(void) {
+    long size, resident = -1;
+    FILE *f = fopen("/proc/self/statm", "r");
+
+    if (f == NULL) return -1;
+    if (fscanf(f, "%ld %ld", &size, &resident) != 2) resident = -1;
+    fclose(f);
+    return resident;
+}
+
+
+//Fill a pool's worth of states and exit without poolDestroy()
+static void* fillAndExit(void *arg) {
+    int i;
+    struct gameState *g;
+
+    for (i = 0; i < EXIT_STATES; i++) {
+        if ((g = newGame()) == NULL) return NULL;
+        memset(g, 1, sizeof(struct gameState));
+    }
+    return arg;
+}
+
+
+int main() {
+
+    int i;
+    //Test pass count
+    int passCount = 0;
+    int testTotal = 0;
+
+    struct gameState *g[100];
+    struct gameState *reused;
+    struct gameState stackGame;
+    int stackK[10];
+    int *poolK;
+    int aligned = 1;
+    pthread_t thread;
+    void *result = NULL;
+    long before, after;
+
+    printf("****FUNCTION UNIT TEST 5: state pool****\n");
+
+    printf("TEST 1: 100 pooled states are cache line aligned: \n");
+    for (i = 0; i < 100; i++)
+    {
+        g[i] = newGame();
+        if (g[i] == NULL || ((uintptr_t)g[i] % POOL_CACHE_LINE) != 0) aligned = 0;
+    }
+    testTotal++;
+    if (aligned && poolInUse() == 100)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 2: a freed state is handed out again: \n");
+    poolFreeGame(g[42]);
+    reused = newGame();
+    testTotal++;
+    if (reused == g[42] && poolInUse() == 100)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 3: poolResetAll recycles every slot: \n");
+    poolResetAll();
+    testTotal++;
+    if (poolInUse() == 0)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 4: pooled and stack kingdoms initialize identical games: \n");
+    poolK = kingdomCards(adventurer, council_room, feast, gardens, mine,
+                         remodel, smithy, village, baron, great_hall);
+    setKingdomCards(stackK, adventurer, council_room, feast, gardens, mine,
+                    remodel, smithy, village, baron, great_hall);
+    g[0] = newGame();
+    memset(g[0], 0, sizeof(struct gameState));
+    memset(&stackGame, 0, sizeof(struct gameState));
+    initializeGame(2, poolK, 1000, g[0]);
+    initializeGame(2, stackK, 1000, &stackGame);
+    testTotal++;
+    if (memcmp(g[0], &stackGame, sizeof(struct gameState)) == 0)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    poolDestroy();
+
+    printf("TEST 5: a thread's slabs are released when it exits: \n");
+    pthread_create(&thread, NULL, fillAndExit, &i);
+    pthread_join(thread, &result);
+    before = residentPages();
+    for (i = 0; i < EXIT_THREADS && result != NULL; i++) {
+        pthread_create(&thread, NULL, fillAndExit, &i);
+        pthread_join(thread, &result);
+    }
+    after = residentPages();
+    testTotal++;
+    //Kept slabs would add EXIT_THREADS * EXIT_STATES states to the total
+    if (result != NULL && before > 0
+        && (after - before) * sysconf(_SC_PAGESIZE) < (long)EXIT_THREADS * EXIT_STATES * sizeof(struct gameState) / 4)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    //TEST SUMMARY:
+    printf("\n****FUNCTION UNIT TEST 5: PASSED %d of %d tests****\n", passCount, testTotal);
+
+    return passCount == testTotal ? 0 : 1;
+}
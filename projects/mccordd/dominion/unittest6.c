@@ -0,0 +1,142 @@
+/**************************************************************************************
+    Name: Doug McCord
+    Project: CS 362 -- bot strategies
+    Description:
+    Unit tests for strategy.c: the built-in default strategy picks exactly
+    what the old executeBotTurn() ladder did, owned-count caps and turn
+    conditions are honoured, and malformed strategy text is rejected.
+
+***************************************************************************************/
+
+
+
+#include "dominion.h"
+#include "dominion_helpers.h"
+#include "strategy.h"
+#include "rngs.h"
+
+#include <stdio.h>
+#include <string.h>
+
+
+//The hand-written ladder the default strategy replaces
+static int ladder(int coins, struct gameState *G) {
+    if (coins >= 8 && supplyCount(province, G) > 0) return province;
+    if (supplyCount(province, G) == 0 && coins >= 5) return duchy;
+    if (coins >= 6 && supplyCount(gold, G) > 0) return gold;
+    if (coins >= 3 && supplyCount(silver, G) > 0) return silver;
+    return -1;
+}
+
+
+int main() {
+
+    int k[10] = {adventurer, council_room, feast, gardens, mine,
+                 remodel, smithy, village, baron, great_hall};
+    int coins, provinces, golds, silvers, i;
+    int matches = 1;
+    //Test pass count
+    int passCount = 0;
+    int testTotal = 0;
+
+    struct gameState G;
+    struct strategy s;
+
+    printf("****FUNCTION UNIT TEST 6: strategyChoose()****\n");
+
+    memset(&G, 0, sizeof(struct gameState));
+    initializeGame(2, k, 1000, &G);
+
+    printf("TEST 1: default strategy matches the old bot ladder: \n");
+    strategyParse(&s, STRATEGY_DEFAULT);
+    for (provinces = 0; provinces <= 8; provinces += 8)
+        for (golds = 0; golds <= 30; golds += 30)
+            for (silvers = 0; silvers <= 40; silvers += 40)
+                for (coins = 0; coins <= 20; coins++)
+                {
+                    G.supplyCount[province] = provinces;
+                    G.supplyCount[gold] = golds;
+                    G.supplyCount[silver] = silvers;
+                    if (strategyChoose(&s, 0, coins, 0, &G) != ladder(coins, &G)) matches = 0;
+                }
+    testTotal++;
+    if (matches)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 2: owned cap stops buying at two smithies: \n");
+    G.supplyCount[province] = 8;
+    G.supplyCount[gold] = 30;
+    G.supplyCount[silver] = 40;
+    strategyParse(&s, "smithy if owned < 2\nsilver\n");
+    testTotal++;
+    if (strategyChoose(&s, 0, 4, 0, &G) == smithy)
+    {
+        for (i = 0; i < 2; i++) G.deck[0][G.deckCount[0]++] = smithy;
+        if (strategyChoose(&s, 0, 4, 0, &G) == silver)
+        {
+            printf("PASSED\n");
+            passCount++;
+        }
+        else printf("TEST FAILED\n");
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 3: turn and coin conditions, card cost is implied: \n");
+    strategyParse(&s, "name early\nvillage if turn <= 3 and coins == 3\nsilver\ngold if coins>=0\n");
+    testTotal++;
+    if (strategyChoose(&s, 0, 3, 2, &G) == village && strategyChoose(&s, 0, 3, 4, &G) == silver
+        && strategyChoose(&s, 0, 2, 0, &G) == -1 && strategyChoose(&s, 0, 7, 0, &G) == silver
+        && strcmp(s.name, "early") == 0)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 4: malformed strategies are rejected: \n");
+    testTotal++;
+    if (strategyParse(&s, "platinum\n") == -1 && strategyParse(&s, "gold if coins >= 99\n") == -1
+        && strategyParse(&s, "gold if owned != 1\n") == -1 && strategyParse(&s, "gold when coins >= 6\n") == -1
+        && strategyParse(&s, "gold if supply:nothing > 0\n") == -1)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 5: cards played this turn count as owned: \n");
+    strategyParse(&s, "smithy if owned < 2\nsilver\n");
+    G.deckCount[0] = 0;
+    G.deck[0][G.deckCount[0]++] = smithy;
+    G.playedCards[G.playedCardCount++] = smithy;
+    testTotal++;
+    //Only the player whose turn it is has cards in play
+    if (whoseTurn(&G) == 0 && strategyChoose(&s, 0, 4, 0, &G) == silver
+        && strategyChoose(&s, 1, 4, 0, &G) == smithy)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 6: conditions no value satisfies are rejected: \n");
+    testTotal++;
+    if (strategyParse(&s, "silver if owned > 3 and owned < 2\n") == -1
+        && strategyParse(&s, "silver if turn < -2147483648\n") == -1
+        && strategyParse(&s, "smithy if coins <= 3\n") == -1
+        && strategyParse(&s, "silver if owned >= 2 and owned <= 2\n") == 0)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    //TEST SUMMARY:
+    printf("\n****FUNCTION UNIT TEST 6: PASSED %d of %d tests****\n", passCount, testTotal);
+
+    return passCount == testTotal ? 0 : 1;
+}
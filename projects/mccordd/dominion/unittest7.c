@@ -0,0 +1,111 @@
+/**************************************************************************************
+    Name: Doug McCord
+    Project: CS 362 -- draw odds
+    Description:
+    Unit tests for drawodds.c: hypergeometric draws match hand-worked
+    counts, the reshuffle boundary takes the whole deck first, and the
+    next hand of a freshly dealt game is the rest of the starting deck.
+
+***************************************************************************************/
+
+
+
+#include "dominion.h"
+#include "dominion_helpers.h"
+#include "drawodds.h"
+#include "rngs.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+
+static int near(double a, double b) {
+    return fabs(a - b) < 1e-9;
+}
+
+
+int main() {
+
+    int k[10] = {adventurer, council_room, feast, gardens, mine,
+                 remodel, smithy, village, baron, great_hall};
+    int deck[DRAWODDS_KINDS], discard[DRAWODDS_KINDS];
+    int c, handCoins;
+    double total;
+    //Test pass count
+    int passCount = 0;
+    int testTotal = 0;
+
+    struct gameState G;
+    struct coinDistribution D;
+
+    printf("****FUNCTION UNIT TEST 7: drawCoinDistribution()****\n");
+
+    printf("TEST 1: five from seven coppers and three estates: \n");
+    memset(deck, 0, sizeof(deck));
+    memset(discard, 0, sizeof(discard));
+    deck[DRAW_COPPER] = 7;
+    deck[DRAW_OTHER] = 3;
+    testTotal++;
+    total = 0;
+    drawCoinDistribution(deck, discard, 5, &D);
+    for (c = 0; c <= DRAWODDS_MAX_COINS; c++) total += D.p[c];
+    //C(7,5) / C(10,5) and C(7,3) C(3,2) / C(10,5)
+    if (near(D.p[5], 21.0 / 252) && near(D.p[3], 105.0 / 252) && D.p[1] == 0 && near(total, 1)
+        && near(coinsAtLeast(&D, 4), (21.0 + 105) / 252) && D.cards == 5)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 2: short deck is drawn whole before the discard pile: \n");
+    memset(deck, 0, sizeof(deck));
+    memset(discard, 0, sizeof(discard));
+    deck[DRAW_GOLD] = 2;
+    discard[DRAW_SILVER] = 3;
+    discard[DRAW_OTHER] = 3;
+    testTotal++;
+    drawCoinDistribution(deck, discard, 5, &D);
+    //Both golds, then three of six: 0..3 silvers
+    if (near(D.p[12], 1.0 / 20) && near(D.p[10], 9.0 / 20) && near(D.p[8], 9.0 / 20)
+        && near(D.p[6], 1.0 / 20) && near(coinsAtLeast(&D, 6), 1))
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 3: next hand after the deal is the rest of the starting deck: \n");
+    memset(&G, 0, sizeof(struct gameState));
+    initializeGame(2, k, 7, &G);
+    handCoins = 0;
+    for (c = 0; c < numHandCards(&G); c++) handCoins += handCard(c, &G) == copper;
+    testTotal++;
+    if (nextHandCoins(0, &G, &D) == 0 && near(D.p[7 - handCoins], 1) && D.cards == 5)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 4: short piles and bad arguments: \n");
+    memset(deck, 0, sizeof(deck));
+    memset(discard, 0, sizeof(discard));
+    deck[DRAW_COPPER] = 1;
+    discard[DRAW_SILVER] = 1;
+    testTotal++;
+    if (drawCoinDistribution(deck, discard, 5, &D) == 0 && D.cards == 2 && near(D.p[3], 1)
+        && drawCoinDistribution(deck, discard, DRAWODDS_MAX_DRAW + 1, &D) == -1
+        && nextHandCoins(MAX_PLAYERS, &G, &D) == -1)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    //TEST SUMMARY:
+    printf("\n****FUNCTION UNIT TEST 7: PASSED %d of %d tests****\n", passCount, testTotal);
+
+    return passCount == testTotal ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+/**************************************************************************************
+    Name: Doug McCord
+    Project: CS 362 -- endgame solver
+    Description:
+    Unit tests for endgame.c: the last province is bought when it wins
+    and left alone when it loses, endgameNear() triggers on low provinces
+    or empty piles, and the search stops inside its time budget.
+
+***************************************************************************************/
+
+
+
+#include "dominion.h"
+#include "dominion_helpers.h"
+#include "endgame.h"
+#include "rngs.h"
+
+#include <stdio.h>
+#include <string.h>
+
+
+//Every card of player into the discard pile: scoreFor() reads the deck
+//array up to discardCount, so the emptied deck is left all copper
+static void discardAll(struct gameState *G, int player) {
+    int i;
+    for (i = 0; i < G->handCount[player]; i++)
+        G->discard[player][G->discardCount[player]++] = G->hand[player][i];
+    for (i = 0; i < G->deckCount[player]; i++)
+        G->discard[player][G->discardCount[player]++] = G->deck[player][i];
+    for (i = 0; i < MAX_DECK; i++) G->deck[player][i] = copper;
+    G->handCount[player] = 0;
+    G->deckCount[player] = 0;
+}
+
+
+int main() {
+
+    int k[10] = {adventurer, council_room, feast, gardens, mine,
+                 remodel, smithy, village, baron, great_hall};
+    //Test pass count
+    int passCount = 0;
+    int testTotal = 0;
+
+    struct gameState G;
+    struct endgameChoice C;
+
+    printf("****FUNCTION UNIT TEST 8: endgameSolve()****\n");
+
+    printf("TEST 1: the last province is bought when it wins: \n");
+    memset(&G, 0, sizeof(struct gameState));
+    initializeGame(2, k, 3, &G);
+    discardAll(&G, 0);
+    discardAll(&G, 1);
+    G.supplyCount[province] = 1;
+    testTotal++;
+    if (scoreFor(0, &G) == scoreFor(1, &G) && endgameSolve(0, &G, 8, 1.0, 0, &C) == 0
+        && C.card == province && C.value == 1.0 && C.exact)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 2: the last province is left when it loses: \n");
+    //Player 1 leads by seven, so ending the game on six points loses
+    G.discard[1][G.discardCount[1]++] = province;
+    G.discard[1][G.discardCount[1]++] = estate;
+    G.discard[0][G.discardCount[0]++] = gold;
+    G.discard[0][G.discardCount[0]++] = gold;
+    testTotal++;
+    if (scoreFor(1, &G) - scoreFor(0, &G) == 7 && endgameSolve(0, &G, 8, 0.2, 0, &C) == 0
+        && C.card != province && C.value > 0 && C.depth >= 1)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 3: endgameNear() on low provinces or two empty piles: \n");
+    memset(&G, 0, sizeof(struct gameState));
+    initializeGame(2, k, 3, &G);
+    testTotal++;
+    if (!endgameNear(&G))
+    {
+        G.supplyCount[province] = ENDGAME_PROVINCES;
+        if (endgameNear(&G))
+        {
+            G.supplyCount[province] = 8;
+            G.supplyCount[smithy] = 0;
+            G.supplyCount[village] = 0;
+            if (endgameNear(&G))
+            {
+                printf("PASSED\n");
+                passCount++;
+            }
+            else printf("TEST FAILED\n");
+        }
+        else printf("TEST FAILED\n");
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 4: a deep position stops near its budget: \n");
+    memset(&G, 0, sizeof(struct gameState));
+    initializeGame(3, k, 3, &G);
+    G.supplyCount[province] = 3;
+    testTotal++;
+    if (endgameSolve(1, &G, 8, 0.05, 0, &C) == 0 && C.seconds < 0.5 && C.depth >= 1 && C.card != ENDGAME_NONE)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 5: a node-limited search stops at its limit and repeats exactly: \n");
+    {
+        struct endgameChoice again;
+        testTotal++;
+        if (endgameSolve(1, &G, 8, 0, 2000, &C) == 0 && endgameSolve(1, &G, 8, 0, 2000, &again) == 0
+            && C.nodes <= 2001 && C.depth >= 1 && !C.exact && C.card == again.card
+            && C.value == again.value && C.depth == again.depth && C.nodes == again.nodes)
+        {
+            printf("PASSED\n");
+            passCount++;
+        }
+        else printf("TEST FAILED\n");
+    }
+
+    //TEST SUMMARY:
+    printf("\n****FUNCTION UNIT TEST 8: PASSED %d of %d tests****\n", passCount, testTotal);
+
+    return passCount == testTotal ? 0 : 1;
+}
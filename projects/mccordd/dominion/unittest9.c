@@ -0,0 +1,101 @@
+/**************************************************************************************
+    Name: Doug McCord
+    Project: CS 362 -- rngs jump-ahead
+    Description:
+    Unit tests for the rngs.c seek functions: SkipAhead() agrees with
+    calling Random() and with PlantSeeds()' stream spacing, Seek() and
+    FindPosition() invert one another anywhere in the period, and
+    PutSubstream() starts where a skip would.
+
+***************************************************************************************/
+
+
+
+#include "rngs.h"
+
+#include <stdio.h>
+#include <string.h>
+
+
+int main() {
+
+    long x, y, i;
+    //Test pass count
+    int passCount = 0;
+    int testTotal = 0;
+
+    printf("****FUNCTION UNIT TEST 9: SkipAhead(), Seek(), FindPosition()****\n");
+
+    printf("TEST 1: SkipAhead() matches calling Random(): \n");
+    SelectStream(0);
+    PutSeed(1);
+    SkipAhead(10000);
+    GetSeed(&x);
+    PutSeed(777);
+    for (i = 0; i < 5000; i++) Random();
+    GetSeed(&y);
+    PutSeed(777);
+    SkipAhead(5000);
+    testTotal++;
+    //399268537 is rngs.c's own check value for 10000 calls from 1
+    if (x == 399268537 && (GetSeed(&x), x == y))
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 2: PlantSeeds() streams are 8,367,782 calls apart: \n");
+    SelectStream(1);
+    PlantSeeds(4242);
+    GetSeed(&y);
+    SelectStream(0);
+    SkipAhead(8367782);
+    GetSeed(&x);
+    testTotal++;
+    if (x == y)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 3: Seek() and FindPosition() invert one another: \n");
+    PutSeed(12345);
+    for (i = 0; i < 1000; i++) Random();
+    testTotal++;
+    if (GetPosition() == 1000)
+    {
+        Seek(2000000000L);
+        GetSeed(&x);
+        SkipAhead(-1);
+        Random();
+        GetSeed(&y);
+        if (FindPosition(x) == 2000000000L && x == y && FindPosition(0) == -1)
+        {
+            printf("PASSED\n");
+            passCount++;
+        }
+        else printf("TEST FAILED\n");
+    }
+    else printf("TEST FAILED\n");
+
+    printf("TEST 4: PutSubstream() starts a quarter period in: \n");
+    PutSeed(99);
+    SkipAhead(2147483646L / 4);
+    GetSeed(&x);
+    PutSubstream(99, 1, 4);
+    GetSeed(&y);
+    testTotal++;
+    if (x == y && GetPosition() == 0)
+    {
+        printf("PASSED\n");
+        passCount++;
+    }
+    else printf("TEST FAILED\n");
+
+    //TEST SUMMARY:
+    printf("\n****FUNCTION UNIT TEST 9: PASSED %d of %d tests****\n", passCount, testTotal);
+
+    return passCount == testTotal ? 0 : 1;
+}
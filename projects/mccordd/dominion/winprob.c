@@ -0,0 +1,190 @@
+/* 	Win Probability Estimates
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "rngs.h"
+#include "simulate.h"
+#include "winprob.h"
+
+struct rolloutJob {
+  int player;
+  struct gameState *state;
+  const struct strategy **strategies;
+  int turn;
+  int seed;
+  int maxRollouts;
+  double deadline;
+  int claimed;		//rollouts handed out so far
+};
+
+struct rolloutWorker {
+  struct rolloutJob *job;
+  pthread_t thread;
+  double points;
+  int rollouts;
+  int capped;
+};
+
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+//xorshift, only for dealing the hidden cards; the game itself uses rngs.c
+static unsigned int nextRandom(unsigned int *x) {
+  *x ^= *x << 13;
+  *x ^= *x >> 17;
+  *x ^= *x << 5;
+  return *x;
+}
+
+
+static void shuffleCards(int *cards, int count, unsigned int *x) {
+  int i, j, t;
+  for (i = count - 1; i > 0; i--) {
+    j = nextRandom(x) % (i + 1);
+    t = cards[i];
+    cards[i] = cards[j];
+    cards[j] = t;
+  }
+}
+
+
+//Re-deal everything player has not seen: own deck order, opponents' hands and decks
+static void randomizeHidden(int player, struct gameState *state, unsigned int *x) {
+  int pool[MAX_HAND + MAX_DECK];
+  int p, n, h;
+
+  shuffleCards(state->deck[player], state->deckCount[player], x);
+  for (p = 0; p < state->numPlayers; p++) {
+    if (p == player) {
+      continue;
+    }
+    h = state->handCount[p];
+    n = state->deckCount[p];
+    if (h + n > MAX_DECK) {
+      shuffleCards(state->deck[p], n, x);
+      continue;
+    }
+    memcpy(pool, state->hand[p], sizeof(int) * h);
+    memcpy(pool + h, state->deck[p], sizeof(int) * n);
+    shuffleCards(pool, h + n, x);
+    memcpy(state->hand[p], pool, sizeof(int) * h);
+    memcpy(state->deck[p], pool + h, sizeof(int) * n);
+  }
+}
+
+
+static void *rolloutThread(void *arg) {
+  struct rolloutWorker *w = arg;
+  struct rolloutJob *job = w->job;
+  struct gameState copy;
+  struct gameResult result;
+  unsigned int x;
+  int n, p, best, tied;
+
+  SelectStream(1);
+  while ((n = __sync_fetch_and_add(&job->claimed, 1)) < job->maxRollouts) {
+    if (n >= WINPROB_MIN_ROLLOUTS && now() >= job->deadline) {
+      break;
+    }
+    memcpy(&copy, job->state, sizeof(struct gameState));
+    x = 2463534242u ^ (unsigned int)(job->seed * 2654435761u + n * 40503u);
+    if (x == 0) {
+      x = 1;
+    }
+    randomizeHidden(job->player, &copy, &x);
+    PutSeed(1 + (long)((job->seed * 1000003LL + n) % 2000000000));
+    simulateFrom(job->strategies, &copy, job->turn, job->turn + SIMULATE_MAX_TURNS, &result);
+    if (!result.finished) {
+      w->capped++;
+      continue;
+    }
+
+    //A share of the win for each seat tied on the top score
+    best = result.scores[0];
+    for (p = 1; p < copy.numPlayers; p++) {
+      if (result.scores[p] > best) {
+	best = result.scores[p];
+      }
+    }
+    tied = 0;
+    for (p = 0; p < copy.numPlayers; p++) {
+      tied += result.scores[p] == best;
+    }
+    if (result.scores[job->player] == best) {
+      w->points += 1.0 / tied;
+    }
+    w->rollouts++;
+  }
+  return NULL;
+}
+
+
+int winProbability(int player, struct gameState *state, const struct strategy *strategies[],
+		   int turn, double budgetSeconds, int maxRollouts, int threads, int seed,
+		   struct winEstimate *estimate) {
+  struct rolloutWorker workers[WINPROB_MAX_THREADS];
+  struct rolloutJob job;
+  double start = now();
+  double points = 0, n, z = 1.96, center, half;
+  int i, started;
+
+  if (threads <= 0) {
+    threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  }
+  if (threads > WINPROB_MAX_THREADS) {
+    threads = WINPROB_MAX_THREADS;
+  }
+  if (threads < 1) {
+    threads = 1;
+  }
+
+  job.player = player;
+  job.state = state;
+  job.strategies = strategies;
+  job.turn = turn;
+  job.seed = seed;
+  job.maxRollouts = maxRollouts;
+  job.deadline = start + budgetSeconds;
+  job.claimed = 0;
+
+  for (started = 0; started < threads; started++) {
+    workers[started].job = &job;
+    workers[started].points = 0;
+    workers[started].rollouts = 0;
+    workers[started].capped = 0;
+    if (pthread_create(&workers[started].thread, NULL, rolloutThread, &workers[started]) != 0) {
+      break;
+    }
+  }
+  memset(estimate, 0, sizeof(struct winEstimate));
+  for (i = 0; i < started; i++) {
+    pthread_join(workers[i].thread, NULL);
+    points += workers[i].points;
+    estimate->rollouts += workers[i].rollouts;
+    estimate->capped += workers[i].capped;
+  }
+  estimate->seconds = now() - start;
+  if (started == 0) {
+    return -1;
+  }
+
+  n = estimate->rollouts;
+  if (n > 0) {
+    estimate->p = points / n;
+    center = (estimate->p + z * z / (2 * n)) / (1 + z * z / n);
+    half = z * sqrt(estimate->p * (1 - estimate->p) / n + z * z / (4 * n * n)) / (1 + z * z / n);
+    estimate->low = center - half;
+    estimate->high = center + half;
+  }
+  return 0;
+}
@@ -0,0 +1,39 @@
+/* 	Win Probability Estimates
+
+	Monte Carlo odds for one player from a live gameState.  Each rollout
+	copies the state, reshuffles what that player cannot see (the order
+	of their own deck; the opponents' hands and decks together), and plays
+	the game out with simulateFrom().  Rollouts run on worker threads with
+	their own rngs.c streams, so the caller's game and random stream are
+	left exactly as they were.  A rollout that reaches SIMULATE_MAX_TURNS
+	without ending has no winner, so it is counted apart and left out of
+	the estimate.
+*/
+
+#ifndef _WINPROB_H
+#define _WINPROB_H
+
+#include "dominion.h"
+#include "strategy.h"
+
+#define WINPROB_MAX_THREADS 64
+#define WINPROB_MIN_ROLLOUTS 32		//played even when the budget is already gone
+
+struct winEstimate {
+  double p;		//win probability, a tie counting half
+  double low, high;	//95% Wilson interval
+  int rollouts;		//played to the end and counted in p
+  int capped;		//cut off at the turn cap, not counted
+  double seconds;	//wall time spent
+};
+
+int winProbability(int player, struct gameState *state, const struct strategy *strategies[],
+		   int turn, double budgetSeconds, int maxRollouts, int threads, int seed,
+		   struct winEstimate *estimate);
+/* Estimate player's chance of winning state, every seat playing on with
+   strategies[seat] from round turn.  Stops at maxRollouts or once
+   budgetSeconds of wall time have passed, whichever is first; threads
+   <= 0 means one per processor.  seed makes a run repeatable.  Returns
+   -1 if the worker threads could not be started */
+
+#endif
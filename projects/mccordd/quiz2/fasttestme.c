@@ -0,0 +1,207 @@
+/**************************************************************************************
+	Name: Doug McCord
+	Project: CS 362 Quiz 2 -- fast random tester
+	Description: testme.c's own testme() run many times on many threads.
+
+	  testme.c prints every iteration and exits on the first "error", so
+	  one run says little about how good its inputs are.  The Makefile
+	  compiles testme.c a second time with -Dmain=testmeMain, so this
+	  file's main() drives it, and renames that object's printf, puts and
+	  exit to testmePrintf(), testmePuts() and testmeExit() here with
+	  objcopy.  Each trial calls testme() on its own random stream (so a
+	  seed repeats exactly on any number of threads); the printf each
+	  iteration becomes a check against the iteration cap, and exit()
+	  jumps back out with the number of iterations the error took.
+
+	  The guided inputs weight testme()'s nine characters and the letters
+	  of "reset" heavily, with everything printable still possible.
+	  -baseline uses testme.c's originalInputs(), the per-position ranges
+	  it was submitted with, for comparison.
+
+	  Usage: fasttestme [-j threads] [-n trials] [-s seed] [-max iterations] [-baseline]
+
+***************************************************************************************/
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <setjmp.h>
+#include <pthread.h>
+#include "inputgen.h"
+
+#define MAX_THREADS 64
+
+//From testme.c
+extern struct genField inputCharField, inputStringField;
+extern int inputPositions;
+extern __thread struct genRng inputRng;
+void originalInputs();
+void testme();
+
+struct trial {
+    int iterations;		//to the error, or the cap
+    int found;			//the error was reached
+};
+
+static int maxIterations = 1000000000;
+static __thread jmp_buf trialEnd;
+static __thread struct trial *current;
+static struct trial *trials;
+static int trialCount;
+static int nextTrial;
+static unsigned long long seed;
+
+
+//testme()'s printf: each "Iteration %d: ..." line brings the count
+int testmePrintf(const char *format, ...)
+{
+    va_list args;
+    int n;
+
+    if (strncmp(format, "Iteration ", 10) != 0) return 0;
+    va_start(args, format);
+    n = va_arg(args, int);
+    va_end(args);
+    if (n > maxIterations)
+    {
+        current->found = 0;
+        longjmp(trialEnd, 1);
+    }
+    current->iterations = n;
+    return 0;
+}
+
+
+//In case the compiler turns a printf into puts
+int testmePuts(const char *s)
+{
+    return 0;
+}
+
+
+//testme()'s exit(), reached only on the error
+void testmeExit(int code)
+{
+    current->found = 1;
+    longjmp(trialEnd, 1);
+}
+
+
+static void *runTrials(void *arg)
+{
+    int i;
+
+    while ((i = __sync_fetch_and_add(&nextTrial, 1)) < trialCount)
+    {
+        genSeed(&inputRng, seed, i);
+        current = &trials[i];
+        if (setjmp(trialEnd) == 0) testme();
+    }
+    return NULL;
+}
+
+
+static int compareLong(const void *a, const void *b)
+{
+    long long x = *(const long long*)a, y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+
+//Mean, median and 90th percentile of the trials that reached the error
+static void report(void)
+{
+    long long *v = malloc(sizeof(long long) * trialCount);
+    double total = 0;
+    int i, count = 0;
+
+    for (i = 0; i < trialCount; i++)
+    {
+        if (trials[i].found) v[count++] = trials[i].iterations;
+    }
+    printf("%-8s %12s %12s %12s %12s %7s\n", "reached", "mean", "median", "p90", "max", "trials");
+    if (count == 0)
+    {
+        printf("%-8s never reached; %d trial(s) stopped at the cap\n", "error", trialCount);
+        free(v);
+        return;
+    }
+    qsort(v, count, sizeof(long long), compareLong);
+    for (i = 0; i < count; i++) total += v[i];
+    printf("%-8s %12.0f %12lld %12lld %12lld %7d\n", "error", total / count, v[count / 2],
+           v[(int)(count * 0.9)], v[count - 1], count);
+    if (count < trialCount) printf("%d trial(s) stopped at the cap\n", trialCount - count);
+    free(v);
+}
+
+
+static void guidedFields(void)
+{
+    int length;
+
+    genFieldInit(&inputCharField);
+    genAddChars(&inputCharField, "[({ ax})]", 100);
+    genAddRange(&inputCharField, ' ', '~', 1);
+    genFieldReady(&inputCharField);
+
+    genFieldInit(&inputStringField);
+    genAddChars(&inputStringField, "rest", 100);
+    genAddRange(&inputStringField, 'a', 'z', 1);
+    genAddLength(&inputStringField, 5, 100);
+    for (length = 1; length <= 15; length++) genAddLength(&inputStringField, length, 1);
+    genFieldReady(&inputStringField);
+    inputPositions = 0;
+}
+
+
+int main(int argc, char *argv[])
+{
+    pthread_t workers[MAX_THREADS];
+    struct timespec start, end;
+    long long total = 0;
+    double seconds;
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int baseline = 0, a, i;
+
+    trialCount = 1000;
+    seed = (unsigned long long)time(NULL);
+    for (a = 1; a < argc; a++)
+    {
+        if (strcmp(argv[a], "-baseline") == 0) baseline = 1;
+        else if (a + 1 < argc && strcmp(argv[a], "-j") == 0) threads = atoi(argv[++a]);
+        else if (a + 1 < argc && strcmp(argv[a], "-n") == 0) trialCount = atoi(argv[++a]);
+        else if (a + 1 < argc && strcmp(argv[a], "-s") == 0) seed = strtoull(argv[++a], NULL, 10);
+        else if (a + 1 < argc && strcmp(argv[a], "-max") == 0) maxIterations = atoi(argv[++a]);
+        else break;
+    }
+    if (a != argc || trialCount < 1 || maxIterations < 1)
+    {
+        printf("Usage: fasttestme [-j threads] [-n trials] [-s seed] [-max iterations] [-baseline]\n");
+        return 0;
+    }
+    if (threads < 1) threads = 1;
+    if (threads > MAX_THREADS) threads = MAX_THREADS;
+
+    if (baseline) originalInputs();
+    else guidedFields();
+    trials = calloc(trialCount, sizeof(struct trial));
+    if (trials == NULL) return 1;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < threads; i++)
+        pthread_create(&workers[i], NULL, runTrials, NULL);
+    for (i = 0; i < threads; i++) pthread_join(workers[i], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    for (i = 0; i < trialCount; i++) total += trials[i].iterations;
+    printf("%s inputs, seed %llu, %d thread(s): %d trials, %lld iterations in %.2fs (%.1fM/s)\n",
+           baseline ? "baseline" : "guided", seed, threads, trialCount, total, seconds,
+           total / seconds / 1e6);
+    report();
+    free(trials);
+    return 0;
+}
@@ -0,0 +1,161 @@
+/**************************************************************************************
+	Name: Doug McCord
+	Project: CS 362 Quiz 2 -- random input generator
+	Description: see inputgen.h
+
+***************************************************************************************/
+
+#include <string.h>
+#include "inputgen.h"
+
+
+void genFieldInit(struct genField *f)
+{
+    memset(f, 0, sizeof(struct genField));
+}
+
+
+int genAddChars(struct genField *f, const char *chars, unsigned int weight)
+{
+    int i, j;
+    for (i = 0; chars[i] != '\0'; i++)
+    {
+        for (j = 0; j < f->chars.count && f->symbol[j] != chars[i]; j++)
+            ;
+        if (j == f->chars.count)
+        {
+            if (j == GEN_MAX_SYMBOLS) return -1;
+            f->symbol[j] = chars[i];
+            f->chars.count++;
+        }
+        f->chars.weight[j] += weight;
+    }
+    return 0;
+}
+
+
+int genAddRange(struct genField *f, int low, int high, unsigned int weight)
+{
+    char one[2] = {0, 0};
+    int c;
+    if (low < 1 || high > 255) return -1;
+    for (c = low; c <= high; c++)
+    {
+        one[0] = (char)c;
+        if (genAddChars(f, one, weight) == -1) return -1;
+    }
+    return 0;
+}
+
+
+int genAddLength(struct genField *f, int length, unsigned int weight)
+{
+    if (length < 0 || length > GEN_MAX_LENGTH) return -1;
+    f->lengths.count = GEN_MAX_LENGTH + 1;
+    f->lengths.weight[length] += weight;
+    return 0;
+}
+
+
+//Vose's alias method: outcomes under the mean weight are topped up by ones over it
+static int buildTable(struct genTable *t)
+{
+    double scaled[GEN_MAX_SYMBOLS], total = 0;
+    int small[GEN_MAX_SYMBOLS], large[GEN_MAX_SYMBOLS];
+    int smallCount = 0, largeCount = 0, i, s, l;
+
+    for (i = 0; i < t->count; i++) total += t->weight[i];
+    if (total == 0) return -1;
+
+    for (i = 0; i < t->count; i++)
+    {
+        scaled[i] = t->weight[i] * t->count / total;
+        if (scaled[i] < 1.0) small[smallCount++] = i;
+        else large[largeCount++] = i;
+    }
+    while (smallCount > 0 && largeCount > 0)
+    {
+        s = small[--smallCount];
+        l = large[largeCount - 1];
+        t->threshold[s] = (unsigned int)(scaled[s] * 4294967296.0);
+        t->alias[s] = (unsigned char)l;
+        scaled[l] -= 1.0 - scaled[s];
+        if (scaled[l] < 1.0)
+        {
+            largeCount--;
+            small[smallCount++] = l;
+        }
+    }
+    //What is left is a full column, give or take rounding
+    while (largeCount > 0)
+    {
+        l = large[--largeCount];
+        t->threshold[l] = 0xFFFFFFFFu;
+        t->alias[l] = (unsigned char)l;
+    }
+    while (smallCount > 0)
+    {
+        s = small[--smallCount];
+        t->threshold[s] = 0xFFFFFFFFu;
+        t->alias[s] = (unsigned char)s;
+    }
+    return 0;
+}
+
+
+int genFieldReady(struct genField *f)
+{
+    if (f->lengths.count == 0) genAddLength(f, 1, 1);
+    if (buildTable(&f->lengths) == -1) return -1;
+    return buildTable(&f->chars);
+}
+
+
+//splitmix64: spreads (seed, stream) so neighbouring streams are unrelated
+static unsigned long long mix(unsigned long long z)
+{
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+
+void genSeed(struct genRng *rng, unsigned long long seed, int stream)
+{
+    rng->state = mix(seed * 0x9E3779B97F4A7C15ULL + mix((unsigned long long)stream + 1));
+    if (rng->state == 0) rng->state = 1;
+}
+
+
+//xorshift64*
+static unsigned long long next(struct genRng *rng)
+{
+    rng->state ^= rng->state >> 12;
+    rng->state ^= rng->state << 25;
+    rng->state ^= rng->state >> 27;
+    return rng->state * 0x2545F4914F6CDD1DULL;
+}
+
+
+//High half picks the column, low half the side of its threshold
+static int draw(const struct genTable *t, struct genRng *rng)
+{
+    unsigned long long r = next(rng);
+    int column = (int)(((r >> 32) * (unsigned long long)t->count) >> 32);
+    return (unsigned int)r < t->threshold[column] ? column : t->alias[column];
+}
+
+
+char genChar(const struct genField *f, struct genRng *rng)
+{
+    return f->symbol[draw(&f->chars, rng)];
+}
+
+
+int genString(const struct genField *f, struct genRng *rng, char *out)
+{
+    int length = draw(&f->lengths, rng), i;
+    for (i = 0; i < length; i++) out[i] = f->symbol[draw(&f->chars, rng)];
+    out[length] = '\0';
+    return length;
+}
@@ -0,0 +1,66 @@
+/**************************************************************************************
+	Name: Doug McCord
+	Project: CS 362 Quiz 2 -- random input generator
+	Description: Weighted random inputs for testers like testme().
+
+	  A field is one input: a character, or a string with a length.  Each
+	  field has a weighted alphabet and, for strings, a weighted length
+	  distribution, so a tester says "mostly these characters, sometimes
+	  anything printable" instead of hand-writing per-position ranges.
+	  Drawing a character or a length is one random number and one table
+	  lookup (the alias method), whatever the weights.
+
+	  Each thread draws from its own genRng, seeded by (seed, stream):
+	  different streams give independent sequences, and the same seed
+	  and stream always give the same one.
+
+***************************************************************************************/
+
+#ifndef _INPUTGEN_H
+#define _INPUTGEN_H
+
+#define GEN_MAX_SYMBOLS 256
+#define GEN_MAX_LENGTH 64		//longest string; genString() needs one more byte
+
+//Alias table over count outcomes: outcome i, or alias[i] past threshold[i]
+struct genTable {
+  int count;
+  unsigned int weight[GEN_MAX_SYMBOLS];		//as added, before genFieldReady()
+  unsigned int threshold[GEN_MAX_SYMBOLS];	//out of 2^32
+  unsigned char alias[GEN_MAX_SYMBOLS];
+};
+
+struct genField {
+  struct genTable chars;
+  char symbol[GEN_MAX_SYMBOLS];		//character of each chars outcome
+  struct genTable lengths;		//outcome i is length i
+};
+
+struct genRng {
+  unsigned long long state;
+};
+
+void genFieldInit(struct genField *f);
+/* An empty field: no characters, no lengths */
+
+int genAddChars(struct genField *f, const char *chars, unsigned int weight);
+int genAddRange(struct genField *f, int low, int high, unsigned int weight);
+/* Give each character in chars (or low..high) weight more; a character
+   added twice has the weights summed.  Returns -1 on a zero character
+   or a full alphabet */
+
+int genAddLength(struct genField *f, int length, unsigned int weight);
+/* Give strings of length (0..GEN_MAX_LENGTH) weight more; -1 if out of range */
+
+int genFieldReady(struct genField *f);
+/* Build the tables; call once after the last genAdd.  A field with no
+   lengths makes strings of length 1.  Returns -1 if it has no characters */
+
+void genSeed(struct genRng *rng, unsigned long long seed, int stream);
+
+char genChar(const struct genField *f, struct genRng *rng);
+
+int genString(const struct genField *f, struct genRng *rng, char *out);
+/* Fill out with a terminated string and return its length */
+
+#endif
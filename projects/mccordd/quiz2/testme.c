@@ -12,8 +12,11 @@
 	  developed your solution and how it works!"
 
 	
-	NOTE: Per Piazza, only the inputChar() and inputString() functions are modified
-		from the provided code. 
+	NOTE: Per Piazza, testme() is unchanged from the provided code. 
+		inputChar() and inputString() now draw from inputgen.c, through 
+		the input globals and originalInputs() below, and main() seeds 
+		them.  fasttestme.c runs this same testme() on many threads: the 
+		Makefile renames printf and exit in a copy of this file's object. 
 	SOURCES: see randomstring.c for all sources
 
 ***************************************************************************************/
@@ -24,48 +27,62 @@
 #include <string.h>
 #include <stdlib.h>
 #include <time.h>
+#include "inputgen.h"
+
+#define INPUT_POSITIONS 5
+
+/* DKM: what inputChar() and inputString() draw from.  With inputPositions
+   set, a string is that many characters, character i from inputPosition[i];
+   otherwise its length and characters come from inputStringField.  Each
+   thread has its own inputRng. */
+struct genField inputCharField, inputStringField, inputPosition[INPUT_POSITIONS];
+int inputPositions;
+__thread struct genRng inputRng;
+
+//The ranges first submitted: any character 1..127, and five letters each
+//from four around the letter of "reset" at that position
+void originalInputs()
+{
+    const char *low = "qcrds";
+    int i;
+
+    genFieldInit(&inputCharField);
+    genAddRange(&inputCharField, 1, 127, 1);
+    genFieldReady(&inputCharField);
+    for (i = 0; i < INPUT_POSITIONS; i++)
+    {
+    	genFieldInit(&inputPosition[i]);
+    	genAddRange(&inputPosition[i], low[i], low[i] + 3, 1);
+    	genFieldReady(&inputPosition[i]);
+    }
+    inputPositions = INPUT_POSITIONS;
+}
 
 char inputChar()
 {
-    // TODO: rewrite this function
     // DKM: quiz states this should produce random values
-    char genChar;
-    genChar  = (char)(rand() % 127 + 1);
-    return genChar;
+    return genChar(&inputCharField, &inputRng);
 }
 
 char *inputString()
 {
-    // TODO: rewrite this function
     //	DKM: quiz states this should produce random values
-    // 		The length of our random strings will be randomly determined, between 1
-    //		and 15 characters. See randomstring.c for rationale. 
+    // 		See randomstring.c for how the per-position ranges were chosen. 
+    //		The string lives until this thread's next call. 
+    static __thread char genStr[GEN_MAX_LENGTH + 1];
     int i;
-    int wordLen;
-    //wordLen = (random() % 15 + 1);
-    wordLen = 5;
-
-    char genStr [wordLen];
-    memset(genStr, '\0', wordLen);
-
-    //Now loop this and fill with random chars from our inputChar function:
-    for (i = 0; i < wordLen; i++)
-    {	
-    	//See randomstring.c for explanation of these attempted approaches:
-    	//genStr[i] = inputChar();
-    	//genStr[i] = '!' + (rand() % 94);
-    	//genStr[i] = 'e' + (rand() % 16); 
-
-    	if(i == 0) genStr[0] = 'q'+ (rand() % 4); 		// for char 'r'
-    	else if(i == 1) genStr[1] = 'c'+ (rand() % 4);	//for char 'e'
-    	else if(i == 2) genStr[2] = 'r'+ (rand() % 4);	//for char 's'
-    	else if(i == 3) genStr[3] = 'd'+ (rand() % 4);	//for char 'e'
-    	else if(i == 4) genStr[4] = 's'+ (rand() % 4);	//for char 't'
-    }
-    char *returnStr = genStr;
-    //char *returnStr = "reset";
 
-    return returnStr;
+    if (inputPositions == 0)
+    {
+    	genString(&inputStringField, &inputRng, genStr);
+    	return genStr;
+    }
+    for (i = 0; i < inputPositions; i++)
+    {
+    	genStr[i] = genChar(&inputPosition[i], &inputRng);
+    }
+    genStr[i] = '\0';
+    return genStr;
 }
 
 void testme()
@@ -104,7 +121,8 @@ void testme()
 
 int main(int argc, char *argv[])
 {
-    srand(time(NULL));
+    genSeed(&inputRng, (unsigned long long)time(NULL), 0);
+    originalInputs();
     testme();
     return 0;
 }